@@ -103,7 +103,8 @@ void create_rxa (int channel)
 		1.0,											// gain
 		1,												// auto-increase notch width
 		1025,											// max number of passbands
-		&rxa[channel].ndb.p);							// addr of database pointer
+		&rxa[channel].ndb.p,							// addr of database pointer
+		ch[channel].precision);							// kernel precision
 
 	// bandpass for snba
 	rxa[channel].bpsnba.p = create_bpsnba (
@@ -124,7 +125,8 @@ void create_rxa (int channel)
 		1.0,											// gain
 		1,												// auto-increase notch width
 		1025,											// max number of passbands
-		&rxa[channel].ndb.p);							// addr of database pointer
+		&rxa[channel].ndb.p,							// addr of database pointer
+		ch[channel].precision);							// kernel precision
 
 	// send spectrum display
 	rxa[channel].sender.p = create_sender (
@@ -209,7 +211,8 @@ void create_rxa (int channel)
 		max(2048, ch[channel].dsp_size),				// # coefs for de-emphasis filter
 		0,												// min phase flag for de-emphasis filter
 		max(2048, ch[channel].dsp_size),				// # coefs for audio cutoff filter
-		0);												// min phase flag for audio cutoff filter
+		0,												// min phase flag for audio cutoff filter
+		ch[channel].precision);							// kernel precision
 
 	// FM squelch
 	rxa[channel].fmsq.p = create_fmsq (
@@ -231,7 +234,8 @@ void create_rxa (int channel)
 		0.000,											// minimum tail time
 		1.200,											// maximum tail time
 		max(2048, ch[channel].dsp_size),				// number of coefficients for noise filter
-		0);												// minimum phase flag
+		0,												// minimum phase flag
+		ch[channel].precision);							// kernel precision
 
 	// snba
 	rxa[channel].snba.p = create_snba (
@@ -271,7 +275,8 @@ void create_rxa (int channel)
 		default_G,										// gain vector
 		0,												// cutoff mode
 		0,												// wintype
-		ch[channel].dsp_rate);							// sample rate
+		ch[channel].dsp_rate,							// sample rate
+		ch[channel].precision);							// kernel precision
 	}
 
 	// ANF
@@ -386,7 +391,8 @@ void create_rxa (int channel)
 		-150.0,											// upper filter frequency
 		ch[channel].dsp_rate,							// sample rate
 		1,												// wintype
-		1.0);											// gain
+		1.0,											// gain
+		ch[channel].precision);							// kernel precision
 
 	// pull phase & scope display data
 	rxa[channel].sip1.p = create_siphon (
@@ -421,7 +427,8 @@ void create_rxa (int channel)
 		100.0,											// bandwidth
 		ch[channel].dsp_rate,							// sample rate
 		2.0,											// gain
-		2 );											// mode
+		2,												// mode
+		ch[channel].precision);							// kernel precision
 
 	// matched CW filter
 	rxa[channel].matched.p = create_matched (
@@ -434,7 +441,8 @@ void create_rxa (int channel)
 		100.0,											// bandwidth
 		ch[channel].dsp_rate,							// sample rate
 		2.0,											// gain
-		2 );											// mode
+		2,												// mode
+		ch[channel].precision);							// kernel precision
 
 	// gaussian peaking filter
 	rxa[channel].gaussian.p = create_gaussian (
@@ -449,7 +457,8 @@ void create_rxa (int channel)
 		ch[channel].dsp_rate,							// sample rate
 		2.0,											// gain
 		3.0,											// nsigma
-		2 );											// mode
+		2,												// mode
+		ch[channel].precision);							// kernel precision
 
 	// bi-quad peaking filter
 	rxa[channel].speak.p = create_speak (
@@ -1023,4 +1032,14 @@ void RXASetMP (int channel, int mp)
 	SetRXAFMSQMP				(channel, mp);
 	SetRXAFMMPde				(channel, mp);
 	SetRXAFMMPaud				(channel, mp);
+}
+
+PORT
+void RXASetHalfbandResample (int channel, int run)
+{
+	// power-of-two conversions by half-band stages; see resample.c
+	int oldstate = SetChannelState (channel, 0, 1);
+	setHalfband_resample (rxa[channel].rsmpin.p, run);
+	setHalfband_resample (rxa[channel].rsmpout.p, run);
+	SetChannelState (channel, oldstate, 0);
 }
\ No newline at end of file
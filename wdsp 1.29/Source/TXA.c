@@ -124,7 +124,8 @@ void create_txa (int channel)
 		default_G,									// vector of gain values
 		0,											// cutoff mode
 		0,											// wintype
-		ch[channel].dsp_rate);						// samplerate
+		ch[channel].dsp_rate,						// samplerate
+		ch[channel].precision);						// kernel precision
 	}
 
 	txa[channel].eqmeter.p = create_meter (	
@@ -153,7 +154,8 @@ void create_txa (int channel)
 		ch[channel].dsp_rate,						// sample rate
 		0,											// pre-emphasis type
 		300.0,										// f_low
-		3000.0);									// f_high
+		3000.0,										// f_high
+		ch[channel].precision);						// kernel precision
 
 	txa[channel].leveler.p = create_wcpagc (
 		0,											// run - OFF by default
@@ -248,7 +250,8 @@ void create_txa (int channel)
 		txa[channel].f_high,						// high freq cutoff
 		ch[channel].dsp_rate,						// samplerate
 		1,											// wintype
-		2.0);										// gain
+		2.0,										// gain
+		ch[channel].precision);						// kernel precision
 
 	txa[channel].compressor.p = create_compressor (
 		0,											// run - OFF by default
@@ -269,7 +272,8 @@ void create_txa (int channel)
 		txa[channel].f_high,						// high freq cutoff
 		ch[channel].dsp_rate,						// samplerate
 		1,											// wintype
-		2.0);										// gain	
+		2.0,										// gain	
+		ch[channel].precision);						// kernel precision
 
 	txa[channel].osctrl.p = create_osctrl (
 		0,											// run
@@ -291,7 +295,8 @@ void create_txa (int channel)
 		txa[channel].f_high,						// high freq cutoff
 		ch[channel].dsp_rate,						// samplerate
 		1,											// wintype
-		1.0);										// gain
+		1.0,										// gain
+		ch[channel].precision);						// kernel precision
 
 	txa[channel].compmeter.p = create_meter (
 		1,											// run
@@ -356,7 +361,8 @@ void create_txa (int channel)
 		100.0,										// ctcss frequency
 		1,											// run bandpass filter
 		max(2048, ch[channel].dsp_size),			// number coefficients for bandpass filter
-		0);											// minimum phase flag
+		0,											// minimum phase flag
+		ch[channel].precision);						// kernel precision
 	
 	txa[channel].gen1.p = create_gen (
 		0,											// run
@@ -446,7 +452,8 @@ void create_txa (int channel)
 		20000.0,									// cutoff frequency
 		2,											// brick-wall windowed rolloff
 		0.0,										// raised-cosine transition width
-		0);											// window type
+		0,											// window type
+		ch[channel].precision);						// kernel precision
 
 	txa[channel].rsmpout.p = create_resample (
 		0,											// run - will be turned ON below if needed
@@ -927,6 +934,16 @@ void TXASetMP (int channel, int mp)
 	SetTXAFMMP					(channel, mp);
 }
 
+PORT
+void TXASetHalfbandResample (int channel, int run)
+{
+	// power-of-two conversions by half-band stages; see resample.c
+	int oldstate = SetChannelState (channel, 0, 1);
+	setHalfband_resample (txa[channel].rsmpin.p, run);
+	setHalfband_resample (txa[channel].rsmpout.p, run);
+	SetChannelState (channel, oldstate, 0);
+}
+
 PORT
 void SetTXAFMAFFilter (int channel, double low, double high)
 {
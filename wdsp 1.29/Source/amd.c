@@ -76,7 +76,7 @@ void init_amd(AMD a)
 	a->omega_max = TWOPI * a->fmax / a->sample_rate;
 	a->g1 = 1.0 - exp(-2.0 * a->omegaN * a->zeta / a->sample_rate);
 	a->g2 = -a->g1 + 2.0 * (1 - exp(-a->omegaN * a->zeta / a->sample_rate) * cos(a->omegaN / a->sample_rate * sqrt(1.0 - a->zeta * a->zeta)));
-	a->phs = 0.0;
+	init_nco (&a->osc, 0.0);
 	a->fil_out = 0.0;
 	a->omega = 0.0;
 
@@ -149,8 +149,7 @@ void xamd (AMD a)
 				{
 					for (i = 0; i < a->buff_size; i++)
 					{
-						vco[0] = cos(a->phs);
-						vco[1] = sin(a->phs);
+						cs_nco (&a->osc, vco);
 
 						ai = a->in_buff[2 * i + 0] * vco[0];
 						bi = a->in_buff[2 * i + 0] * vco[1];
@@ -220,15 +219,13 @@ void xamd (AMD a)
 						a->out_buff[2 * i + 1] = audio;
 
 						if ((corr[0] == 0.0) && (corr[1] == 0.0)) corr[0] = 1.0;
-						det = atan2(corr[1], corr[0]);
+						det = fatan2(corr[1], corr[0]);
 						del_out = a->fil_out;
 						a->omega += a->g2 * det;
 						if (a->omega < a->omega_min) a->omega = a->omega_min;
 						if (a->omega > a->omega_max) a->omega = a->omega_max;
 						a->fil_out = a->g1 * det + a->omega;
-						a->phs += del_out;
-						while (a->phs >= TWOPI) a->phs -= TWOPI;
-						while (a->phs < 0.0) a->phs += TWOPI;
+						advance_nco (&a->osc, del_out);
 					}
 					break;
 				}
@@ -26,6 +26,7 @@ warren@wpratt.com
 
 #ifndef _amd_h
 #define _amd_h
+#include "nco.h"
 
 // ff defines for sbdemod
 #ifndef STAGES
@@ -51,7 +52,7 @@ typedef struct _amd
 	double omega_max;					// pll - maximum lock check parameter
 	double zeta;						// pll - damping factor; as coded, must be <=1.0
 	double omegaN;						// pll - natural frequency
-	double phs;							// pll - phase accumulator
+	nco osc;							// pll - vco
 	double omega;						// pll - locked pll frequency
 	double fil_out;						// pll - filter output
 	double g1, g2;						// pll - filter gain parameters
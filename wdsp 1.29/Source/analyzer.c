@@ -177,11 +177,10 @@ void new_window(int disp, int type, int size, double PiAlpha)
 }
 
 // spur elimination, REAL input data
-void eliminate(int disp, int ss, int LO)
+void eliminate(int disp, int ss, int LO, fftw_complex *out)
 {
 	DP a = pdisp[disp];
-	int i, k, begin, end, ilim;
-	double mag;
+	int k, begin, end, ilim;
 
 	if (ss == a->begin_ss)
 		begin = a->fscL + a->clip;
@@ -193,30 +192,21 @@ void eliminate(int disp, int ss, int LO)
 		end = a->out_size - 1 - a->clip;
 
 	ilim = a->out_size - 1;
+	k = max (end - begin, 0);
 
 	if (a->flip[LO])
-		for (i = ilim - begin, k = 0; i > ilim - end; i--, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
+		cmagmin (k, a->result[ss], out[ilim - begin], 1, a->spec_flag[ss] == 0);
 	else
-		for (i = begin, k = 0; i < end; i++, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
+		cmagmin (k, a->result[ss], out[begin], 0, a->spec_flag[ss] == 0);
 	a->ss_bins[ss] = k;
 }
 
 // spur elimination, COMPLEX input data
-void Celiminate(int disp, int ss, int LO)
+void Celiminate(int disp, int ss, int LO, fftw_complex *out)
 {
 	DP a = pdisp[disp];
-	int i, k, begin0, end0, begin1, end1, ilim;
-	double mag;
+	int k, n0, n1, begin0, end0, begin1, end1, ilim;
+	int init = a->spec_flag[ss] == 0;
 
 	if (ss == a->begin_ss)
 	{
@@ -246,40 +236,45 @@ void Celiminate(int disp, int ss, int LO)
 	}
 
 	ilim = a->out_size - 1;
+	n0 = max (end0 - begin0, 0);
+	n1 = max (end1 - begin1, 0);
 
 	if (a->flip[LO])
 	{
-		for (i = ilim - begin0, k = 0; i > ilim - end0; i--, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
-		for (i = ilim - begin1; i > ilim - end1; i--, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
+		if (n0) cmagmin (n0, a->result[ss],      out[ilim - begin0], 1, init);
+		if (n1) cmagmin (n1, a->result[ss] + n0, out[ilim - begin1], 1, init);
 	}
 	else
 	{
-		for (i = begin0, k = 0; i < end0; i++, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
-		for (i = begin1; i < end1; i++, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
+		if (n0) cmagmin (n0, a->result[ss],      out[begin0], 0, init);
+		if (n1) cmagmin (n1, a->result[ss] + n0, out[begin1], 0, init);
 	}
+	k = n0 + n1;
 	a->ss_bins[ss] = k;
 }
 
+// pixel into which bin 'i' is detected when there are no more pixels than bins
+static __inline int det_pix (int i, int num_pixels, double pix_per_bin, double det_offset)
+{
+	int pix = (int)(det_offset + (double)i * pix_per_bin);
+	return pix < num_pixels ? pix : num_pixels - 1;
+}
+
+// end (exclusive) of the run of bins, starting at 'i', that are detected into the same pixel as bin 'i'
+static int det_run_end (int i, int ilim, int num_pixels, double pix_per_bin, double det_offset)
+{
+	int pix = det_pix (i, num_pixels, pix_per_bin, det_offset);
+	int end;
+	if (pix == num_pixels - 1) return ilim;
+	// estimate, then settle against the exact per-bin mapping
+	end = (int)ceil (((double)(pix + 1) - det_offset) / pix_per_bin);
+	if (end <= i) end = i + 1;
+	if (end > ilim) end = ilim;
+	while (end > i + 1 && det_pix (end - 1, num_pixels, pix_per_bin, det_offset) != pix) end--;
+	while (end < ilim && det_pix (end, num_pixels, pix_per_bin, det_offset) == pix) end++;
+	return end;
+}
+
 void detector (	int det_type,			// detector type
 				int m,					// number of bins
 				int num_pixels,			// number of output pixels
@@ -293,10 +288,10 @@ void detector (	int det_type,			// detector type
 				double det_offset
 				)
 {
-	int i, imin, ilim;
+	int i, imin, ilim, end;
 	int pix_count = 0;
 	int rose, fell, next_pix_count, bcount, last_pix_count;
-	double prev_maxi, mini, maxi, psum;
+	double prev_maxi, mini, maxi;
 	if (pix_per_bin <= 1.0)
 	{
 		if (fsclipL == floor(fsclipL)) imin = 0;
@@ -310,12 +305,10 @@ void detector (	int det_type,			// detector type
 			for (i = 0; i < num_pixels; i++)
 				pixels[i]   = - 1.0e300;
 
-			for (i = imin; i < ilim; i++)
+			for (i = imin; i < ilim; i = end)
 			{
-				pix_count = (int)(det_offset + (double)i * pix_per_bin);
-				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
-				if (bins[i] > pixels[pix_count])
-					pixels[pix_count] = bins[i];
+				end = det_run_end (i, ilim, num_pixels, pix_per_bin, det_offset);
+				pixels[det_pix (i, num_pixels, pix_per_bin, det_offset)] = vmax (end - i, bins + i);
 			}
 			break;
 
@@ -366,28 +359,10 @@ void detector (	int det_type,			// detector type
 			break;
 
 		case 2:		// average - adjusted for window's equivalent noise bandwidth
-			psum = 0.0;
-			bcount = 0;
-			for (i = imin; i < ilim; i++)
+			for (i = imin; i < ilim; i = end)
 			{
-				last_pix_count = pix_count;
-				pix_count = (int)(det_offset + (double)i * pix_per_bin);
-				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
-				if (pix_count == last_pix_count)
-				{
-					psum += bins[i];
-					bcount++;
-				}
-				else
-				{
-					pixels[last_pix_count] = psum / (double)bcount * inv_enb;
-					psum = bins[i];
-					bcount = 1;
-				}
-				if (i == ilim - 1)
-				{
-					pixels[pix_count] = psum / (double)bcount * inv_enb;
-				}
+				end = det_run_end (i, ilim, num_pixels, pix_per_bin, det_offset);
+				pixels[det_pix (i, num_pixels, pix_per_bin, det_offset)] = vsum (end - i, bins + i) / (double)(end - i) * inv_enb;
 			}
 			break;
 
@@ -415,28 +390,10 @@ void detector (	int det_type,			// detector type
 			break;
 
 		case 4:		// rms
-			psum = 0.0;
-			bcount = 0;
-			for (i = imin; i < ilim; i++)
+			for (i = imin; i < ilim; i = end)
 			{
-				last_pix_count = pix_count;
-				pix_count = (int)(det_offset + (double)i * pix_per_bin);
-				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
-				if (pix_count == last_pix_count)
-				{
-					psum += bins[i] * bins[i];
-					bcount++;
-				}
-				else
-				{
-					pixels[last_pix_count] = sqrt (psum / (double)bcount) * inv_enb;
-					psum = bins[i] * bins[i];
-					bcount = 1;
-				}
-				if (i == ilim - 1)
-				{
-					pixels[pix_count] = sqrt (psum / (double)bcount) * inv_enb;
-				}
+				end = det_run_end (i, ilim, num_pixels, pix_per_bin, det_offset);
+				pixels[det_pix (i, num_pixels, pix_per_bin, det_offset)] = sqrt (vsumsq (end - i, bins + i) / (double)(end - i)) * inv_enb;
 			}
 			break;
 		}
@@ -461,6 +418,24 @@ void detector (	int det_type,			// detector type
 	
 }
 
+#define DB_CHUNK	256
+
+// pixels[i] = 10 * mlog10 (gain * cd[i] * x[i] * k + 1.0e-60), in chunks so the products stay on the stack
+static void dbpix (int n, dOUTREAL* pixels, double gain, double* cd, double* x, double k)
+{
+	int i, j, c;
+	double g[DB_CHUNK], db[DB_CHUNK];
+	for (i = 0; i < n; i += c)
+	{
+		c = min (n - i, DB_CHUNK);
+		for (j = 0; j < c; j++)
+			g[j] = gain * cd[i + j];
+		vdb (c, db, g, x + i, k);
+		for (j = 0; j < c; j++)
+			pixels[i + j] = (dOUTREAL)db[j];
+	}
+}
+
 void avenger (  int av_mode,				// averaging mode
 				int num_pixels,				// number of pixels
 				int* avail_frames,			// number of available frames for window averaging
@@ -478,35 +453,30 @@ void avenger (  int av_mode,				// averaging mode
 				dOUTREAL* pixels			// output buffer
 	)
 {
-	int i;
+	int i, j, c;
 	double factor;
 	switch (av_mode)
 	{
 	case -1:	// peak-hold
 		{
 			for (i = 0; i < num_pixels; i++)
-			{
 				if (t_pixels[i] > av_sum[i])
 					av_sum[i] = t_pixels[i];
-				pixels[i] = (dOUTREAL)(10.0 * mlog10(scale * cd[i] * av_sum[i] + 1.0e-60));
-			}
+			dbpix (num_pixels, pixels, scale, cd, av_sum, 1.0);
 			break;
 		}
 	case 0:		// no averaging
 	default:
 		{
-			for (i = 0; i < num_pixels; i++)
-				pixels[i] = (dOUTREAL)(10.0 * mlog10(scale * cd[i] * t_pixels[i] + 1.0e-60));
+			dbpix (num_pixels, pixels, scale, cd, t_pixels, 1.0);
 			break;
 		}
 	case 1:		// weighted averaging of linear data
 		{
 			double onem_avb = 1.0 - av_backmult;
 			for (i = 0; i < num_pixels; i++)
-			{
 				av_sum[i] = av_backmult * av_sum[i] + onem_avb * t_pixels[i];
-				pixels[i] = (dOUTREAL)(10.0 * mlog10(scale * cd[i] * av_sum[i] + 1.0e-60));
-			}
+			dbpix (num_pixels, pixels, scale, cd, av_sum, 1.0);
 			break;
 		}
 	case 2:		// window averaging of linear data
@@ -518,8 +488,8 @@ void avenger (  int av_mode,				// averaging mode
 				{
 					av_sum[i] += t_pixels[i];
 					av_buff[*av_in_idx][i] = t_pixels[i];
-					pixels[i] = (dOUTREAL)(10.0 * mlog10(cd[i] * av_sum[i] * factor + 1.0e-60));
 				}
+				dbpix (num_pixels, pixels, 1.0, cd, av_sum, factor);
 			}
 			else
 			{
@@ -528,8 +498,8 @@ void avenger (  int av_mode,				// averaging mode
 				{
 					av_sum[i] += t_pixels[i] - (av_buff[*av_out_idx])[i];
 					av_buff[*av_in_idx][i] = t_pixels[i];
-					pixels[i] = (dOUTREAL)(10.0 * mlog10(cd[i] * av_sum[i] * factor + 1.0e-60));
 				}
+				dbpix (num_pixels, pixels, 1.0, cd, av_sum, factor);
 				if (++(*av_out_idx) == dMAX_AVERAGE)
 						*av_out_idx = 0;
 			}
@@ -540,10 +510,18 @@ void avenger (  int av_mode,				// averaging mode
 	case 3:		// weighted averaging of log data - looks nice, not accurate for time-varying signals
 		{
 			double onem_avb = 1.0 - av_backmult;
-			for (i = 0; i < num_pixels; i++)
+			double g[DB_CHUNK], db[DB_CHUNK];
+			for (i = 0; i < num_pixels; i += c)
 			{
-				av_sum[i] = av_backmult * av_sum[i] + onem_avb * (10.0 * mlog10(scale * cd[i] * t_pixels[i] + 1e-60));
-				pixels[i] = (dOUTREAL)av_sum[i];
+				c = min (num_pixels - i, DB_CHUNK);
+				for (j = 0; j < c; j++)
+					g[j] = scale * cd[i + j];
+				vdb (c, db, g, t_pixels + i, 1.0);
+				for (j = 0; j < c; j++)
+				{
+					av_sum[i + j] = av_backmult * av_sum[i + j] + onem_avb * db[j];
+					pixels[i + j] = (dOUTREAL)av_sum[i + j];
+				}
 			}
 			break;
 		}
@@ -553,11 +531,50 @@ void avenger (  int av_mode,				// averaging mode
 			pixels[i] += (dOUTREAL)norm_oneHz;
 }
 
+/********************************************************************************************************
+*																										*
+*											Pixel Publication											*
+*																										*
+********************************************************************************************************/
+
+// The three pixel buffers of an output are a lock-free triple buffer.  The writer (stitch) owns
+// w_pix_buff, the reader (GetPixels) owns r_pix_buff, and the third is held in 'pb_state'.  Each side
+// trades its buffer for the held one with a single exchange, so neither ever waits for the other.
+// There is one writer at a time (ResampleSection) and one reader per output.
+
+#define PB_FRESH	4
+
+static void publish_pixels (DP a, int pixout, LARGE_INTEGER *t_in)
+{
+	int w = a->w_pix_buff[pixout];
+	a->pb_frame[pixout][w] = ++a->pb_seq[pixout];
+	a->pb_npix[pixout][w] = a->num_pixels;
+	a->pb_in[pixout][w] = *t_in;
+	QueryPerformanceCounter (&a->pb_time[pixout][w]);
+	a->w_pix_buff[pixout] = InterlockedExchange (&a->pb_state[pixout], w | PB_FRESH) & 3;
+}
+
+static void discard_pixels (DP a, int pixout)
+{
+	// drop a published frame that has not been read; the buffer assignment is unchanged
+	InterlockedAnd (&a->pb_state[pixout], ~PB_FRESH);
+}
+
+static int take_pixels (DP a, int pixout)
+{
+	// returns 1 and moves r_pix_buff to the newest frame if one has been published since the last take
+	if ((a->pb_state[pixout] & PB_FRESH) == 0)
+		return 0;
+	a->r_pix_buff[pixout] = InterlockedExchange (&a->pb_state[pixout], a->r_pix_buff[pixout]) & 3;
+	return 1;
+}
+
 void stitch(int disp)
 {
 	DP a = pdisp[disp];
 	int i, j, k, n, m;
 	double* ptr;
+	LARGE_INTEGER t_in;
 
 	// stitch
 	m = 0;
@@ -568,6 +585,12 @@ void stitch(int disp)
 		ptr += a->ss_bins[n];
 		m += a->ss_bins[n];
 	}
+	// the frame is as old as its newest input
+	t_in = a->t_in[0][0];
+	for (n = 0; n < a->num_stitch; n++)
+		for (j = 0; j < a->num_fft; j++)
+			if (a->t_in[n][j].QuadPart > t_in.QuadPart)
+				t_in = a->t_in[n][j];
 	for (i = 0; i < a->num_pixout; i++)	// for each output
 	{
 		EnterCriticalSection(&a->ResampleSection);
@@ -590,84 +613,11 @@ void stitch(int disp)
 		avenger (a->av_mode[i], a->num_pixels, &a->avail_frames[i], a->num_average[i], &a->av_in_idx[i], &a->av_out_idx[i],
 			a->av_backmult[i], a->scale, a->t_pixels[i], a->av_sum[i], a->av_buff[i], a->cd, a->normalize[i], a->norm_oneHz,
 			a->pixels[i][a->w_pix_buff[i]]);
+		publish_pixels (a, i, &t_in);
 		LeaveCriticalSection(&a->ResampleSection);
-
-		EnterCriticalSection(&a->PB_ControlsSection[i]);
-			a->last_pix_buff[i] = a->w_pix_buff[i];	
-			while ((a->w_pix_buff[i] = (a->w_pix_buff[i] + 1) % dNUM_PIXEL_BUFFS) == a->r_pix_buff[i]);
-		LeaveCriticalSection(&a->PB_ControlsSection[i]);
-		InterlockedBitTestAndSet(&(a->pb_ready[i][a->last_pix_buff[i]]), 0);
 	}
 }
 
-DWORD WINAPI spectra (void *pargs)
-{
-	int i, j;
-	int disp = ((int)(uintptr_t)pargs) >> 12;
-	int ss = (((int)(uintptr_t)pargs) >> 4) & 255;
-	int LO = ((int)(uintptr_t)pargs) & 15;
-	DP a = pdisp[disp];
-
-	if (a->stop)
-	{
-		InterlockedDecrement(a->pnum_threads);
-		return 0;
-	}
-
-	if ((ss >= a->begin_ss) && (ss <= a->end_ss))
-	{
-		for (i = 0; i < a->size; i++)
-		{
-			(a->fft_in[ss][LO])[i] = a->window[i] * (double)((a->I_samples[ss][LO])[a->IQO_idx[ss][LO]]);
-			if(++a->IQO_idx[ss][LO] >= a->bsize)
-				 a->IQO_idx[ss][LO] -= a->bsize;
-		}
-
-		if (a->stop)
-		{
-			InterlockedDecrement(a->pnum_threads);
-			return 0;
-		}
-		fftw_execute (a->plan[ss][LO]);
-	}
-	if (a->stop)
-	{
-		InterlockedDecrement(a->pnum_threads);
-		return 0;
-	}
-
-	EnterCriticalSection(&(a->EliminateSection[ss]));
-	if ((ss >= a->begin_ss) && (ss <= a->end_ss))
-		eliminate(disp, ss, LO);
-	a->spec_flag[ss] |= 1 << LO;
-
-	if (a->spec_flag[ss] == ((1 << a->num_fft) - 1))
-	{
-		a->spec_flag[ss] = 0;
-		LeaveCriticalSection (&(a->EliminateSection[ss]));
-
-		EnterCriticalSection (&a->StitchSection);
-		a->stitch_flag |= ((uint64_t)1) << ss;
-
-		if (a->stitch_flag == ((((uint64_t)1) << a->num_stitch) - 1))
-		{
-			a->stitch_flag = 0;
-			LeaveCriticalSection(&a->StitchSection);
-			for (j = 0; j < dMAX_STITCH; j++)
-				for (i = 0; i < dMAX_NUM_FFT; i++)
-					InterlockedBitTestAndReset(&(a->input_busy[j][i]), 0);
-			stitch(disp);
-		}
-		else
-			LeaveCriticalSection(&a->StitchSection);
-	}
-	else
-		LeaveCriticalSection (&(a->EliminateSection[ss]));
-
-	InterlockedDecrement(a->pnum_threads);
-	return 1;
-}
-
 /********************************************************************************************************
 *																										*
 *							BEGIN CODE TO GET MAX FFT_BIN WITHIN A FREQ RANGE							*
@@ -698,9 +648,22 @@ void Init_DetectMaxBin(int disp)
 void Destroy_DetectMaxBin(int disp)
 {
 	DP a = pdisp[disp];
+	if (a->bq)
+	{
+		destroy_bandq(a->bq);
+		a->bq = NULL;
+	}
 	DeleteCriticalSection(&a->cs_dmb);
 }
 
+static void need_bandq(DP a)
+{
+	EnterCriticalSection(&a->cs_dmb);
+	if (a->bq == NULL)
+		a->bq = create_bandq(a->max_size);
+	LeaveCriticalSection(&a->cs_dmb);
+}
+
 // Called from SetupDetectMaxBin(...) AND anytime 'size' changes, e.g., in SetAnalyzer(...)
 void calc_dmb(int disp, int size)
 {
@@ -769,6 +732,7 @@ void SetupDetectMaxBin(int run, int disp, int ss, int LO, double rate,
 	// We only allow setup for one (ss,LO) pair at a time for each 'disp'.
 	DP a = pdisp[disp];
 	
+	if (run) need_bandq(a);
 	a->dmb_run = run;
 	a->dmb_disp = disp;
 	a->dmb_ss = ss;
@@ -782,37 +746,50 @@ void SetupDetectMaxBin(int run, int disp, int ss, int LO, double rate,
 	calc_dmb(a->dmb_disp, a->size);
 }
 
-// Call this function in 'Cspectra(...)', after the FFT.
-void DetectMaxBin(int disp, int ss, int LO)
+// fft output bin 'i' in frequency order, i.e., as held by the band query scratch
+static __inline int dmb_bin(DP a, int i)
+{
+	return i >= a->size / 2 ? i - a->size / 2 : i + a->size - a->size / 2;
+}
+
+// Call this function after the FFT.  The max bin and the band query table (see bandq.h) are both answered
+// from one pass over the fft output.
+static void band_queries(int disp, int ss, int LO, fftw_complex *fft_out)
 {
 	DP a = pdisp[disp];
-	int i;
-	double mag, dmb_max;
+	BANDQ q = a->bq;
+	int dmb, tab, j0, j1;
+	double dmb_max;
 	double dmb_max_dB;
+	if (q == NULL) return;
 	// If 'run' is set and the FFT Output is from the correct disp, ss, LO ...
-	if (a->dmb_run && disp == a->dmb_disp && ss == a->dmb_ss && LO == a->dmb_LO)
+	dmb = a->type == 1 && a->dmb_run && disp == a->dmb_disp && ss == a->dmb_ss && LO == a->dmb_LO;
+	EnterCriticalSection(&q->cs);
+	tab = q->run && q->nbands > 0 && ss == q->ss && LO == q->LO;
+	if (dmb || tab)
 	{
-		fftw_complex* fft_out = a->fft_out[ss][LO];
-		dmb_max = 1.0e-60;
-		EnterCriticalSection(&a->cs_dmb);
-		for (i = a->dmb_begin0; i <= a->dmb_end0; i++)
+		build_bandq(q, fft_out, a->size, a->type, a->scale);
+		if (tab)
+			xbandq(q, a->scale, a->inv_enb);
+		if (dmb)
 		{
-			mag = fft_out[i][0] * fft_out[i][0] + fft_out[i][1] * fft_out[i][1];
-			if (mag > dmb_max) dmb_max = mag;
+			dmb_max = 1.0e-60;
+			EnterCriticalSection(&a->cs_dmb);
+			// the two pieces of a range that spans 0 Hz are contiguous in frequency order
+			j0 = dmb_bin(a, a->dmb_begin0);
+			j1 = dmb_bin(a, a->dmb_end1 >= a->dmb_begin1 ? a->dmb_end1 : a->dmb_end0);
+			if (a->dmb_end0 >= a->dmb_begin0 && j1 >= j0)
+				dmb_max = max(dmb_max, q->mag[argmax_bandq(q, j0, j1)]);
+
+			a->dmb_max_dB -= fabs((1.0 - a->dmb_decay) * a->dmb_max_dB);
+			dmb_max_dB = 10.0 * mlog10(a->scale * dmb_max);
+			if (dmb_max_dB > a->dmb_max_dB) a->dmb_max_dB = dmb_max_dB;
+			LeaveCriticalSection(&a->cs_dmb);
+			// for test only.
+			// printf("Max Bin = %.5e\n", a->dmb_max_dB);
 		}
-		for (i = a->dmb_begin1; i <= a->dmb_end1; i++)
-		{
-			mag = fft_out[i][0] * fft_out[i][0] + fft_out[i][1] * fft_out[i][1];
-			if (mag > dmb_max) dmb_max = mag;
-		}
-
-		a->dmb_max_dB -= fabs((1.0 - a->dmb_decay) * a->dmb_max_dB);
-		dmb_max_dB = 10.0 * mlog10(a->scale * dmb_max);
-		if (dmb_max_dB > a->dmb_max_dB) a->dmb_max_dB = dmb_max_dB;
-		LeaveCriticalSection(&a->cs_dmb);
-		// for test only.
-		// printf("Max Bin = %.5e\n", a->dmb_max_dB);
 	}
+	LeaveCriticalSection(&q->cs);
 }
 
 // Call from console, for each 'disp' for which this function is desired.
@@ -828,66 +805,108 @@ double GetDetectMaxBin(int disp)
 	return dmb_max_dB;
 }
 
+// Call from console to attach a table of up to BQ_MAX_BANDS bands to the fft of (ss, LO).
+// rate:		Sample rate at the fft, i.e., after any zoom decimation.
+// fLow, fHigh:	Band edges in Hz, referenced to the centre of the span; bands may overlap.
+// occ_dB:		Occupancy threshold, on the scale of the uncalibrated pixels.
+// floor_bins:	Width of the moving mean whose minimum is the noise floor; 0 for the default.
+// Replacing the table discards any results of the old one that have not been read.
+PORT
+void SetAnalyzerBandQueries(int disp, int run, int ss, int LO, double rate, int nbands, double *fLow, double *fHigh,
+	double occ_dB, int floor_bins)
+{
+	DP a = pdisp[disp];
+	need_bandq(a);
+	setTable_bandq(a->bq, run, ss, LO, rate, nbands, fLow, fHigh, occ_dB, floor_bins);
+}
+
+// Wait-free; returns the newest frame's results with *flag = 1, or *flag = 0 if none arrived since the
+// last call.  Arrays must hold 'nbands' values; NULL arrays are skipped.  One reader per display.
+PORT
+void GetAnalyzerBandResults(int disp, int *nbands, double *peak, double *peak_freq, double *mean, double *floor_dB,
+	double *occupancy, uint64_t *seq, int *flag)
+{
+	DP a = pdisp[disp];
+	*flag = a->bq ? getResults_bandq(a->bq, nbands, peak, peak_freq, mean, floor_dB, occupancy, seq) : 0;
+}
+
 /********************************************************************************************************
 *																										*
 *							END CODE TO GET MAXIMUM FFT_BIN WITHIN A FREQ RANGE							*
 *																										*
 ********************************************************************************************************/
 
-DWORD WINAPI Cspectra (void *pargs)
-{
-	int i, j;
-	int disp = ((int)(uintptr_t)pargs) >> 12;
-	int ss = (((int)(uintptr_t)pargs) >> 4) & 255;
-	int LO = ((int)(uintptr_t)pargs) & 15;
-	DP a = pdisp[disp];
-	int trans_size = a->size * sizeof(double);
+static void dispatch_spectra (int disp);
 
-	if (a->stop)
-	{
-		InterlockedDecrement(a->pnum_threads);
-		return 0;
-	}
+static double an_elapsed (LARGE_INTEGER *t0);
 
-	if ((ss >= a->begin_ss) && (ss <= a->end_ss))
-	{
-		for (i = 0; i < a->size; i++)
-		{
-			(a->Cfft_in[ss][LO])[i][0] = a->window[i] * (double)((a->I_samples[ss][LO])[a->IQO_idx[ss][LO]]);
-			(a->Cfft_in[ss][LO])[i][1] = a->window[i] * (double)((a->Q_samples[ss][LO])[a->IQO_idx[ss][LO]]);
-			if(++a->IQO_idx[ss][LO] >= a->bsize)
-				 a->IQO_idx[ss][LO] -= a->bsize;
-		}
+static void record_fft (DP a, double t);
 
-		if (a->stop)
-		{
-			InterlockedDecrement(a->pnum_threads);
-			return 0;
-		}
-		fftw_execute (a->Cplan[ss][LO]);
-
-		// Detect value of Max FFT Bin in a freq range
-		DetectMaxBin(disp, ss, LO);
-		// 
+static void record_work (DP a, double t);
 
+// windowed copy of one fft input frame out of the sample ring; the window is applied as it is copied
+static void load_spectra (DP a, int ss, int LO, double *in)
+{
+	int i;
+	int idx = a->IQO_idx[ss][LO];
+	dINREAL *I = a->I_samples[ss][LO];
+	for (i = 0; i < a->size; i++)
+	{
+		in[i] = a->window[i] * (double)I[idx];
+		if (++idx >= a->bsize)
+			idx -= a->bsize;
 	}
+	a->IQO_idx[ss][LO] = idx;
+}
 
-	if (a->stop)
+static void Cload_spectra (DP a, int ss, int LO, fftw_complex *in)
+{
+	int i;
+	int idx = a->IQO_idx[ss][LO];
+	dINREAL *I = a->I_samples[ss][LO];
+	dINREAL *Q = a->Q_samples[ss][LO];
+	for (i = 0; i < a->size; i++)
 	{
-		InterlockedDecrement(a->pnum_threads);
-		return 0;
+		in[i][0] = a->window[i] * (double)I[idx];
+		in[i][1] = a->window[i] * (double)Q[idx];
+		if (++idx >= a->bsize)
+			idx -= a->bsize;
 	}
+	a->IQO_idx[ss][LO] = idx;
+}
+
+// everything after the fft:  snap, elimination and, when the whole span is in, stitching; releases the job
+static void finish_spectra (int disp, int ss, int LO, fftw_complex *out)
+{
+	int i, j;
+	DP a = pdisp[disp];
+	int in_span = (ss >= a->begin_ss) && (ss <= a->end_ss);
+	int trans_size = a->size * sizeof(double);
+	LARGE_INTEGER t0;
+
+	QueryPerformanceCounter (&t0);
+	// Detect value of Max FFT Bin in a freq range, and answer the band queries
+	if (in_span)
+		band_queries(disp, ss, LO, out);
 
-	if (InterlockedBitTestAndReset(&(a->snap[ss][LO]), 0))
+	if (a->type == 1)
 	{
-		memcpy((char *)(a->snap_buff[ss][LO]), (char *)(a->fft_out[ss][LO]) + trans_size, trans_size);
-		memcpy((char *)(a->snap_buff[ss][LO]) + trans_size, (char *)(a->fft_out[ss][LO]), trans_size);
-		SetEvent(a->hSnapEvent[ss][LO]);
+		if (InterlockedBitTestAndReset(&(a->snap[ss][LO]), 0))
+		{
+			memcpy((char *)(a->snap_buff[ss][LO]), (char *)out + trans_size, trans_size);
+			memcpy((char *)(a->snap_buff[ss][LO]) + trans_size, (char *)out, trans_size);
+			SetEvent(a->hSnapEvent[ss][LO]);
+		}
 	}
 
 	EnterCriticalSection(&(a->EliminateSection[ss]));
-	if ((ss >= a->begin_ss) && (ss <= a->end_ss))
-		Celiminate(disp, ss, LO);
+	if (in_span)
+	{
+		if (a->type == 0)
+			eliminate(disp, ss, LO, out);
+		else
+			Celiminate(disp, ss, LO, out);
+	}
 	a->spec_flag[ss] |= 1 << LO;
 
 	if (a->spec_flag[ss] == ((1 << a->num_fft) - 1))
@@ -902,10 +921,13 @@ DWORD WINAPI Cspectra (void *pargs)
 		{
 			a->stitch_flag = 0;
 			LeaveCriticalSection(&a->StitchSection);
+			// release the inputs only after stitch() has consumed 'result', which the next frame overwrites
+			stitch(disp);
 			for (j = 0; j < dMAX_STITCH; j++)
 				for (i = 0; i < dMAX_NUM_FFT; i++)
 					InterlockedBitTestAndReset(&(a->input_busy[j][i]), 0);
-			stitch(disp);
+			// buffers that filled while the frame was in flight are dispatched now
+			dispatch_spectra(disp);
 		}
 		else
 			LeaveCriticalSection(&a->StitchSection);
@@ -913,7 +935,86 @@ DWORD WINAPI Cspectra (void *pargs)
 	else
 		LeaveCriticalSection (&(a->EliminateSection[ss]));
 
+	record_work (a, an_elapsed (&t0));
 	InterlockedDecrement(a->pnum_threads);
+}
+
+DWORD WINAPI spectra (void *pargs)
+{
+	LARGE_INTEGER t0;
+	int disp = ((int)(uintptr_t)pargs) >> 12;
+	int ss = (((int)(uintptr_t)pargs) >> 4) & 255;
+	int LO = ((int)(uintptr_t)pargs) & 15;
+	DP a = pdisp[disp];
+
+	if (a->stop)
+	{
+		InterlockedDecrement(a->pnum_threads);
+		return 0;
+	}
+
+	if ((ss >= a->begin_ss) && (ss <= a->end_ss))
+	{
+		QueryPerformanceCounter (&t0);
+		load_spectra(a, ss, LO, a->fft_in[ss][LO]);
+		record_work (a, an_elapsed (&t0));
+
+		if (a->stop)
+		{
+			InterlockedDecrement(a->pnum_threads);
+			return 0;
+		}
+		QueryPerformanceCounter (&t0);
+		fftw_execute_dft_r2c (a->plan[ss][LO], a->fft_in[ss][LO], a->fft_out[ss][LO]);
+		record_fft (a, an_elapsed (&t0));
+	}
+	if (a->stop)
+	{
+		InterlockedDecrement(a->pnum_threads);
+		return 0;
+	}
+
+	finish_spectra(disp, ss, LO, a->fft_out[ss][LO]);
+	return 1;
+}
+
+DWORD WINAPI Cspectra (void *pargs)
+{
+	LARGE_INTEGER t0;
+	int disp = ((int)(uintptr_t)pargs) >> 12;
+	int ss = (((int)(uintptr_t)pargs) >> 4) & 255;
+	int LO = ((int)(uintptr_t)pargs) & 15;
+	DP a = pdisp[disp];
+
+	if (a->stop)
+	{
+		InterlockedDecrement(a->pnum_threads);
+		return 0;
+	}
+
+	if ((ss >= a->begin_ss) && (ss <= a->end_ss))
+	{
+		QueryPerformanceCounter (&t0);
+		Cload_spectra(a, ss, LO, a->Cfft_in[ss][LO]);
+		record_work (a, an_elapsed (&t0));
+
+		if (a->stop)
+		{
+			InterlockedDecrement(a->pnum_threads);
+			return 0;
+		}
+		QueryPerformanceCounter (&t0);
+		fftw_execute_dft (a->Cplan[ss][LO], a->Cfft_in[ss][LO], a->fft_out[ss][LO]);
+		record_fft (a, an_elapsed (&t0));
+	}
+
+	if (a->stop)
+	{
+		InterlockedDecrement(a->pnum_threads);
+		return 0;
+	}
+
+	finish_spectra(disp, ss, LO, a->fft_out[ss][LO]);
 	return 1;
 }
 
@@ -968,126 +1069,664 @@ void interpolate(int disp, int set, double fmin, double fmax, int num_pixels)
         mag = (((a->ac3[set][0])[k] * dx + (a->ac2[set][0])[k]) * dx + (a->ac1[set][0])[k]) * dx + (a->ac0[set][0])[k];
 		a->cd[i] = mag * mag;
 	}
-	return;
+	return;
+}
+
+int build_interpolants(int disp, int set, int n, int m, double *x, double (*y)[dMAX_M])
+{
+	DP a = pdisp[disp];
+	double dx[dMAX_N];
+	double idx[dMAX_N];
+	double dmain[dMAX_N];
+	double dsub[dMAX_N];
+	double dsup[dMAX_N];
+	double d[dMAX_N][dMAX_M];
+	double S[dMAX_N][dMAX_M];
+	double b[dMAX_N];
+	double v[dMAX_N][dMAX_M];
+	double tmp;
+	int i, j;
+	if (n < 3) return -1;
+    for (i = 0; i < n - 1; i++)
+    {
+        dx[i] = x[i + 1] - x[i];
+
+        if (dx[i] < 1e-30)
+            return -1;
+        idx[i] = 1.0 / dx[i];
+    }
+
+    for (i = 1; i <= n - 2; i++)
+    {
+        if (i == 1)
+        {
+            dsub[i] = 0.0;
+            dmain[i] = 3.0 * dx[i - 1] + 2.0 * dx[i];
+            dsup[i] = dx[i];
+        }
+        else if (i == (n - 2))
+        {
+            dsub[i] = dx[i - 1];
+            dmain[i] = 2.0 * dx[i - 1] + 3.0 * dx[i];
+            dsup[i] = 0.0;
+        }
+        else
+        {
+            dsub[i] = dx[i - 1];
+            dmain[i] = 2.0 * (dx[i - 1] + dx[i]);
+            dsup[i] = dx[i];
+        }
+		for (j = 0; j < m; j++)
+            d[i][j] = 6.0 * ((y[i + 1][j] - y[i][j]) * idx[i] - (y[i][j] - y[i - 1][j]) * idx[i - 1]);
+    }
+
+    b[1] = dmain[1];
+    for (j = 0; j < m; j++)
+        v[1][j] = d[1][j];
+
+    for (i = 2; i <= n - 2; i++)
+    {
+        tmp = dsub[i] / b[i - 1];
+        b[i] = dmain[i] - tmp * dsup[i - 1];
+        for (j = 0; j < m; j++)
+            v[i][j] = d[i][j] - tmp * v[i - 1][j];
+    }
+
+    for (j = 0; j < m; j++)
+        S[n - 2][j] = v[n - 2][j] / b[n - 2];
+
+    for (i = n - 3; i >= 1; i--)
+        for (j = 0; j < m; j++)
+            S[i][j] = (v[i][j] - dsup[i] * S[i + 1][j]) / b[i];
+
+    for (j = 0; j < m; j++)
+    {
+        S[0][j] = S[1][j];
+        S[n - 1][j] = S[n - 2][j];
+    }
+
+    for (i = 0; i < n - 1; i++)
+        for (j = 0; j < m; j++)
+        {
+            (a->ac3[set][j])[i] = (S[i + 1][j] - S[i][j]) / (6.0 * dx[i]);
+            (a->ac2[set][j])[i] = 0.5 * S[i][j];
+            (a->ac1[set][j])[i] = (y[i + 1][j] - y[i][j]) * idx[i] - (2.0 * dx[i] * S[i][j] + dx[i] * S[i + 1][j]) / 6.0;
+            (a->ac0[set][j])[i] = y[i][j];
+        }
+    return 0;
+}
+
+/********************************************************************************************************
+*																										*
+*										Analyzer Worker Pool											*
+*																										*
+********************************************************************************************************/
+
+// A buffer that becomes ready in OpenBuffer()/CloseBuffer() or Spectrum*() is dispatched on the caller's
+// thread into a bounded queue shared by all displays.  A fixed pool of worker threads drains the queue and
+// runs spectra()/Cspectra().  If the queue is full the frame is dropped and counted.  Buffers that fill
+// while a frame is still in flight are dispatched when that frame has been stitched.
+//
+// A worker that takes a job also takes up to dAN_BATCH - 1 other waiting jobs of the same type and size,
+// from any display, and runs their ffts as one batched plan.  Each frame is windowed with its own display's
+// coefficients as it is copied into the worker's batch buffer, so the window type need not match.
+
+typedef struct _anjob
+{
+	int disp;
+	int ss;
+	int LO;
+	int type;							// batch key:  0 for real, 1 for complex
+	int size;							// batch key:  fft size
+	LARGE_INTEGER t_post;				// time the job was queued
+} anjob;
+
+typedef struct _anbatch
+{
+	int size;							// fft size the buffers currently hold
+	double *in;							// up to dAN_BATCH windowed input frames, back to back
+	fftw_complex *out;					// up to dAN_BATCH output spectra, back to back
+} anbatch;
+
+static struct _anq
+{
+	CRITICAL_SECTION cs;
+	HANDLE sem;							// wakes workers; counts are hints only, workers re-check the queue
+	anjob job[dMAX_AN_QUEUE];			// ring of waiting jobs
+	int head;
+	int count;
+	int depth;							// current limit on waiting jobs
+	int nthreads;						// requested number of workers
+	int alive[dMAX_AN_THREADS];			// worker 'i' is running
+	uint64_t affinity[dMAX_AN_THREADS];	// cpu mask for worker 'i'; 0 for no pinning
+	int update;							// incremented when an affinity changes
+	int batch;							// maximum number of jobs per batch; 1 disables batching
+	double tscale;						// milliseconds per performance-counter tick
+} anq;
+
+static volatile LONG anq_state = 0;		// 0, not initialized; 1, initializing; 2, ready
+
+static void init_anq (void)
+{
+	LARGE_INTEGER freq;
+	if (anq_state == 2) return;
+	if (InterlockedCompareExchange (&anq_state, 1, 0) == 0)
+	{
+		InitializeCriticalSectionAndSpinCount (&anq.cs, 2500);
+		anq.sem = CreateSemaphore (0, 0, 1 << 20, 0);
+		anq.depth = dAN_QUEUE;
+		anq.nthreads = dAN_THREADS;
+		anq.batch = dAN_BATCH;
+		QueryPerformanceFrequency (&freq);
+		anq.tscale = 1000.0 / (double)freq.QuadPart;
+		InterlockedExchange (&anq_state, 2);
+	}
+	else
+		while (anq_state != 2) Sleep (0);
+}
+
+static void set_an_affinity (uint64_t mask)
+{
+	if (mask == 0) return;
+#if defined(_WIN32)
+	SetThreadAffinityMask (GetCurrentThread(), (DWORD_PTR)mask);
+#else
+	linux_set_rt_thread (-1, mask);
+#endif
+}
+
+static double an_elapsed (LARGE_INTEGER *t0)
+{
+	// milliseconds since 't0'
+	LARGE_INTEGER t1;
+	QueryPerformanceCounter (&t1);
+	return (double)(t1.QuadPart - t0->QuadPart) * anq.tscale;
+}
+
+static void record_fft (DP a, double t)
+{
+	EnterCriticalSection (&a->StatsSection);
+	a->st_ffts++;
+	a->st_fft_sum += t;
+	a->st_work_sum += t;
+	if (t > a->st_fft_max) a->st_fft_max = t;
+	LeaveCriticalSection (&a->StatsSection);
+}
+
+static void record_work (DP a, double t)
+{
+	EnterCriticalSection (&a->StatsSection);
+	a->st_work_sum += t;
+	LeaveCriticalSection (&a->StatsSection);
+}
+
+static void record_wait (DP a, LARGE_INTEGER *t_post)
+{
+	double t = an_elapsed (t_post);
+	EnterCriticalSection (&a->StatsSection);
+	a->st_frames++;
+	a->st_wait_sum += t;
+	if (t > a->st_wait_max) a->st_wait_max = t;
+	LeaveCriticalSection (&a->StatsSection);
+}
+
+static void run_spectra (anjob *j)
+{
+	if (j->type == 0)
+		spectra ((void *)(((uintptr_t)j->disp << 12) + (j->ss << 4) + j->LO));
+	else
+		Cspectra ((void *)(((uintptr_t)j->disp << 12) + (j->ss << 4) + j->LO));
+}
+
+static void run_batch (anjob *job, int n, anbatch *b)
+{
+	// 'n' jobs of the same type and size, each still counted in its display's 'pnum_threads'
+	int i, k, m, c;
+	int type = job[0].type;
+	int size = job[0].size;
+	int osize = type ? size : size / 2 + 1;
+	anjob *live[dAN_BATCH];
+	LARGE_INTEGER t0;
+	double t;
+	DP a;
+
+	if (b->size < size)
+	{
+		fftw_free (b->in);
+		fftw_free (b->out);
+		b->in = (double *) fftw_malloc (dAN_BATCH * size * sizeof (complex));
+		b->out = (fftw_complex *) fftw_malloc (dAN_BATCH * size * sizeof (fftw_complex));
+		b->size = size;
+	}
+	for (i = 0, m = 0; i < n; i++)
+	{
+		a = pdisp[job[i].disp];
+		if (a->stop || job[i].ss < a->begin_ss || job[i].ss > a->end_ss)
+			run_spectra (&job[i]);		// no fft to run
+		else
+			live[m++] = &job[i];
+	}
+	for (i = 0; i < m; i += c)
+	{
+		// the largest power-of-two batch that fits, so only log2(dAN_BATCH) + 1 plans exist per size
+		for (c = dAN_BATCH; c > m - i; c >>= 1);
+		for (k = 0; k < c; k++)
+		{
+			a = pdisp[live[i + k]->disp];
+			QueryPerformanceCounter (&t0);
+			if (type == 0)
+				load_spectra (a, live[i + k]->ss, live[i + k]->LO, b->in + k * size);
+			else
+				Cload_spectra (a, live[i + k]->ss, live[i + k]->LO, (fftw_complex *)b->in + k * size);
+			record_work (a, an_elapsed (&t0));
+		}
+		QueryPerformanceCounter (&t0);
+		if (type == 0)
+			fftw_execute_dft_r2c (get_fftplan_r2c (size, c, b->in, (double *)b->out), b->in, b->out);
+		else
+			fftw_execute_dft (get_fftplan_many (size, c, FFTW_FORWARD, b->in, (double *)b->out), (fftw_complex *)b->in, b->out);
+		t = an_elapsed (&t0) / (double)c;
+		for (k = 0; k < c; k++)
+		{
+			record_fft (pdisp[live[i + k]->disp], t);
+			finish_spectra (live[i + k]->disp, live[i + k]->ss, live[i + k]->LO, b->out + k * osize);
+		}
+	}
+}
+
+static int take_anjobs (anjob *job)
+{
+	// call with anq.cs held and anq.count > 0; takes the oldest job and any batchable ones, returns the number taken
+	int r, w, n;
+	anjob *q;
+	job[0] = anq.job[anq.head];
+	if (++anq.head == dMAX_AN_QUEUE)
+		anq.head = 0;
+	anq.count--;
+	n = 1;
+	if (anq.batch > 1 && job[0].size <= dAN_BATCH_SIZE)
+	{
+		for (r = 0, w = 0; r < anq.count; r++)
+		{
+			q = &anq.job[(anq.head + r) % dMAX_AN_QUEUE];
+			if (n < anq.batch && q->type == job[0].type && q->size == job[0].size)
+				job[n++] = *q;
+			else
+			{
+				if (w != r)
+					anq.job[(anq.head + w) % dMAX_AN_QUEUE] = *q;
+				w++;
+			}
+		}
+		anq.count = w;
+	}
+	return n;
+}
+
+static void __cdecl an_worker (void *arg)
+{
+	int id = (int)(uintptr_t)arg;
+	int update = -1;
+	int i, n;
+	uint64_t mask;
+	anjob job[dAN_BATCH];
+	anbatch b = { 0 };
+	EnterCriticalSection (&anq.cs);
+	while (id < anq.nthreads)
+	{
+		if (update != anq.update)
+		{
+			update = anq.update;
+			mask = anq.affinity[id];
+			LeaveCriticalSection (&anq.cs);
+			set_an_affinity (mask);
+			EnterCriticalSection (&anq.cs);
+			continue;
+		}
+		if (anq.count == 0)
+		{
+			LeaveCriticalSection (&anq.cs);
+			WaitForSingleObject (anq.sem, INFINITE);
+			EnterCriticalSection (&anq.cs);
+			continue;
+		}
+		n = take_anjobs (job);
+		LeaveCriticalSection (&anq.cs);
+		// a display is not destroyed while its jobs are counted in 'pnum_threads'
+		for (i = 0; i < n; i++)
+			record_wait (pdisp[job[i].disp], &job[i].t_post);
+		if (n == 1)
+			run_spectra (&job[0]);
+		else
+			run_batch (job, n, &b);
+		EnterCriticalSection (&anq.cs);
+	}
+	anq.alive[id] = 0;
+	LeaveCriticalSection (&anq.cs);
+	fftw_free (b.in);
+	fftw_free (b.out);
+	_endthread ();
+}
+
+static int start_an_workers (void)
+{
+	// call with anq.cs held; returns the number of workers alive
+	int i, nalive = 0;
+	for (i = 0; i < dMAX_AN_THREADS; i++)
+	{
+		if (i < anq.nthreads && !anq.alive[i])
+		{
+			anq.alive[i] = 1;
+			if (_beginthread (an_worker, 0, (void *)(uintptr_t)i) == (uintptr_t)-1L)
+				anq.alive[i] = 0;
+		}
+		nalive += anq.alive[i];
+	}
+	return nalive;
+}
+
+static int post_spectra (int disp, int ss, int LO)
+{
+	// returns 0 if the queue is full or no worker can be started
+	anjob* j;
+	EnterCriticalSection (&anq.cs);
+	if (anq.count >= anq.depth)
+	{
+		LeaveCriticalSection (&anq.cs);
+		return 0;
+	}
+	j = &anq.job[(anq.head + anq.count) % dMAX_AN_QUEUE];
+	j->disp = disp;
+	j->ss = ss;
+	j->LO = LO;
+	j->type = pdisp[disp]->type;
+	j->size = pdisp[disp]->size;
+	QueryPerformanceCounter (&j->t_post);
+	anq.count++;
+	if (start_an_workers () == 0)
+	{
+		// no worker could be started:  withdraw the job, it is dropped like one that found the queue full
+		anq.count--;
+		LeaveCriticalSection (&anq.cs);
+		return 0;
+	}
+	LeaveCriticalSection (&anq.cs);
+	ReleaseSemaphore (anq.sem, 1, 0);
+	return 1;
+}
+
+static void dispatch_spectra (int disp)
+{
+	DP a = pdisp[disp];
+	int ss, LO;
+	EnterCriticalSection(&a->DispatchSection);
+	if (!a->end_dispatcher)
+	{
+		for (ss = 0; ss < a->num_stitch; ss++)
+			for (LO = 0; LO < a->num_fft; LO++)
+			{
+				if (!_InterlockedAnd(&(a->input_busy[ss][LO]), 1) && _InterlockedAnd(&(a->buff_ready[ss][LO]), 1))
+				{
+					InterlockedBitTestAndSet(&(a->input_busy[ss][LO]), 0);
+
+					a->IQO_idx[ss][LO] = a->IQout_index[ss][LO];
+					QueryPerformanceCounter (&a->t_in[ss][LO]);
+
+					InterlockedIncrement(a->pnum_threads);
+					if (!post_spectra(disp, ss, LO))
+					{
+						// queue full:  skip this frame's samples as if they had been processed
+						InterlockedDecrement(a->pnum_threads);
+						InterlockedBitTestAndReset(&(a->input_busy[ss][LO]), 0);
+						EnterCriticalSection(&a->StatsSection);
+						a->st_dropped++;
+						LeaveCriticalSection(&a->StatsSection);
+					}
+
+					if ((a->IQout_index[ss][LO] += a->incr) >= a->bsize)
+						a->IQout_index[ss][LO] -= a->bsize;
+
+					EnterCriticalSection(&(a->BufferControlSection[ss][LO]));
+					if ((a->have_samples[ss][LO] -= a->incr) < a->size)
+						InterlockedBitTestAndReset(&(a->buff_ready[ss][LO]), 0);
+					LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
+				}
+			}
+	}
+	LeaveCriticalSection(&a->DispatchSection);
 }
 
-int build_interpolants(int disp, int set, int n, int m, double *x, double (*y)[dMAX_M])
+static void suspend_dispatch (DP a)
+{
+	// stop dispatching and wait until every queued or running fft job for this display has returned
+	EnterCriticalSection(&a->DispatchSection);
+	a->end_dispatcher = 1;
+	LeaveCriticalSection(&a->DispatchSection);
+	a->stop = 1;
+	while (_InterlockedAnd(a->pnum_threads, 1023))
+		Sleep(1);
+}
+
+int analyzer_idle (int disp)
 {
+	// 1 if no fft job of this display is queued or running and no input buffer waits to be dispatched
 	DP a = pdisp[disp];
-	double dx[dMAX_N];
-	double idx[dMAX_N];
-	double dmain[dMAX_N];
-	double dsub[dMAX_N];
-	double dsup[dMAX_N];
-	double d[dMAX_N][dMAX_M];
-	double S[dMAX_N][dMAX_M];
-	double b[dMAX_N];
-	double v[dMAX_N][dMAX_M];
-	double tmp;
-	int i, j;
-	if (n < 3) return -1;
-    for (i = 0; i < n - 1; i++)
-    {
-        dx[i] = x[i + 1] - x[i];
+	int ss, LO;
+	if (_InterlockedAnd(a->pnum_threads, 1023))
+		return 0;
+	for (ss = 0; ss < a->num_stitch; ss++)
+		for (LO = 0; LO < a->num_fft; LO++)
+			if (_InterlockedAnd(&(a->buff_ready[ss][LO]), 1))
+				return 0;
+	return 1;
+}
 
-        if (dx[i] < 1e-30)
-            return -1;
-        idx[i] = 1.0 / dx[i];
-    }
+PORT
+void SetAnalyzerThreads (int nthreads)
+{
+	// surplus workers exit once the queue has been drained by the remaining ones
+	init_anq ();
+	if (nthreads < 1) nthreads = 1;
+	if (nthreads > dMAX_AN_THREADS) nthreads = dMAX_AN_THREADS;
+	EnterCriticalSection (&anq.cs);
+	anq.nthreads = nthreads;
+	start_an_workers ();
+	LeaveCriticalSection (&anq.cs);
+	ReleaseSemaphore (anq.sem, dMAX_AN_THREADS, 0);
+}
 
-    for (i = 1; i <= n - 2; i++)
-    {
-        if (i == 1)
-        {
-            dsub[i] = 0.0;
-            dmain[i] = 3.0 * dx[i - 1] + 2.0 * dx[i];
-            dsup[i] = dx[i];
-        }
-        else if (i == (n - 2))
-        {
-            dsub[i] = dx[i - 1];
-            dmain[i] = 2.0 * dx[i - 1] + 3.0 * dx[i];
-            dsup[i] = 0.0;
-        }
-        else
-        {
-            dsub[i] = dx[i - 1];
-            dmain[i] = 2.0 * (dx[i - 1] + dx[i]);
-            dsup[i] = dx[i];
-        }
-		for (j = 0; j < m; j++)
-            d[i][j] = 6.0 * ((y[i + 1][j] - y[i][j]) * idx[i] - (y[i][j] - y[i - 1][j]) * idx[i - 1]);
-    }
+PORT
+void SetAnalyzerThreadAffinity (int thread, uint64_t mask)
+{
+	// mask:  bit-mask of cpus worker 'thread' may run on; 0 leaves the current affinity unchanged
+	init_anq ();
+	if (thread < 0 || thread >= dMAX_AN_THREADS) return;
+	EnterCriticalSection (&anq.cs);
+	anq.affinity[thread] = mask;
+	anq.update++;
+	LeaveCriticalSection (&anq.cs);
+	ReleaseSemaphore (anq.sem, dMAX_AN_THREADS, 0);
+}
 
-    b[1] = dmain[1];
-    for (j = 0; j < m; j++)
-        v[1][j] = d[1][j];
+PORT
+void SetAnalyzerQueueDepth (int depth)
+{
+	init_anq ();
+	if (depth < 1) depth = 1;
+	if (depth > dMAX_AN_QUEUE) depth = dMAX_AN_QUEUE;
+	EnterCriticalSection (&anq.cs);
+	anq.depth = depth;
+	LeaveCriticalSection (&anq.cs);
+}
 
-    for (i = 2; i <= n - 2; i++)
-    {
-        tmp = dsub[i] / b[i - 1];
-        b[i] = dmain[i] - tmp * dsup[i - 1];
-        for (j = 0; j < m; j++)
-            v[i][j] = d[i][j] - tmp * v[i - 1][j];
-    }
+PORT
+void SetAnalyzerBatch (int batch)
+{
+	// maximum number of same-size ffts a worker runs as one batch; 1 runs every fft on its own
+	init_anq ();
+	if (batch < 1) batch = 1;
+	if (batch > dAN_BATCH) batch = dAN_BATCH;
+	EnterCriticalSection (&anq.cs);
+	anq.batch = batch;
+	LeaveCriticalSection (&anq.cs);
+}
 
-    for (j = 0; j < m; j++)
-        S[n - 2][j] = v[n - 2][j] / b[n - 2];
+PORT
+void GetAnalyzerStats (	int disp,
+						int *frames,		// fft jobs run since the last reset
+						int *dropped,		// frames dropped because the queue was full
+						double *avg_wait,	// average and maximum time a job waited for a worker, milliseconds
+						double *max_wait,
+						double *avg_fft,	// average and maximum fft execution time, milliseconds
+						double *max_fft)
+{
+	DP a = pdisp[disp];
+	EnterCriticalSection (&a->StatsSection);
+	*frames = a->st_frames;
+	*dropped = a->st_dropped;
+	*avg_wait = a->st_frames ? a->st_wait_sum / (double)a->st_frames : 0.0;
+	*max_wait = a->st_wait_max;
+	*avg_fft = a->st_ffts ? a->st_fft_sum / (double)a->st_ffts : 0.0;
+	*max_fft = a->st_fft_max;
+	LeaveCriticalSection (&a->StatsSection);
+}
 
-    for (i = n - 3; i >= 1; i--)
-        for (j = 0; j < m; j++)
-            S[i][j] = (v[i][j] - dsup[i] * S[i + 1][j]) / b[i];
+PORT
+void ResetAnalyzerStats (int disp)
+{
+	DP a = pdisp[disp];
+	EnterCriticalSection (&a->StatsSection);
+	a->st_frames = 0;
+	a->st_dropped = 0;
+	a->st_ffts = 0;
+	a->st_wait_sum = 0.0;
+	a->st_wait_max = 0.0;
+	a->st_fft_sum = 0.0;
+	a->st_fft_max = 0.0;
+	a->st_work_sum = 0.0;
+	LeaveCriticalSection (&a->StatsSection);
+}
 
-    for (j = 0; j < m; j++)
-    {
-        S[0][j] = S[1][j];
-        S[n - 1][j] = S[n - 2][j];
-    }
+PORT
+double GetAnalyzerWorkTime (int disp)
+{
+	// worker time spent on this display since the last reset, milliseconds:  windowing, fft (a batched
+	// fft is shared equally among its frames), detection, averaging and publication
+	DP a = pdisp[disp];
+	double t;
+	EnterCriticalSection (&a->StatsSection);
+	t = a->st_work_sum;
+	LeaveCriticalSection (&a->StatsSection);
+	return t;
+}
 
-    for (i = 0; i < n - 1; i++)
-        for (j = 0; j < m; j++)
-        {
-            (a->ac3[set][j])[i] = (S[i + 1][j] - S[i][j]) / (6.0 * dx[i]);
-            (a->ac2[set][j])[i] = 0.5 * S[i][j];
-            (a->ac1[set][j])[i] = (y[i + 1][j] - y[i][j]) * idx[i] - (2.0 * dx[i] * S[i][j] + dx[i] * S[i + 1][j]) / 6.0;
-            (a->ac0[set][j])[i] = y[i][j];
-        }
-    return 0;
+/********************************************************************************************************
+*																										*
+*											Zoom Front End												*
+*																										*
+********************************************************************************************************/
+
+// With zoom on, each complex input stream passes through its own ZOOM before it reaches the sample ring, so
+// the ring, the ffts and all the bin arithmetic run at the decimated rate.  The caller sizes the span for
+// that rate:  sample rate (for normalization) is zoom_rate / zoom_decim, and fsclipL / fsclipH should remove
+// at least the outer 12.5% of the bins on each side.  Real (type 0) displays are not zoomed.
+
+static void build_zoom (DP a)
+{
+	// call with SetAnalyzerSection held and dispatch suspended
+	int i, j;
+	for (i = 0; i < dMAX_STITCH; i++)
+		for (j = 0; j < dMAX_NUM_FFT; j++)
+			if (a->zoom[i][j])
+			{
+				destroy_zoom (a->zoom[i][j]);
+				a->zoom[i][j] = NULL;
+			}
+	if (a->zoom_run && a->type == 1 && a->buff_size > 0)
+		for (i = 0; i < a->max_stitch; i++)
+			for (j = 0; j < a->max_num_fft; j++)
+				a->zoom[i][j] = create_zoom (a->buff_size, a->zoom_rate, a->zoom_freq, a->zoom_decim);
 }
 
-void __cdecl sendbuf(void *arg)
+static void zoom_samples (DP a, int ss, int LO)
 {
-	DP a = pdisp[(int)(uintptr_t)arg];
-	while(!a->end_dispatcher)
+	// call with SetAnalyzerSection held; decimates zoom->in into the sample ring
+	int i, n;
+	double* out;
+	int idx = a->IQin_index[ss][LO];
+	n = xzoom (a->zoom[ss][LO], &out);
+	for (i = 0; i < n; i++)
 	{
-		for (a->ss = 0; a->ss < a->num_stitch; a->ss++)
-			for (a->LO = 0; a->LO < a->num_fft; a->LO++)
+		a->I_samples[ss][LO][idx] = (dINREAL)out[2 * i + 0];
+		a->Q_samples[ss][LO][idx] = (dINREAL)out[2 * i + 1];
+		if (++idx >= a->bsize)
+			idx = 0;
+	}
+	EnterCriticalSection(&(a->BufferControlSection[ss][LO]));
+		if (a->have_samples[ss][LO] > a->max_writeahead)
 			{
-				if (!_InterlockedAnd(&(a->input_busy[a->ss][a->LO]), 1) && _InterlockedAnd(&(a->buff_ready[a->ss][a->LO]), 1))
-				{
-					InterlockedBitTestAndSet(&(a->input_busy[a->ss][a->LO]), 0);
-
-					a->IQO_idx[a->ss][a->LO] = a->IQout_index[a->ss][a->LO];
-					
-					InterlockedIncrement(a->pnum_threads);
-					if (a->type == 0)
-						QueueUserWorkItem(spectra, (void *)(((uintptr_t)arg << 12) + (a->ss << 4) + a->LO), 0);
-					else
-						QueueUserWorkItem(Cspectra, (void *)(((uintptr_t)arg << 12) + (a->ss << 4) + a->LO), 0);
-
-					if((a->IQout_index[a->ss][a->LO] += a->incr) >= a->bsize)
-						a->IQout_index[a->ss][a->LO] -= a->bsize;
-
-					EnterCriticalSection(&(a->BufferControlSection[a->ss][a->LO]));
-					if ((a->have_samples[a->ss][a->LO] -= a->incr) < a->size)
-						InterlockedBitTestAndReset(&(a->buff_ready[a->ss][a->LO]), 0);
-					LeaveCriticalSection(&(a->BufferControlSection[a->ss][a->LO]));
-				}
+				//if we're receiving samples too much faster than we're consuming them, skip some
+				if ((a->IQout_index[ss][LO] += a->have_samples[ss][LO] - a->max_writeahead) >= a->bsize)
+					a->IQout_index[ss][LO] -= a->bsize;
+				a->have_samples[ss][LO] = a->max_writeahead;
 			}
-		Sleep(1);
+		if ((a->have_samples[ss][LO] += n) >= a->size)
+			InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0);
+	LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
+	a->IQin_index[ss][LO] = idx;
+}
+
+PORT
+void SetAnalyzerZoom (	int disp,
+						int run,			// 1 to zoom, 0 to pass the input straight to the fft
+						int decim,			// decimation; rounded up to a power of two, 2 to ZOOM_MAX_DECIM
+						double rate,		// input sample rate
+						double freq			// input frequency, relative to the centre of the input, to zoom in on
+					)
+{
+	DP a = pdisp[disp];
+	int i, j;
+	EnterCriticalSection(&a->SetAnalyzerSection);
+	suspend_dispatch(a);
+	a->zoom_run = run;
+	a->zoom_decim = decim;
+	a->zoom_rate = rate;
+	a->zoom_freq = freq;
+	build_zoom(a);
+	// the ring holds samples at the old rate
+	for (i = 0; i < dMAX_STITCH; i++)
+	{
+		a->spec_flag[i] = 0;
+		for (j = 0; j < dMAX_NUM_FFT; j++)
+		{
+			a->input_busy[i][j] = 0;
+			a->buff_ready[i][j] = 0;
+			a->have_samples[i][j] = 0;
+			a->IQin_index[i][j] = 0;
+			a->IQout_index[i][j] = 0;
+		}
 	}
-	InterlockedBitTestAndReset(&a->dispatcher, 0);
-	_endthread();
+	a->stitch_flag = 0;
+	a->stop = 0;
+	EnterCriticalSection(&a->DispatchSection);
+	a->end_dispatcher = 0;
+	LeaveCriticalSection(&a->DispatchSection);
+	LeaveCriticalSection(&a->SetAnalyzerSection);
+}
+
+PORT
+void SetAnalyzerZoomFreq (int disp, double freq)
+{
+	// retunes the zoom without disturbing the decimator history
+	DP a = pdisp[disp];
+	int i, j;
+	EnterCriticalSection(&a->SetAnalyzerSection);
+	a->zoom_freq = freq;
+	for (i = 0; i < dMAX_STITCH; i++)
+		for (j = 0; j < dMAX_NUM_FFT; j++)
+			if (a->zoom[i][j])
+				setFreq_zoom (a->zoom[i][j], freq);
+	LeaveCriticalSection(&a->SetAnalyzerSection);
 }
 
 void CalcBandwidthNormalization (DP a)
@@ -1136,13 +1775,7 @@ void ResetPixelBuffers(int disp)
 		a->avail_frames[i] = 0;
 		a->av_in_idx[i] = 0;
 		a->av_out_idx[i] = 0;
-		EnterCriticalSection(&a->PB_ControlsSection[i]);
-		a->w_pix_buff[i] = 0;
-		a->r_pix_buff[i] = 0;
-		a->last_pix_buff[i] = 0;
-		for (j = 0; j < dNUM_PIXEL_BUFFS; j++)
-			a->pb_ready[i][j] = 0;
-		LeaveCriticalSection(&a->PB_ControlsSection[i]);
+		discard_pixels (a, i);
 	}
 	memset((void*)a->pre_av_out, 0, sizeof(double) * a->max_size * a->max_stitch);
 	LeaveCriticalSection(&a->ResampleSection);
@@ -1153,8 +1786,6 @@ void ResetPixelBuffers(int disp)
 	for (i = 0; i < dMAX_STITCH; i++)
 		a->spec_flag[i] = 0;
 	a->stitch_flag = 0;
-	a->ss = 0;
-	a->LO = 0;
 	for (i = 0; i < dMAX_STITCH; i++)
 		for (j = 0; j < dMAX_NUM_FFT; j++)
 		{
@@ -1195,12 +1826,7 @@ void SetAnalyzer (	int disp,			// display identifier
 	int i, j;
 
 	EnterCriticalSection(&a->SetAnalyzerSection);
-	a->end_dispatcher = 1;
-	while (InterlockedAnd(&a->dispatcher, 1))
-		Sleep(1);
-	a->stop = 1;
-	while (_InterlockedAnd(a->pnum_threads, 1023))
-		Sleep(1);
+	suspend_dispatch(a);
 	a->num_pixout = n_pixout;
 	a->num_fft = n_fft;
 	a->type = typ;
@@ -1218,10 +1844,9 @@ void SetAnalyzer (	int disp,			// display identifier
 		for (i = 0; i < a->max_stitch; i++)
 			for (j = 0; j < a->max_num_fft; j++)
 			{
-				if (a->plan[i][j])		fftw_destroy_plan (a->plan[i][j]);
-				if (a->Cplan[i][j])		fftw_destroy_plan (a->Cplan[i][j]);
-				a->plan[i][j] = fftw_plan_dft_r2c_1d(sz, a->fft_in[i][j], a->fft_out[i][j], FFTW_PATIENT);
-				a->Cplan[i][j] = fftw_plan_dft_1d(sz, a->Cfft_in[i][j], a->fft_out[i][j], FFTW_FORWARD, FFTW_PATIENT);
+				// shared with every other display of this size (see fftplan.c), not owned
+				a->plan[i][j] = get_fftplan_r2c(sz, 1, a->fft_in[i][j], (double *)a->fft_out[i][j]);
+				a->Cplan[i][j] = get_fftplan(sz, FFTW_FORWARD, (double *)a->Cfft_in[i][j], (double *)a->fft_out[i][j]);
 			}
 
 		// Setup DetectMaxBin for a 'size' change.
@@ -1292,15 +1917,8 @@ void SetAnalyzer (	int disp,			// display identifier
 		a->spec_flag[i] = 0;
 	a->stitch_flag = 0;
 	for (i = 0; i < dMAX_PIXOUTS; i++)
-	{
-		a->w_pix_buff[i] = 0;
-		a->r_pix_buff[i] = 0;
-		a->last_pix_buff[i] = 0;
-		for (j = 0; j < dNUM_PIXEL_BUFFS; j++)
-			a->pb_ready[i][j] = 0;
-	}
-	a->ss = 0;
-	a->LO = 0;
+		discard_pixels (a, i);
+	build_zoom(a);
 	for (i = 0; i < dMAX_STITCH; i++)
 		for (j = 0; j < dMAX_NUM_FFT; j++)
 		{
@@ -1311,7 +1929,9 @@ void SetAnalyzer (	int disp,			// display identifier
 		}
 
 	a->stop = 0;
+	EnterCriticalSection(&a->DispatchSection);
 	a->end_dispatcher = 0;
+	LeaveCriticalSection(&a->DispatchSection);
 	LeaveCriticalSection(&a->SetAnalyzerSection);
 }
 
@@ -1344,8 +1964,15 @@ void XCreateAnalyzer(	int disp,
 	InitializeCriticalSectionAndSpinCount(&a->ResampleSection, 0);
 	InitializeCriticalSectionAndSpinCount(&a->SetAnalyzerSection, 0);
 	InitializeCriticalSectionAndSpinCount(&a->StitchSection, 0);
+	InitializeCriticalSectionAndSpinCount(&a->DispatchSection, 0);
+	InitializeCriticalSectionAndSpinCount(&a->StatsSection, 0);
+	init_anq();
 	for (i = 0; i < dMAX_PIXOUTS; i++)
-		InitializeCriticalSectionAndSpinCount(&a->PB_ControlsSection[i], 0);
+	{
+		a->w_pix_buff[i] = 0;
+		a->r_pix_buff[i] = 1;
+		a->pb_state[i] = 2;
+	}
 	for (i = 0; i < dMAX_STITCH; i++)
 	{
 		InitializeCriticalSectionAndSpinCount(&(a->EliminateSection[i]), 0);
@@ -1427,10 +2054,10 @@ void DestroyAnalyzer(int disp)
 	DP a = pdisp[disp];
 	int i, j;
 
-	a->end_dispatcher = 1;
-	while (InterlockedAnd(&a->dispatcher, 1))
-		Sleep(1);
+	suspend_dispatch(a);
 
+	a->zoom_run = 0;
+	build_zoom(a);
 	for (i = 0; i < a->max_stitch; i++)
 		for (j = 0; j < a->max_num_fft; j++)
 		{
@@ -1465,8 +2092,6 @@ void DestroyAnalyzer(int disp)
 	for (i = 0; i < a->max_stitch; i++)
 		for (j = 0; j < a->max_num_fft; j++)
 		{
-			fftw_destroy_plan (a->plan[i][j]);
-			fftw_destroy_plan (a->Cplan[i][j]);
 			fftw_free (a->Cfft_in[i][j]);
 			_aligned_free (a->fft_in[i][j]);
 			fftw_free (a->fft_out[i][j]);
@@ -1482,9 +2107,9 @@ void DestroyAnalyzer(int disp)
 		for (j = 0; j < dMAX_NUM_FFT; j++)
 			DeleteCriticalSection(&(a->BufferControlSection[i][j]));
 	}
-	for (i = 0; i < dMAX_PIXOUTS; i++)
-		DeleteCriticalSection(&a->PB_ControlsSection[i]);
 	DeleteCriticalSection(&a->StitchSection);
+	DeleteCriticalSection(&a->DispatchSection);
+	DeleteCriticalSection(&a->StatsSection);
 	DeleteCriticalSection(&a->SetAnalyzerSection);
 	DeleteCriticalSection(&a->ResampleSection);
 
@@ -1509,20 +2134,50 @@ void GetPixels	(	int disp,
 				)
 {
 	DP a = pdisp[disp];
-	EnterCriticalSection(&a->PB_ControlsSection[pixout]);
-		a->r_pix_buff[pixout] = a->last_pix_buff[pixout];
-	LeaveCriticalSection(&a->PB_ControlsSection[pixout]);
-
-	if (_InterlockedAnd(&(a->pb_ready[pixout][a->r_pix_buff[pixout]]), 1))
+	int r;
+	if (take_pixels (a, pixout))
 	{
-		memcpy (pix, a->pixels[pixout][a->r_pix_buff[pixout]], a->num_pixels * sizeof(dOUTREAL));
+		r = a->r_pix_buff[pixout];
+		memcpy (pix, a->pixels[pixout][r], a->pb_npix[pixout][r] * sizeof(dOUTREAL));
 		*flag = 1;
-		InterlockedBitTestAndReset(&(a->pb_ready[pixout][a->r_pix_buff[pixout]]), 0);
 	}
 	else
 		*flag = 0;
 }
 
+PORT
+void GetPixelsDirect (	int disp,
+						int pixout,
+						const dOUTREAL **pix,	// read-only pointer to the newest frame taken by the reader
+						int *num_pixels,		// number of pixels in that frame
+						uint64_t *seq,			// frame sequence number; a gap from the previous call counts skipped frames
+						double *timestamp,		// publication time, milliseconds on the QueryPerformanceCounter clock
+						int *flag				// 1 if the frame is new since the last call, else 0 (same frame as before)
+					)
+{
+	// Zero-copy alternative to GetPixels().  The frame stays valid and unchanged until the next call to
+	// GetPixels() or GetPixelsDirect() for this output; the two must not be called concurrently for the
+	// same output.  seq is 0 until the first frame is taken.
+	DP a = pdisp[disp];
+	int r;
+	*flag = take_pixels (a, pixout);
+	r = a->r_pix_buff[pixout];
+	*pix = a->pixels[pixout][r];
+	*num_pixels = a->pb_npix[pixout][r];
+	*seq = a->pb_frame[pixout][r];
+	*timestamp = (double)a->pb_time[pixout][r].QuadPart * anq.tscale;
+}
+
+PORT
+double GetPixelsLatency (int disp, int pixout)
+{
+	// For the frame last taken by GetPixels() or GetPixelsDirect():  milliseconds from the dispatch of its
+	// newest input to its publication.  Call from the reader.
+	DP a = pdisp[disp];
+	int r = a->r_pix_buff[pixout];
+	return (double)(a->pb_time[pixout][r].QuadPart - a->pb_in[pixout][r].QuadPart) * anq.tscale;
+}
+
 PORT
 void SnapSpectrum(	int disp,
 					int ss,
@@ -1603,8 +2258,16 @@ void OpenBuffer(int disp, int ss, int LO, void **Ipointer, void **Qpointer)
 {
 	DP a = pdisp[disp];
 	EnterCriticalSection(&a->SetAnalyzerSection);
-	*Ipointer = &((a->I_samples[ss][LO])[a->IQin_index[ss][LO]]);
-	*Qpointer = &((a->Q_samples[ss][LO])[a->IQin_index[ss][LO]]);
+	if (a->zoom[ss][LO])
+	{
+		*Ipointer = a->zoom[ss][LO]->Ibuff;
+		*Qpointer = a->zoom[ss][LO]->Qbuff;
+	}
+	else
+	{
+		*Ipointer = &((a->I_samples[ss][LO])[a->IQin_index[ss][LO]]);
+		*Qpointer = &((a->Q_samples[ss][LO])[a->IQin_index[ss][LO]]);
+	}
 	LeaveCriticalSection(&a->SetAnalyzerSection);
 }
 
@@ -1612,7 +2275,21 @@ PORT
 void CloseBuffer(int disp, int ss, int LO)
 {
 	DP a = pdisp[disp];
+	ZOOM z;
+	int i;
 	EnterCriticalSection(&a->SetAnalyzerSection);
+	if ((z = a->zoom[ss][LO]) != NULL)
+	{
+		for (i = 0; i < a->buff_size; i++)
+		{
+			z->in[2 * i + 0] = (double)z->Ibuff[i];
+			z->in[2 * i + 1] = (double)z->Qbuff[i];
+		}
+		zoom_samples(a, ss, LO);
+		LeaveCriticalSection(&a->SetAnalyzerSection);
+		dispatch_spectra(disp);
+		return;
+	}
 	EnterCriticalSection(&(a->BufferControlSection[ss][LO]));
 		if (a->have_samples[ss][LO] > a->max_writeahead)
 			{
@@ -1626,15 +2303,8 @@ void CloseBuffer(int disp, int ss, int LO)
 	LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
 	if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize)	//REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
 		a->IQin_index[ss][LO] = 0;
-
-	if (!InterlockedAnd(&a->dispatcher, 1))
-	{
-		InterlockedBitTestAndSet (&a->dispatcher, 0);
-		LeaveCriticalSection(&a->SetAnalyzerSection);
-		_beginthread(sendbuf, 0, (void *)(uintptr_t)disp);
-	}
-	else
-		LeaveCriticalSection(&a->SetAnalyzerSection);
+	LeaveCriticalSection(&a->SetAnalyzerSection);
+	dispatch_spectra(disp);
 }
 
 PORT
@@ -1643,7 +2313,21 @@ void Spectrum(int disp, int ss, int LO, dINREAL* pI, dINREAL* pQ)
 	dINREAL *Ipointer;
 	dINREAL *Qpointer;
 	DP a = pdisp[disp];
+	ZOOM z;
+	int i;
 	EnterCriticalSection(&a->SetAnalyzerSection);
+	if ((z = a->zoom[ss][LO]) != NULL)
+	{
+		for (i = 0; i < a->buff_size; i++)
+		{
+			z->in[2 * i + 0] = (double)pI[i];
+			z->in[2 * i + 1] = (double)pQ[i];
+		}
+		zoom_samples(a, ss, LO);
+		LeaveCriticalSection(&a->SetAnalyzerSection);
+		dispatch_spectra(disp);
+		return;
+	}
 	Ipointer = &((a->I_samples[ss][LO])[a->IQin_index[ss][LO]]);
 	Qpointer = &((a->Q_samples[ss][LO])[a->IQin_index[ss][LO]]);
 	LeaveCriticalSection(&a->SetAnalyzerSection);
@@ -1665,15 +2349,8 @@ void Spectrum(int disp, int ss, int LO, dINREAL* pI, dINREAL* pQ)
 	LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
 	if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize)	//REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
 		a->IQin_index[ss][LO] = 0;
-
-	if (!InterlockedAnd(&a->dispatcher, 1))
-	{
-		InterlockedBitTestAndSet(&a->dispatcher, 0);
-		LeaveCriticalSection(&a->SetAnalyzerSection);
-		_beginthread(sendbuf, 0, (void *)(uintptr_t)disp);
-	}
-	else
-		LeaveCriticalSection(&a->SetAnalyzerSection);
+	LeaveCriticalSection(&a->SetAnalyzerSection);
+	dispatch_spectra(disp);
 }
 
 PORT
@@ -1685,7 +2362,20 @@ void Spectrum2(int run, int disp, int ss, int LO, dINREAL* pbuff)
 		dINREAL *Ipointer;
 		dINREAL *Qpointer;
 		DP a = pdisp[disp];
+		ZOOM z;
 		EnterCriticalSection(&a->SetAnalyzerSection);
+		if ((z = a->zoom[ss][LO]) != NULL)
+		{
+			for (i = 0; i < a->buff_size; i++)
+			{
+				z->in[2 * i + 0] = (double)pbuff[2 * i + 1];
+				z->in[2 * i + 1] = (double)pbuff[2 * i + 0];
+			}
+			zoom_samples(a, ss, LO);
+			LeaveCriticalSection(&a->SetAnalyzerSection);
+			dispatch_spectra(disp);
+			return;
+		}
 		Ipointer = &((a->I_samples[ss][LO])[a->IQin_index[ss][LO]]);
 		Qpointer = &((a->Q_samples[ss][LO])[a->IQin_index[ss][LO]]);
 		LeaveCriticalSection(&a->SetAnalyzerSection);
@@ -1710,15 +2400,8 @@ void Spectrum2(int run, int disp, int ss, int LO, dINREAL* pbuff)
 		LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
 		if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize)	//REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
 			a->IQin_index[ss][LO] = 0;
-
-		if (!InterlockedAnd(&a->dispatcher, 1))
-		{
-			InterlockedBitTestAndSet(&a->dispatcher, 0);
-			LeaveCriticalSection(&a->SetAnalyzerSection);
-			_beginthread(sendbuf, 0, (void *)(uintptr_t)disp);
-		}
-		else
-			LeaveCriticalSection(&a->SetAnalyzerSection);
+		LeaveCriticalSection(&a->SetAnalyzerSection);
+		dispatch_spectra(disp);
 	}
 }
 
@@ -1731,7 +2414,20 @@ void Spectrum0(int run, int disp, int ss, int LO, double* pbuff)
 		dINREAL *Ipointer;
 		dINREAL *Qpointer;
 		DP a = pdisp[disp];
+		ZOOM z;
 		EnterCriticalSection(&a->SetAnalyzerSection);
+		if ((z = a->zoom[ss][LO]) != NULL)
+		{
+			for (i = 0; i < a->buff_size; i++)
+			{
+				z->in[2 * i + 0] = (double)pbuff[2 * i + 1];
+				z->in[2 * i + 1] = (double)pbuff[2 * i + 0];
+			}
+			zoom_samples(a, ss, LO);
+			LeaveCriticalSection(&a->SetAnalyzerSection);
+			dispatch_spectra(disp);
+			return;
+		}
 		Ipointer = &((a->I_samples[ss][LO])[a->IQin_index[ss][LO]]);
 		Qpointer = &((a->Q_samples[ss][LO])[a->IQin_index[ss][LO]]);
 		LeaveCriticalSection(&a->SetAnalyzerSection);
@@ -1756,15 +2452,8 @@ void Spectrum0(int run, int disp, int ss, int LO, double* pbuff)
 		LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
 		if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize)	//REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
 			a->IQin_index[ss][LO] = 0;
-
-		if (!InterlockedAnd(&a->dispatcher, 1))
-		{
-			InterlockedBitTestAndSet(&a->dispatcher, 0);
-			LeaveCriticalSection(&a->SetAnalyzerSection);
-			_beginthread(sendbuf, 0, (void *)(uintptr_t)disp);
-		}
-		else
-			LeaveCriticalSection(&a->SetAnalyzerSection);
+		LeaveCriticalSection(&a->SetAnalyzerSection);
+		dispatch_spectra(disp);
 	}
 }
 
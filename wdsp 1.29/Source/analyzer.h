@@ -73,8 +73,13 @@ typedef struct _dp
 	double *t_pixels[dMAX_PIXOUTS];							// pointer to temporary pixel buffer									//pointer to temporary pixel buffer for non-averaged data
 	int w_pix_buff[dMAX_PIXOUTS];							// number of pixel buffer owned by writing process
 	int r_pix_buff[dMAX_PIXOUTS];							// number of pixel buffer owned by reading process
-	int last_pix_buff[dMAX_PIXOUTS];						// number of the last pixel buffer written
-	volatile LONG pb_ready[dMAX_PIXOUTS][dNUM_PIXEL_BUFFS];	// if value is 0, this data has already been read; 1 = fresh data to read
+	volatile LONG pb_state[dMAX_PIXOUTS];					// published pixel buffer in bits 0-1; PB_FRESH set until it is taken by the reader
+	uint64_t pb_seq[dMAX_PIXOUTS];							// number of frames published
+	uint64_t pb_frame[dMAX_PIXOUTS][dNUM_PIXEL_BUFFS];		// sequence number of the frame held in each pixel buffer
+	LARGE_INTEGER pb_time[dMAX_PIXOUTS][dNUM_PIXEL_BUFFS];	// performance counter at publication of each pixel buffer
+	int pb_npix[dMAX_PIXOUTS][dNUM_PIXEL_BUFFS];			// number of pixels in each pixel buffer
+	LARGE_INTEGER pb_in[dMAX_PIXOUTS][dNUM_PIXEL_BUFFS];	// dispatch time of the newest input of the frame in each pixel buffer
+	LARGE_INTEGER t_in[dMAX_STITCH][dMAX_NUM_FFT];			// dispatch time of the frame in flight for each input stream
 	int num_average[dMAX_PIXOUTS];							// number of spans to average to create the pixels
 	int avail_frames[dMAX_PIXOUTS];							// number of pixel frames currently available to average
 	int av_in_idx[dMAX_PIXOUTS];							// input index in averaging pixel buffer ring
@@ -92,17 +97,15 @@ typedef struct _dp
 	double (*ac1[dMAX_CAL_SETS][dMAX_M]);
 	double (*ac0[dMAX_CAL_SETS][dMAX_M]);
 
-	fftw_plan plan[dMAX_STITCH][dMAX_NUM_FFT];				// fftw plans
+	fftw_plan plan[dMAX_STITCH][dMAX_NUM_FFT];				// fftw plans, shared (see fftplan.c), not owned
 	fftw_plan Cplan[dMAX_STITCH][dMAX_NUM_FFT];
 	double *fft_in[dMAX_STITCH][dMAX_NUM_FFT];				// pointers to fftw real input vectors
 	fftw_complex *Cfft_in[dMAX_STITCH][dMAX_NUM_FFT];		// pointers to fftw complex input vectors
 	fftw_complex *fft_out[dMAX_STITCH][dMAX_NUM_FFT];		// pointers to fftw complex output vectors
 	volatile LONG *pnum_threads;							// pointer to current number of active worker threads
-	int stop;												// when set, fft threads will be returned to the pool
-	int end_dispatcher;										// set this flag to one to destroy the dispatcher thread
-	volatile int dispatcher;								// one if the dispatcher thread is alive & active
-	int ss;													// sub-span being processed
-	int LO;													// LO (within current sub-span) being processed 
+	int stop;												// when set, queued fft jobs return without processing
+	int end_dispatcher;										// when set, no new fft jobs are dispatched
+	CRITICAL_SECTION DispatchSection;						// serializes dispatch_spectra() for this display
 	int flag;
 	int have_samples[dMAX_STITCH][dMAX_NUM_FFT];			// number of unused samples remaining in a buffer
 	int type;												// 0 for REAL, 1 for COMPLEX
@@ -121,7 +124,6 @@ typedef struct _dp
 	HANDLE hSnapEvent[dMAX_STITCH][dMAX_NUM_FFT];			// mutex handles; mutexes will be used to signal a snap is complete
 	double *snap_buff[dMAX_STITCH][dMAX_NUM_FFT];			// pointers to buffers for the snap
 
-	CRITICAL_SECTION PB_ControlsSection[dMAX_PIXOUTS];
 	CRITICAL_SECTION SetAnalyzerSection;
 	CRITICAL_SECTION BufferControlSection[dMAX_STITCH][dMAX_NUM_FFT];
 	CRITICAL_SECTION StitchSection;
@@ -154,6 +156,23 @@ typedef struct _dp
 	double dmb_max_dB;
 	CRITICAL_SECTION cs_dmb;
 	// END CODE TO GET MAX FFT_BIN WITHIN A FREQUENCY RANGE
+	struct _bandq *bq;										// band query table and scratch (see bandq.h); created on first use
+
+	CRITICAL_SECTION StatsSection;							// worker statistics, see GetAnalyzerStats()
+	int st_frames;											// fft jobs run
+	int st_dropped;											// frames dropped because the work queue was full
+	int st_ffts;											// ffts executed (clipped sub-spans are not transformed)
+	double st_wait_sum;										// queue wait, milliseconds
+	double st_wait_max;
+	double st_fft_sum;										// fft execution time, milliseconds
+	double st_fft_max;
+	double st_work_sum;										// worker time spent on this display (window, fft, post-fft), milliseconds
+
+	int zoom_run;											// 1 to shift and decimate complex input ahead of the fft (see zoom.h)
+	int zoom_decim;											// zoom decimation, a power of two
+	double zoom_rate;										// input sample rate ahead of the zoom stage
+	double zoom_freq;										// input frequency moved to the centre of the span
+	struct _zoom *zoom[dMAX_STITCH][dMAX_NUM_FFT];			// zoom stage of each input stream; NULL when not zooming
 
 }  dp, *DP;
 
@@ -176,6 +195,36 @@ void XCreateAnalyzer (	int disp,
 extern __declspec( dllexport )   
 void DestroyAnalyzer(int disp);
 
+extern __declspec( dllexport )
+void SetAnalyzer (	int disp,
+					int n_pixout,
+					int n_fft,
+					int typ,
+					int *flp,
+					int sz,
+					int bf_sz,
+					int win_type,
+					double pi,
+					int ovrlp,
+					int clp,
+					double fscLin,
+					double fscHin,
+					int n_pix,
+					int n_stch,
+					int calset,
+					double fmin,
+					double fmax,
+					int max_w);
+
+extern __declspec( dllexport )
+void SetDisplayAverageMode (int disp, int pixout, int mode);
+
+extern __declspec( dllexport )
+void SetDisplayNumAverage (int disp, int pixout, int num);
+
+extern __declspec( dllexport )
+void SetDisplayAvBackmult (int disp, int pixout, double mult);
+
 extern __declspec( dllexport )   
 void SetCalibration (	int disp,
 						int set_num,				//identifier for this calibration data set
@@ -212,4 +261,59 @@ void SnapSpectrumTimeout (int disp,
 	                      DWORD timeout,
 	                      int* flag);
 
+extern __declspec( dllexport )
+void GetPixelsDirect (	int disp,
+						int pixout,
+						const dOUTREAL **pix,
+						int *num_pixels,
+						uint64_t *seq,
+						double *timestamp,
+						int *flag);
+
+extern __declspec( dllexport )
+double GetPixelsLatency (int disp, int pixout);
+
+extern __declspec( dllexport )
+void SetAnalyzerBandQueries (int disp, int run, int ss, int LO, double rate, int nbands, double *fLow, double *fHigh,
+	double occ_dB, int floor_bins);
+
+extern __declspec( dllexport )
+void GetAnalyzerBandResults (int disp, int *nbands, double *peak, double *peak_freq, double *mean, double *floor_dB,
+	double *occupancy, uint64_t *seq, int *flag);
+
+extern __declspec( dllexport )
+void SetAnalyzerZoom (int disp, int run, int decim, double rate, double freq);
+
+extern __declspec( dllexport )
+void SetAnalyzerZoomFreq (int disp, double freq);
+
+extern int analyzer_idle (int disp);
+
+extern __declspec( dllexport )
+void SetAnalyzerThreads (int nthreads);
+
+extern __declspec( dllexport )
+void SetAnalyzerThreadAffinity (int thread, uint64_t mask);
+
+extern __declspec( dllexport )
+void SetAnalyzerQueueDepth (int depth);
+
+extern __declspec( dllexport )
+void SetAnalyzerBatch (int batch);
+
+extern __declspec( dllexport )
+void GetAnalyzerStats (	int disp,
+						int *frames,
+						int *dropped,
+						double *avg_wait,
+						double *max_wait,
+						double *avg_fft,
+						double *max_fft);
+
+extern __declspec( dllexport )
+void ResetAnalyzerStats (int disp);
+
+extern __declspec( dllexport )
+double GetAnalyzerWorkTime (int disp);
+
 #endif
\ No newline at end of file
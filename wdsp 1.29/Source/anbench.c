@@ -0,0 +1,401 @@
+/*  anbench.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+
+#include "comm.h"
+
+/********************************************************************************************************
+*																										*
+*										Analyzer Benchmark												*
+*																										*
+********************************************************************************************************/
+
+#define ANB_NUM_AVERAGE		8				// frames averaged in averaging mode 2
+#define ANB_BACKMULT		0.8				// weight of the history in averaging modes 1 and 3
+
+typedef struct _anbench
+{
+	int first;						// first display
+	int ndisp;						// number of displays
+	int type;						// 0 real, 1 complex
+	int size;						// fft size
+	int overlap;
+	int num_stitch;
+	int num_fft;
+	int av_mode;
+	int num_pixels;
+	int buff_size;					// samples per input call
+	int use_spectrum2;				// feed with Spectrum2() rather than Spectrum0()
+	int span_decim;					// the displayed span is the centre 0.75 * rate / span_decim; 1 shows it all
+	int use_zoom;					// narrow the span with the zoom front end rather than by clipping
+	double rate;					// input sample rate
+	int tlen;						// length of the synthetic signal, complex samples
+	double* sig;					// synthetic signal, interleaved Q, I as Spectrum0() takes it
+	dINREAL* sig2;					// the same as Spectrum2() takes it
+	volatile LONG stop;				// tells the reader to exit
+	volatile LONG done;				// set by the reader as it exits
+	int nlat;						// number of latency samples
+	double* lat;					// latency samples, milliseconds
+	uint64_t* seq;					// sequence number of the last frame taken from each display
+} anbench, *ANBENCH;
+
+static void build_signal (ANBENCH b)
+{
+	// four tones, 0, -40 and -80 dB and a -20 dB one close enough to the centre to lie in every zoomed span,
+	// and uniform noise near -90 dB; the length is a multiple of the buffer size and covers 16 frames of input,
+	// and every tone is a whole number of cycles long so that the signal repeats without a discontinuity
+	int i;
+	unsigned int r = 0x2545f491;
+	double ph0 = 0.0, ph1 = 0.0, ph2 = 0.0, ph3 = 0.0;
+	double f0, f1, f2, f3;
+	b->tlen = 16 * b->size * (b->use_zoom && b->span_decim > 1 ? b->span_decim : 1);
+	f0 = floor (0.1031 * b->tlen + 0.5) / b->tlen;
+	f1 = floor (0.2297 * b->tlen + 0.5) / b->tlen;
+	f2 = floor (0.3113 * b->tlen + 0.5) / b->tlen;
+	f3 = floor (0.000301 * b->tlen + 0.5) / b->tlen;
+	b->sig = (double *) malloc0 (b->tlen * sizeof (complex));
+	b->sig2 = (dINREAL *) malloc0 (b->tlen * 2 * sizeof (dINREAL));
+	for (i = 0; i < b->tlen; i++)
+	{
+		r = 1664525 * r + 1013904223;
+		b->sig[2 * i + 1] = 0.5 * cos (ph0) + 5.0e-3 * cos (ph1) + 5.0e-5 * cos (ph2) + 5.0e-2 * cos (ph3)
+			+ 3.0e-5 * ((double)(r >> 8) / 8388608.0 - 1.0);
+		r = 1664525 * r + 1013904223;
+		b->sig[2 * i + 0] = 0.5 * sin (ph0) + 5.0e-3 * sin (ph1) + 5.0e-5 * sin (ph2) + 5.0e-2 * sin (ph3)
+			+ 3.0e-5 * ((double)(r >> 8) / 8388608.0 - 1.0);
+		ph0 += TWOPI * f0;
+		ph1 -= TWOPI * f1;
+		ph2 += TWOPI * f2;
+		ph3 += TWOPI * f3;
+	}
+	for (i = 0; i < 2 * b->tlen; i++)
+		b->sig2[i] = (dINREAL)b->sig[i];
+}
+
+static int open_displays (ANBENCH b)
+{
+	int d, success;
+	int flp[dMAX_NUM_FFT] = { 0 };
+	double fsclip = 0.0;
+	// bins clipped from each end so that the centre 0.75 * rate / span_decim remains
+	if (b->span_decim > 1)
+		fsclip = 0.5 * (double)b->size * (1.0 - 0.75 / (double)(b->use_zoom ? 1 : b->span_decim));
+	for (d = 0; d < b->ndisp; d++)
+	{
+		XCreateAnalyzer (b->first + d, &success, b->size, b->num_fft, b->num_stitch, NULL);
+		if (success < 0)
+			return 0;
+		SetAnalyzer (b->first + d, 1, b->num_fft, b->type, flp, b->size, b->buff_size, 6, 14.0, b->overlap,
+			0, fsclip, fsclip, b->num_pixels, b->num_stitch, 0, 0.0, 0.0, b->size);
+		if (b->use_zoom && b->span_decim > 1)
+			SetAnalyzerZoom (b->first + d, 1, b->span_decim, b->rate > 0.0 ? b->rate : 1.0, 0.0);
+		SetDisplayNumAverage (b->first + d, 0, ANB_NUM_AVERAGE);
+		SetDisplayAvBackmult (b->first + d, 0, ANB_BACKMULT);
+		SetDisplayAverageMode (b->first + d, 0, b->av_mode);
+		ResetAnalyzerStats (b->first + d);
+	}
+	return 1;
+}
+
+static void close_displays (ANBENCH b)
+{
+	int d;
+	for (d = 0; d < b->ndisp; d++)
+		DestroyAnalyzer (b->first + d);
+}
+
+static void feed_block (ANBENCH b, int n)
+{
+	// buffer 'n' of every input stream; the streams start at different places in the signal
+	int d, ss, LO, k;
+	for (d = 0; d < b->ndisp; d++)
+		for (ss = 0; ss < b->num_stitch; ss++)
+			for (LO = 0; LO < b->num_fft; LO++)
+			{
+				k = ((d * b->num_stitch + ss) * b->num_fft + LO) * 7;
+				k = (int)(((int64_t)(k + n) * b->buff_size) % b->tlen);
+				if (b->use_spectrum2)
+					Spectrum2 (1, b->first + d, ss, LO, b->sig2 + 2 * k);
+				else
+					Spectrum0 (1, b->first + d, ss, LO, b->sig + 2 * k);
+			}
+}
+
+static void anb_reader (void* arg)
+{
+	ANBENCH b = (ANBENCH)arg;
+	const dOUTREAL* pix;
+	int d, npix, flag;
+	uint64_t seq;
+	double timestamp;
+	while (!b->stop)
+	{
+		for (d = 0; d < b->ndisp; d++)
+		{
+			GetPixelsDirect (b->first + d, 0, &pix, &npix, &seq, &timestamp, &flag);
+			if (flag)
+			{
+				if (b->nlat < ANB_MAX_LATENCY)
+					b->lat[b->nlat++] = GetPixelsLatency (b->first + d, 0);
+				b->seq[d] = seq;
+			}
+		}
+		Sleep (1);
+	}
+	InterlockedExchange (&b->done, 1);
+	_endthread ();
+}
+
+static int cmp_double (const void* a, const void* b)
+{
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+static double percentile (double* x, int n, double p)
+{
+	// 'x' sorted ascending
+	if (n == 0) return 0.0;
+	return x[(int)(p * (double)(n - 1) + 0.5)];
+}
+
+static void run_timed (ANBENCH b, double rate, double seconds, double* fps, double* latency, double* cpu,
+	double* feed_cpu, int* dropped)
+{
+	LARGE_INTEGER freq, t_start, t_now, t_fed;
+	double period, elapsed, t, feed = 0.0;
+	int d, n, frames;
+	int i_frames, i_dropped;
+	double avg_wait, max_wait, avg_fft, max_fft;
+	QueryPerformanceFrequency (&freq);
+	period = rate > 0.0 ? (double)b->buff_size / rate * (double)freq.QuadPart : 0.0;
+	b->stop = 0;
+	b->done = 0;
+	if (_beginthread (anb_reader, 0, (void *)b) == (uintptr_t)-1L)
+		b->done = 1;
+	QueryPerformanceCounter (&t_start);
+	for (n = 0; ; n++)
+	{
+		// pace the feed so that buffer 'n' is given no earlier than its due time
+		do
+		{
+			QueryPerformanceCounter (&t_now);
+			t = (double)(t_now.QuadPart - t_start.QuadPart) - (double)n * period;
+			if (t < -2.0e-3 * (double)freq.QuadPart)
+				Sleep (1);
+			else if (t < 0.0)
+				Sleep (0);
+		} while (t < 0.0);
+		if ((double)(t_now.QuadPart - t_start.QuadPart) >= seconds * (double)freq.QuadPart)
+			break;
+		feed_block (b, n);
+		QueryPerformanceCounter (&t_fed);
+		feed += (double)(t_fed.QuadPart - t_now.QuadPart);
+	}
+	elapsed = (double)(t_now.QuadPart - t_start.QuadPart) / (double)freq.QuadPart;
+	InterlockedExchange (&b->stop, 1);
+	while (!b->done)
+		Sleep (1);
+	frames = 0;
+	*cpu = 0.0;
+	*dropped = 0;
+	for (d = 0; d < b->ndisp; d++)
+	{
+		frames += (int)b->seq[d];
+		*cpu += GetAnalyzerWorkTime (b->first + d);
+		GetAnalyzerStats (b->first + d, &i_frames, &i_dropped, &avg_wait, &max_wait, &avg_fft, &max_fft);
+		*dropped += i_dropped;
+	}
+	*fps = (double)frames / (double)b->ndisp / elapsed;
+	*cpu = *cpu / (double)b->ndisp / (10.0 * elapsed);
+	*feed_cpu = 100.0 * feed / (double)freq.QuadPart / (double)b->ndisp / elapsed;
+	qsort (b->lat, b->nlat, sizeof (double), cmp_double);
+	latency[0] = percentile (b->lat, b->nlat, 0.50);
+	latency[1] = percentile (b->lat, b->nlat, 0.90);
+	latency[2] = percentile (b->lat, b->nlat, 0.99);
+	latency[3] = percentile (b->lat, b->nlat, 1.00);
+}
+
+static void capture_golden (ANBENCH b, float* out)
+{
+	// feeds ANB_GOLDEN_FRAMES frames of input one buffer at a time, letting the analyzer go idle after each,
+	// so that nothing is skipped or dropped and the final frame depends only on the settings
+	const dOUTREAL* pix;
+	int d, i, n, nblocks, npix, flag;
+	uint64_t seq;
+	double timestamp;
+	int incr = b->size - b->overlap;
+	nblocks = (b->size + (ANB_GOLDEN_FRAMES - 1) * incr + b->buff_size - 1) / b->buff_size;
+	if (b->use_zoom && b->span_decim > 1)
+		nblocks *= b->span_decim;
+	for (n = 0; n < nblocks; n++)
+	{
+		feed_block (b, n);
+		for (d = 0; d < b->ndisp; d++)
+			while (!analyzer_idle (b->first + d))
+				Sleep (0);
+	}
+	for (d = 0; d < b->ndisp; d++)
+	{
+		GetPixelsDirect (b->first + d, 0, &pix, &npix, &seq, &timestamp, &flag);
+		for (i = 0; i < b->num_pixels; i++)
+			out[d * b->num_pixels + i] = (float)pix[i];
+	}
+}
+
+static int golden_file (ANBENCH b, const char* golden, int golden_mode, double tolerance, float* pix, double* diff)
+{
+	// file layout:  "WDSPANB1", number of displays and of pixels (int), then the pixels (float), display by display
+	static const char magic[8] = { 'W', 'D', 'S', 'P', 'A', 'N', 'B', '1' };
+	FILE* file;
+	char m[8];
+	int shape[2], i, n;
+	float* ref;
+	n = b->ndisp * b->num_pixels;
+	*diff = 0.0;
+	if (golden_mode == ANB_GOLDEN_WRITE)
+	{
+		if ((file = fopen (golden, "wb")) == NULL)
+			return ANB_FILE_ERROR;
+		shape[0] = b->ndisp;
+		shape[1] = b->num_pixels;
+		fwrite (magic, 1, 8, file);
+		fwrite (shape, sizeof (int), 2, file);
+		i = (int)fwrite (pix, sizeof (float), n, file);
+		fclose (file);
+		return i == n ? ANB_OK : ANB_FILE_ERROR;
+	}
+	if ((file = fopen (golden, "rb")) == NULL)
+		return ANB_FILE_ERROR;
+	ref = (float *) malloc0 (n * sizeof (float));
+	if (fread (m, 1, 8, file) != 8 || memcmp (m, magic, 8) != 0 || fread (shape, sizeof (int), 2, file) != 2
+		|| shape[0] != b->ndisp || shape[1] != b->num_pixels || (int)fread (ref, sizeof (float), n, file) != n)
+	{
+		fclose (file);
+		_aligned_free (ref);
+		return ANB_FILE_ERROR;
+	}
+	fclose (file);
+	for (i = 0; i < n; i++)
+		if (fabs ((double)pix[i] - (double)ref[i]) > *diff)
+			*diff = fabs ((double)pix[i] - (double)ref[i]);
+	_aligned_free (ref);
+	return *diff > tolerance ? ANB_MISMATCH : ANB_OK;
+}
+
+PORT
+int RunAnalyzerBenchmark (	int first_disp,		// displays first_disp ... first_disp + ndisp - 1 are created and destroyed;
+							int ndisp,			//   they must not be in use
+							int type,			// 0 for real input, 1 for complex input
+							int size,			// fft size
+							int overlap,		// samples each fft re-uses from the previous one
+							int num_stitch,		// number of sub-spans
+							int num_fft,		// number of LO positions per sub-span
+							int av_mode,		// averaging mode, as SetDisplayAverageMode()
+							int num_pixels,
+							int buff_size,		// samples per input call; must divide 'size'
+							double rate,		// input sample rate of each stream; 0 feeds as fast as possible
+							double seconds,		// duration of the timed run; 0 skips it
+							int use_spectrum2,	// 1 feeds with Spectrum2(), 0 with Spectrum0()
+							int span_decim,		// > 1 shows only the centre 0.75 * rate / span_decim, the span
+												//   of the zoom front end at that decimation
+							int use_zoom,		// 1 narrows the span with the zoom front end, ahead of an fft of
+												//   'size'; 0 clips it from a full-rate fft of 'size'
+							const char* golden,	// golden pixel file
+							int golden_mode,	// ANB_GOLDEN_NONE, ANB_GOLDEN_WRITE or ANB_GOLDEN_COMPARE
+							double tolerance,	// largest pixel difference from the golden file that passes, dB
+							double* fps,		// frames per second per display
+							double* latency,	// [4]:  50th, 90th and 99th percentile and maximum latency, ms, from the
+												//   dispatch of a frame's newest input to its publication
+							double* cpu,		// worker time per display, percent of one cpu
+							double* feed_cpu,	// time in the input calls (copy and zoom) per display, percent of
+												//   one cpu
+							int* dropped,		// frames dropped because the work queue was full, all displays
+							double* golden_diff	// largest pixel difference from the golden file, dB
+						 )
+{
+	ANBENCH b;
+	float* pix;
+	int rc = ANB_OK;
+	*fps = 0.0;
+	memset (latency, 0, 4 * sizeof (double));
+	*cpu = 0.0;
+	*feed_cpu = 0.0;
+	*dropped = 0;
+	*golden_diff = 0.0;
+	if (ndisp < 1 || first_disp < 0 || first_disp + ndisp > dMAX_DISPLAYS || size < 2 || overlap < 0
+		|| overlap >= size || num_stitch < 1 || num_stitch > dMAX_STITCH || num_fft < 1 || num_fft > dMAX_NUM_FFT
+		|| num_pixels < 1 || num_pixels > dMAX_PIXELS || buff_size < 1 || size % buff_size != 0
+		|| span_decim < 1 || span_decim > ZOOM_MAX_DECIM || (use_zoom && type != 1)
+		|| (golden_mode != ANB_GOLDEN_NONE && golden == NULL))
+		return ANB_BAD_ARGS;
+	b = (ANBENCH) malloc0 (sizeof (anbench));
+	b->first = first_disp;
+	b->ndisp = ndisp;
+	b->type = type;
+	b->size = size;
+	b->overlap = overlap;
+	b->num_stitch = num_stitch;
+	b->num_fft = num_fft;
+	b->av_mode = av_mode;
+	b->num_pixels = num_pixels;
+	b->buff_size = buff_size;
+	b->use_spectrum2 = use_spectrum2;
+	b->span_decim = span_decim;
+	b->use_zoom = use_zoom;
+	b->rate = rate;
+	b->lat = (double *) malloc0 (ANB_MAX_LATENCY * sizeof (double));
+	b->seq = (uint64_t *) malloc0 (ndisp * sizeof (uint64_t));
+	build_signal (b);
+	if (seconds > 0.0)
+	{
+		if (open_displays (b))
+			run_timed (b, rate, seconds, fps, latency, cpu, feed_cpu, dropped);
+		else
+			rc = ANB_BAD_ARGS;
+		close_displays (b);
+	}
+	if (rc == ANB_OK && golden_mode != ANB_GOLDEN_NONE)
+	{
+		pix = (float *) malloc0 (ndisp * num_pixels * sizeof (float));
+		if (open_displays (b))
+		{
+			capture_golden (b, pix);
+			rc = golden_file (b, golden, golden_mode, tolerance, pix, golden_diff);
+		}
+		else
+			rc = ANB_BAD_ARGS;
+		close_displays (b);
+		_aligned_free (pix);
+	}
+	_aligned_free (b->sig2);
+	_aligned_free (b->sig);
+	_aligned_free (b->seq);
+	_aligned_free (b->lat);
+	_aligned_free (b);
+	return rc;
+}
@@ -0,0 +1,66 @@
+/*  anbench.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+
+/********************************************************************************************************
+*																										*
+*										Analyzer Benchmark												*
+*																										*
+********************************************************************************************************/
+
+// Headless throughput and regression run of the analyzer, for use from a test harness or console
+// diagnostics.  A set of displays is created and configured alike; a deterministic synthetic signal
+// (three tones and low-level noise) is fed through Spectrum0() or Spectrum2() at a target sample rate from
+// the calling thread while a reader thread takes frames with GetPixelsDirect().  Afterwards the displays
+// are re-created and a short run is fed one buffer at a time, waiting for the analyzer to go idle after
+// each, so that its final frame depends only on the settings; that frame is written to or compared with
+// a golden file.  A complex display can show a narrow span either through the zoom front end or by
+// clipping a larger full-rate fft, so that the two can be compared at the same span and resolution.
+
+#ifndef _anbench_h
+#define _anbench_h
+#include "comm.h"
+
+#define ANB_MAX_LATENCY		65536			// latency samples kept for the percentiles
+#define ANB_GOLDEN_FRAMES	4				// frames fed for the golden capture
+
+// golden file modes
+#define ANB_GOLDEN_NONE		0
+#define ANB_GOLDEN_WRITE	1
+#define ANB_GOLDEN_COMPARE	2
+
+// return values
+#define ANB_OK				0
+#define ANB_MISMATCH		1				// golden comparison exceeded the tolerance
+#define ANB_BAD_ARGS		-1
+#define ANB_FILE_ERROR		-2				// golden file missing, unreadable or of different shape
+
+extern __declspec (dllexport) int RunAnalyzerBenchmark (int first_disp, int ndisp, int type, int size, int overlap,
+	int num_stitch, int num_fft, int av_mode, int num_pixels, int buff_size, double rate, double seconds,
+	int use_spectrum2, int span_decim, int use_zoom, const char* golden, int golden_mode, double tolerance,
+	double* fps, double* latency, double* cpu, double* feed_cpu, int* dropped, double* golden_diff);
+
+#endif
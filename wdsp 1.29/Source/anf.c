@@ -53,91 +53,28 @@ ANF create_anf	(
 	a->buff_size = buff_size;
 	a->in_buff = in_buff;
 	a->out_buff = out_buff;
-	a->dline_size = dline_size;
-	a->mask = dline_size - 1;
-	a->n_taps = n_taps;
-	a->delay = delay;
-	a->two_mu = two_mu;
-	a->gamma = gamma;
-	a->in_idx = 0;
-	a->lidx = lidx;
-	a->lidx_min = lidx_min;
-	a->lidx_max = lidx_max;
-	a->ngamma = ngamma;
-	a->den_mult = den_mult;
-	a->lincr = lincr;
-	a->ldecr = ldecr;
-	
-	memset (a->d, 0, sizeof(double) * ANF_DLINE_SIZE);
-	memset (a->w, 0, sizeof(double) * ANF_DLINE_SIZE);
-	
+	a->nl = create_nlms (NLMS_OUT_ERROR, dline_size, n_taps, delay, two_mu, gamma,
+		lidx, lidx_min, lidx_max, ngamma, den_mult, lincr, ldecr);
 	return a;
 }
 
 void destroy_anf (ANF a)
 {
+	destroy_nlms (a->nl);
 	_aligned_free (a);
 }
 
 void xanf(ANF a, int position)
 {
-    int i, j, idx;
-    double c0, c1;
-    double y, error, sigma, inv_sigp;
-	double nel, nev;
-    if (a->run && (a->position == position))
-	{
-		for (i = 0; i < a->buff_size; i++)
-		{
-			a->d[a->in_idx] = a->in_buff[2 * i + 0];
-
-			y = 0;
-			sigma = 0;
-
-			for (j = 0; j < a->n_taps; j++)
-			{
-				idx = (a->in_idx + j + a->delay) & a->mask;
-				y += a->w[j] * a->d[idx];
-				sigma += a->d[idx] * a->d[idx];
-			}
-			inv_sigp = 1.0 / (sigma + 1e-10);
-			error = a->d[a->in_idx] - y;
-
-			a->out_buff[2 * i + 0] = error;
-			a->out_buff[2 * i + 1] = 0.0;
-
-			if((nel = error * (1.0 - a->two_mu * sigma * inv_sigp)) < 0.0) nel = -nel;
-			if((nev = a->d[a->in_idx] - (1.0 - a->two_mu * a->ngamma) * y - a->two_mu * error * sigma * inv_sigp) < 0.0) nev = -nev;
-			if (nev < nel)
-			{
-				if ((a->lidx += a->lincr) > a->lidx_max) a->lidx = a->lidx_max;
-			}
-			else
-			{
-				if ((a->lidx -= a->ldecr) < a->lidx_min) a->lidx = a->lidx_min;
-			}
-			a->ngamma = a->gamma * (a->lidx * a->lidx) * (a->lidx * a->lidx) * a->den_mult;
-
-			c0 = 1.0 - a->two_mu * a->ngamma;
-			c1 = a->two_mu * error * inv_sigp;
-
-			for (j = 0; j < a->n_taps; j++)
-			{
-				idx = (a->in_idx + j + a->delay) & a->mask;
-				a->w[j] = c0 * a->w[j] + c1 * a->d[idx];
-			}
-			a->in_idx = (a->in_idx + a->mask) & a->mask;
-		}
-	}
+	if (a->run && (a->position == position))
+		xnlms (a->nl, a->buff_size, a->in_buff, a->out_buff);
 	else if (a->in_buff != a->out_buff)
 		memcpy (a->out_buff, a->in_buff, a->buff_size * sizeof (complex));
 }
 
 void flush_anf (ANF a)
 {
-	memset (a->d, 0, sizeof(double) * ANF_DLINE_SIZE);
-	memset (a->w, 0, sizeof(double) * ANF_DLINE_SIZE);
-	a->in_idx = 0;
+	flush_nlms (a->nl);
 }
 
 void setBuffers_anf (ANF a, double* in, double* out)
@@ -184,10 +121,10 @@ PORT void
 SetRXAANFVals (int channel, int taps, int delay, double gain, double leakage)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
-	rxa[channel].anf.p->n_taps = taps;
-	rxa[channel].anf.p->delay = delay;
-	rxa[channel].anf.p->two_mu = gain;			//try two_mu = 1e-4
-	rxa[channel].anf.p->gamma = leakage;		//try gamma = 0.10
+	rxa[channel].anf.p->nl->n_taps = taps;
+	rxa[channel].anf.p->nl->delay = delay;
+	rxa[channel].anf.p->nl->two_mu = gain;			//try two_mu = 1e-4
+	rxa[channel].anf.p->nl->gamma = leakage;		//try gamma = 0.10
 	flush_anf (rxa[channel].anf.p);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
@@ -196,7 +133,7 @@ PORT void
 SetRXAANFTaps (int channel, int taps)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
-	rxa[channel].anf.p->n_taps = taps;
+	rxa[channel].anf.p->nl->n_taps = taps;
 	flush_anf (rxa[channel].anf.p);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
@@ -205,7 +142,7 @@ PORT void
 SetRXAANFDelay (int channel, int delay)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
-	rxa[channel].anf.p->delay = delay;
+	rxa[channel].anf.p->nl->delay = delay;
 	flush_anf (rxa[channel].anf.p);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
@@ -214,7 +151,7 @@ PORT void
 SetRXAANFGain (int channel, double gain)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
-	rxa[channel].anf.p->two_mu = gain;
+	rxa[channel].anf.p->nl->two_mu = gain;
 	flush_anf (rxa[channel].anf.p);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
@@ -223,7 +160,7 @@ PORT void
 SetRXAANFLeakage (int channel, double leakage)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
-	rxa[channel].anf.p->gamma = leakage;
+	rxa[channel].anf.p->nl->gamma = leakage;
 	flush_anf (rxa[channel].anf.p);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
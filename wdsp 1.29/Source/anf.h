@@ -36,23 +36,7 @@ typedef struct _anf
 	int buff_size;
 	double *in_buff;
 	double *out_buff;
-	int dline_size;
-	int mask;
-	int n_taps;
-	int delay;
-	double two_mu;
-	double gamma;
-	double d [ANF_DLINE_SIZE];
-	double w [ANF_DLINE_SIZE];
-	int in_idx;
-
-	double lidx;
-	double lidx_min;
-	double lidx_max;
-	double ngamma;
-	double den_mult;
-	double lincr;
-	double ldecr;
+	struct _nlms *nl;					// adaptive filter (see nlms.h)
 } anf, *ANF;
 
 extern ANF create_anf	(
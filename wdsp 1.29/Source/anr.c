@@ -53,91 +53,28 @@ ANR create_anr	(
 	a->buff_size = buff_size;
 	a->in_buff = in_buff;
 	a->out_buff = out_buff;
-	a->dline_size = dline_size;
-	a->mask = dline_size - 1;
-	a->n_taps = n_taps;
-	a->delay = delay;
-	a->two_mu = two_mu;
-	a->gamma = gamma;
-	a->in_idx = 0;
-	a->lidx = lidx;
-	a->lidx_min = lidx_min;
-	a->lidx_max = lidx_max;
-	a->ngamma = ngamma;
-	a->den_mult = den_mult;
-	a->lincr = lincr;
-	a->ldecr = ldecr;
-	
-	memset (a->d, 0, sizeof(double) * ANR_DLINE_SIZE);
-	memset (a->w, 0, sizeof(double) * ANR_DLINE_SIZE);
-	
+	a->nl = create_nlms (NLMS_OUT_PREDICTION, dline_size, n_taps, delay, two_mu, gamma,
+		lidx, lidx_min, lidx_max, ngamma, den_mult, lincr, ldecr);
 	return a;
 }
 
 void destroy_anr (ANR a)
 {
+	destroy_nlms (a->nl);
 	_aligned_free (a);
 }
 
 void xanr (ANR a, int position)
 {
-    int i, j, idx;
-    double c0, c1;
-    double y, error, sigma, inv_sigp;
-	double nel, nev;
-    if (a->run && (a->position == position))
-	{
-		for (i = 0; i < a->buff_size; i++)
-		{
-			a->d[a->in_idx] = a->in_buff[2 * i + 0];
-
-			y = 0;
-			sigma = 0;
-
-			for (j = 0; j < a->n_taps; j++)
-			{
-				idx = (a->in_idx + j + a->delay) & a->mask;
-				y += a->w[j] * a->d[idx];
-				sigma += a->d[idx] * a->d[idx];
-			}
-			inv_sigp = 1.0 / (sigma + 1e-10);
-			error = a->d[a->in_idx] - y;
-
-			a->out_buff[2 * i + 0] = y;
-			a->out_buff[2 * i + 1] = 0.0;
-
-			if((nel = error * (1.0 - a->two_mu * sigma * inv_sigp)) < 0.0) nel = -nel;
-			if((nev = a->d[a->in_idx] - (1.0 - a->two_mu * a->ngamma) * y - a->two_mu * error * sigma * inv_sigp) < 0.0) nev = -nev;
-			if (nev < nel)
-			{
-				if ((a->lidx += a->lincr) > a->lidx_max) a->lidx = a->lidx_max;
-			}
-			else
-			{
-				if ((a->lidx -= a->ldecr) < a->lidx_min) a->lidx = a->lidx_min;
-			}
-			a->ngamma = a->gamma * (a->lidx * a->lidx) * (a->lidx * a->lidx) * a->den_mult;
-
-			c0 = 1.0 - a->two_mu * a->ngamma;
-			c1 = a->two_mu * error * inv_sigp;
-
-			for (j = 0; j < a->n_taps; j++)
-			{
-				idx = (a->in_idx + j + a->delay) & a->mask;
-				a->w[j] = c0 * a->w[j] + c1 * a->d[idx];
-			}
-			a->in_idx = (a->in_idx + a->mask) & a->mask;
-		}
-	}
+	if (a->run && (a->position == position))
+		xnlms (a->nl, a->buff_size, a->in_buff, a->out_buff);
 	else if (a->in_buff != a->out_buff)
 		memcpy (a->out_buff, a->in_buff, a->buff_size * sizeof (complex));
 }
 
 void flush_anr (ANR a)
 {
-	memset (a->d, 0, sizeof(double) * ANR_DLINE_SIZE);
-	memset (a->w, 0, sizeof(double) * ANR_DLINE_SIZE);
-	a->in_idx = 0;
+	flush_nlms (a->nl);
 }
 
 void setBuffers_anr (ANR a, double* in, double* out)
@@ -183,10 +120,10 @@ PORT void
 SetRXAANRVals (int channel, int taps, int delay, double gain, double leakage)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
-	rxa[channel].anr.p->n_taps = taps;
-	rxa[channel].anr.p->delay = delay;
-	rxa[channel].anr.p->two_mu = gain;
-	rxa[channel].anr.p->gamma = leakage;
+	rxa[channel].anr.p->nl->n_taps = taps;
+	rxa[channel].anr.p->nl->delay = delay;
+	rxa[channel].anr.p->nl->two_mu = gain;
+	rxa[channel].anr.p->nl->gamma = leakage;
 	flush_anr (rxa[channel].anr.p);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
@@ -195,7 +132,7 @@ PORT void
 SetRXAANRTaps (int channel, int taps)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
-	rxa[channel].anr.p->n_taps = taps;
+	rxa[channel].anr.p->nl->n_taps = taps;
 	flush_anr (rxa[channel].anr.p);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
@@ -204,7 +141,7 @@ PORT void
 SetRXAANRDelay (int channel, int delay)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
-	rxa[channel].anr.p->delay = delay;
+	rxa[channel].anr.p->nl->delay = delay;
 	flush_anr (rxa[channel].anr.p);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
@@ -213,7 +150,7 @@ PORT void
 SetRXAANRGain (int channel, double gain)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
-	rxa[channel].anr.p->two_mu = gain;
+	rxa[channel].anr.p->nl->two_mu = gain;
 	flush_anr (rxa[channel].anr.p);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
@@ -222,7 +159,7 @@ PORT void
 SetRXAANRLeakage (int channel, double leakage)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
-	rxa[channel].anr.p->gamma = leakage;
+	rxa[channel].anr.p->nl->gamma = leakage;
 	flush_anr (rxa[channel].anr.p);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
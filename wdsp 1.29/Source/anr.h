@@ -36,23 +36,7 @@ typedef struct _anr
 	int buff_size;
 	double *in_buff;
 	double *out_buff;
-	int dline_size;
-	int mask;
-	int n_taps;
-	int delay;
-	double two_mu;
-	double gamma;
-	double d [ANR_DLINE_SIZE];
-	double w [ANR_DLINE_SIZE];
-	int in_idx;
-
-	double lidx;
-	double lidx_min;
-	double lidx_max;
-	double ngamma;
-	double den_mult;
-	double lincr;
-	double ldecr;
+	struct _nlms *nl;					// adaptive filter (see nlms.h)
 } anr, *ANR;
 
 extern ANR create_anr	(
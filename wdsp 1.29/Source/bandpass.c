@@ -39,15 +39,19 @@ void calc_bps (BPS a)
 	a->product = (double *)malloc0(2 * a->size * sizeof(complex));
 	impulse = fir_bandpass(a->size + 1, a->f_low, a->f_high, a->samplerate, a->wintype, 1, 1.0 / (double)(2 * a->size));
 	a->mults = fftcv_mults(2 * a->size, impulse);
+	enter_fftplanner ();
 	a->CFor = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->infilt, (fftw_complex *)a->product, FFTW_FORWARD, FFTW_PATIENT);
 	a->CRev = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->product, (fftw_complex *)a->out, FFTW_BACKWARD, FFTW_PATIENT);
+	leave_fftplanner ();
 	_aligned_free(impulse);
 }
 
 void decalc_bps (BPS a)
 {
+	enter_fftplanner ();
 	fftw_destroy_plan(a->CRev);
 	fftw_destroy_plan(a->CFor);
+	leave_fftplanner ();
 	_aligned_free(a->mults);
 	_aligned_free(a->product);
 	_aligned_free(a->infilt);
@@ -282,7 +286,7 @@ void SetTXABPSWindow (int channel, int wintype)
 ********************************************************************************************************/
 
 BANDPASS create_bandpass (int run, int position, int size, int nc, int mp, double* in, double* out, 
-	double f_low, double f_high, int samplerate, int wintype, double gain)
+	double f_low, double f_high, int samplerate, int wintype, double gain, int precision)
 {
 	// NOTE:  'nc' must be >= 'size'
 	BANDPASS a = (BANDPASS) malloc0 (sizeof (bandpass));
@@ -300,13 +304,14 @@ BANDPASS create_bandpass (int run, int position, int size, int nc, int mp, doubl
 	a->wintype = wintype;
 	a->gain = gain;
 	impulse = fir_bandpass (a->nc, a->f_low, a->f_high, a->samplerate, a->wintype, 1, a->gain / (double)(2 * a->size));
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse, precision);
 	_aligned_free (impulse);
 	return a;
 }
 
 void destroy_bandpass (BANDPASS a)
 {
+	cancel_fcdesign (a);
 	destroy_fircore (a->p);
 	_aligned_free (a);
 }
@@ -331,12 +336,18 @@ void setBuffers_bandpass (BANDPASS a, double* in, double* out)
 	setBuffers_fircore (a->p, a->in, a->out);
 }
 
+// The synchronous setters below hold the fircore's 'design' lock across the parameter write and the
+// redesign, so that a background design already in flight (see 'RXA Properties') cannot publish an
+// impulse built from the old rate, size or gain after them.
+
 void setSamplerate_bandpass (BANDPASS a, int rate)
 {
 	double* impulse;
+	EnterCriticalSection (&a->p->design);
 	a->samplerate = rate;
 	impulse = fir_bandpass (a->nc, a->f_low, a->f_high, a->samplerate, a->wintype, 1, a->gain / (double)(2 * a->size));
 	setImpulse_fircore (a->p, impulse, 1);
+	LeaveCriticalSection (&a->p->design);
 	_aligned_free (impulse);
 }
 
@@ -344,26 +355,31 @@ void setSize_bandpass (BANDPASS a, int size)
 {
 	// NOTE:  'size' must be <= 'nc'
 	double* impulse;
+	EnterCriticalSection (&a->p->design);
 	a->size = size;
 	setSize_fircore (a->p, a->size);
 	// recalc impulse because scale factor is a function of size
 	impulse = fir_bandpass (a->nc, a->f_low, a->f_high, a->samplerate, a->wintype, 1, a->gain / (double)(2 * a->size));
 	setImpulse_fircore (a->p, impulse, 1);
+	LeaveCriticalSection (&a->p->design);
 	_aligned_free (impulse);
 }
 
 void setGain_bandpass (BANDPASS a, double gain, int update)
 {
 	double* impulse;
+	EnterCriticalSection (&a->p->design);
 	a->gain = gain;
 	impulse = fir_bandpass (a->nc, a->f_low, a->f_high, a->samplerate, a->wintype, 1, a->gain / (double)(2 * a->size));
 	setImpulse_fircore (a->p, impulse, update);
+	LeaveCriticalSection (&a->p->design);
 	_aligned_free (impulse);
 }
 
 void CalcBandpassFilter (BANDPASS a, double f_low, double f_high, double gain)
 {
 	double* impulse;
+	EnterCriticalSection (&a->p->design);
 	if ((a->f_low != f_low) || (a->f_high != f_high) || (a->gain != gain))
 	{
 		a->f_low = f_low;
@@ -373,6 +389,7 @@ void CalcBandpassFilter (BANDPASS a, double f_low, double f_high, double gain)
 		setImpulse_fircore (a->p, impulse, 1);
 		_aligned_free (impulse);
 	}
+	LeaveCriticalSection (&a->p->design);
 }
 
 /********************************************************************************************************
@@ -389,51 +406,55 @@ void SetRXABandpassRun (int channel, int run)
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
 
-PORT
-void SetRXABandpassFreqs (int channel, double f_low, double f_high)
+// The RXA filter-edge, window, nc, and mp calls are designed on the background workers in fcdesign.c.
+// Each design runs under the fircore's 'design' lock, so designs for the same filter never interleave,
+// and publishes the new masks with the 'cset' flip in calc_fircore().  Parameters that other threads
+// read are written under 'csDSP' first; 'csDSP' is never held while waiting for 'design' here, since
+// the nc path and the TXA setters take them in the other order.  The setters always post:  a request is
+// compared with the parameters in use only when its design runs, because a superseded request may never
+// run, and an A -> B -> A sequence must still end on A.  Only the design job writes the fields it
+// compares, and fcdesign never runs two requests for the same job at once.
+
+static void design_rxbp_freqs (void* obj, int channel, double* p)
 {
+	BANDPASS a = (BANDPASS)obj;
 	double* impulse;
-	BANDPASS a = rxa[channel].bp1.p;
-	if ((f_low != a->f_low) || (f_high != a->f_high))
-	{
-		impulse = fir_bandpass (a->nc, f_low, f_high, a->samplerate, 
-			a->wintype, 1, a->gain / (double)(2 * a->size));
-		setImpulse_fircore (a->p, impulse, 0);
-		_aligned_free (impulse);
-		EnterCriticalSection (&ch[channel].csDSP);
-		a->f_low = f_low;
-		a->f_high = f_high;
-		setUpdate_fircore (a->p);
-		LeaveCriticalSection (&ch[channel].csDSP);
-	}
+	if (p[0] == a->f_low && p[1] == a->f_high) return;
+	EnterCriticalSection (&ch[channel].csDSP);
+	a->f_low = p[0];
+	a->f_high = p[1];
+	LeaveCriticalSection (&ch[channel].csDSP);
+	EnterCriticalSection (&a->p->design);
+	impulse = fir_bandpass (a->p->nc, a->f_low, a->f_high, a->samplerate, 
+		a->wintype, 1, a->gain / (double)(2 * a->p->size));
+	setImpulse_fircore (a->p, impulse, 1);
+	LeaveCriticalSection (&a->p->design);
+	_aligned_free (impulse);
 }
 
-PORT
-void SetRXABandpassWindow (int channel, int wintype)
+static void design_rxbp_window (void* obj, int channel, double* p)
 {
+	BANDPASS a = (BANDPASS)obj;
 	double* impulse;
-	BANDPASS a = rxa[channel].bp1.p;
-	if ((a->wintype != wintype))
-	{
-		impulse = fir_bandpass (a->nc, a->f_low, a->f_high, a->samplerate, 
-			wintype, 1, a->gain / (double)(2 * a->size));
-		setImpulse_fircore (a->p, impulse, 0);
-		_aligned_free (impulse);
-		EnterCriticalSection (&ch[channel].csDSP);
-		a->wintype = wintype;
-		setUpdate_fircore (a->p);
-		LeaveCriticalSection (&ch[channel].csDSP);
-	}
+	if ((int)p[0] == a->wintype) return;
+	EnterCriticalSection (&ch[channel].csDSP);
+	a->wintype = (int)p[0];
+	LeaveCriticalSection (&ch[channel].csDSP);
+	EnterCriticalSection (&a->p->design);
+	impulse = fir_bandpass (a->p->nc, a->f_low, a->f_high, a->samplerate, 
+		a->wintype, 1, a->gain / (double)(2 * a->p->size));
+	setImpulse_fircore (a->p, impulse, 1);
+	LeaveCriticalSection (&a->p->design);
+	_aligned_free (impulse);
 }
 
-PORT
-void SetRXABandpassNC (int channel, int nc)
+static void design_rxbp_nc (void* obj, int channel, double* p)
 {
-	// NOTE:  'nc' must be >= 'size'
+	// re-allocation must still exclude the DSP thread
+	BANDPASS a = (BANDPASS)obj;
 	double* impulse;
-	BANDPASS a;
+	int nc = (int)p[0];
 	EnterCriticalSection (&ch[channel].csDSP);
-	a = rxa[channel].bp1.p;
 	if (nc != a->nc)
 	{
 		a->nc = nc;
@@ -444,18 +465,50 @@ void SetRXABandpassNC (int channel, int nc)
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
 
-PORT
-void SetRXABandpassMP (int channel, int mp)
+static void design_rxbp_mp (void* obj, int channel, double* p)
 {
-	BANDPASS a;
-	a = rxa[channel].bp1.p;
+	BANDPASS a = (BANDPASS)obj;
+	int mp = (int)p[0];
 	if (mp != a->mp)
 	{
+		EnterCriticalSection (&ch[channel].csDSP);
 		a->mp = mp;
+		LeaveCriticalSection (&ch[channel].csDSP);
 		setMp_fircore (a->p, a->mp);
 	}
 }
 
+PORT
+void SetRXABandpassFreqs (int channel, double f_low, double f_high)
+{
+	double p[2];
+	p[0] = f_low;
+	p[1] = f_high;
+	post_fcdesign (rxa[channel].bp1.p, design_rxbp_freqs, channel, FCD_RXA_BP_FREQS, 2, p);
+}
+
+PORT
+void SetRXABandpassWindow (int channel, int wintype)
+{
+	double p = (double)wintype;
+	post_fcdesign (rxa[channel].bp1.p, design_rxbp_window, channel, FCD_RXA_BP_WINDOW, 1, &p);
+}
+
+PORT
+void SetRXABandpassNC (int channel, int nc)
+{
+	// NOTE:  'nc' must be >= 'size'
+	double p = (double)nc;
+	post_fcdesign (rxa[channel].bp1.p, design_rxbp_nc, channel, FCD_RXA_BP_NC, 1, &p);
+}
+
+PORT
+void SetRXABandpassMP (int channel, int mp)
+{
+	double p = (double)mp;
+	post_fcdesign (rxa[channel].bp1.p, design_rxbp_mp, channel, FCD_RXA_BP_MP, 1, &p);
+}
+
 /********************************************************************************************************
 *																										*
 *											TXA Properties												*
@@ -112,7 +112,7 @@ typedef struct _bandpass
 }bandpass, *BANDPASS;
 
 extern BANDPASS create_bandpass (int run, int position, int size, int nc, int mp, double* in, double* out, 
-	double f_low, double f_high, int samplerate, int wintype, double gain);
+	double f_low, double f_high, int samplerate, int wintype, double gain, int precision);
 
 extern void destroy_bandpass (BANDPASS a);
 
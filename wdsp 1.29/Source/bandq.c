@@ -0,0 +1,252 @@
+/*  bandq.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+
+#include "comm.h"
+
+/********************************************************************************************************
+*																										*
+*										Blocked Range Extremes											*
+*																										*
+********************************************************************************************************/
+
+static __inline int better (double* v, int sgn, int a, int b)
+{
+	// index of the larger (sgn > 0) or smaller (sgn < 0) value; ties go to 'a'
+	if (sgn > 0) return v[b] > v[a] ? b : a;
+	else         return v[b] < v[a] ? b : a;
+}
+
+static int scan (double* v, int sgn, int lo, int hi)
+{
+	int i, best = lo;
+	for (i = lo + 1; i <= hi; i++)
+		best = better (v, sgn, best, i);
+	return best;
+}
+
+static void init_rmq (bqrmq* r, int max_n)
+{
+	r->nb = (max_n + BQ_BLOCK - 1) / BQ_BLOCK;
+	for (r->levels = 1; (1 << r->levels) <= r->nb; r->levels++);
+	r->tab = (int *) malloc0 (r->levels * r->nb * sizeof (int));
+}
+
+static void build_rmq (bqrmq* r, double* v, int sgn, int n)
+{
+	int b, k, h;
+	int nb = (n + BQ_BLOCK - 1) / BQ_BLOCK;
+	int* t = r->tab;
+	for (b = 0; b < nb; b++)
+		t[b] = scan (v, sgn, b * BQ_BLOCK, min ((b + 1) * BQ_BLOCK, n) - 1);
+	for (k = 1, h = 1; 2 * h <= nb; k++, h *= 2)
+		for (b = 0; b + 2 * h <= nb; b++)
+			t[k * r->nb + b] = better (v, sgn, t[(k - 1) * r->nb + b], t[(k - 1) * r->nb + b + h]);
+}
+
+static int query_rmq (bqrmq* r, double* v, int sgn, int lo, int hi)
+{
+	// index of the extreme of v[lo] ... v[hi]:  partial blocks are scanned, whole blocks come from the table
+	int b0 = lo / BQ_BLOCK + 1;
+	int b1 = hi / BQ_BLOCK - 1;
+	int k, best;
+	if (b1 < b0)
+		return scan (v, sgn, lo, hi);
+	best = better (v, sgn, scan (v, sgn, lo, b0 * BQ_BLOCK - 1), scan (v, sgn, (b1 + 1) * BQ_BLOCK, hi));
+	for (k = 0; (2 << k) <= b1 - b0 + 1; k++);
+	best = better (v, sgn, best, r->tab[k * r->nb + b0]);
+	return better (v, sgn, best, r->tab[k * r->nb + b1 - (1 << k) + 1]);
+}
+
+/********************************************************************************************************
+*																										*
+*											Band Queries												*
+*																										*
+********************************************************************************************************/
+
+BANDQ create_bandq (int max_size)
+{
+	BANDQ q = (BANDQ) malloc0 (sizeof (bandq));
+	InitializeCriticalSectionAndSpinCount (&q->cs, 2500);
+	q->max_size = max_size;
+	q->floor_bins = BQ_FLOOR_BINS;
+	q->mag   = (double *) malloc0 (max_size * sizeof (complex));		// also used as cmagmin() scratch
+	q->phi   = (double *) malloc0 ((max_size + 1) * sizeof (double));
+	q->plo   = (double *) malloc0 ((max_size + 1) * sizeof (double));
+	q->count = (int *)    malloc0 ((max_size + 1) * sizeof (int));
+	q->avg   = (double *) malloc0 (max_size * sizeof (double));
+	init_rmq (&q->max, max_size);
+	init_rmq (&q->min, max_size);
+	q->w = 0;
+	q->r = 1;
+	q->state = 2;
+	return q;
+}
+
+void destroy_bandq (BANDQ q)
+{
+	_aligned_free (q->min.tab);
+	_aligned_free (q->max.tab);
+	_aligned_free (q->avg);
+	_aligned_free (q->count);
+	_aligned_free (q->plo);
+	_aligned_free (q->phi);
+	_aligned_free (q->mag);
+	DeleteCriticalSection (&q->cs);
+	_aligned_free (q);
+}
+
+static __inline double range_sum (BANDQ q, int j0, int j1)
+{
+	// sum of mag[j0] ... mag[j1] from the double-double prefix
+	double s = q->phi[j1 + 1] - q->phi[j0];
+	double bb = s - q->phi[j1 + 1];
+	double e = (q->phi[j1 + 1] - (s - bb)) + (- q->phi[j0] - bb);
+	return s + (e + (q->plo[j1 + 1] - q->plo[j0]));
+}
+
+void build_bandq (BANDQ q, fftw_complex* out, int size, int type, double scale)
+{
+	// call with q->cs held
+	int j, n, w;
+	double hi, lo, s, bb;
+	double thresh = pow (10.0, 0.1 * q->occ_dB) / scale;
+	if (type == 0)
+	{
+		// real input:  0 Hz ... rate / 2
+		q->nbins = size / 2 + 1;
+		q->offset = 0;
+		cmagmin (q->nbins, q->mag, out[0], 0, 1);
+	}
+	else
+	{
+		// complex input:  the upper half of the output holds the negative frequencies
+		q->nbins = size;
+		q->offset = size / 2;
+		cmagmin (size - size / 2, q->mag, out[size / 2], 0, 1);
+		cmagmin (size / 2, q->mag + size - size / 2, out[0], 0, 1);
+	}
+	n = q->nbins;
+	hi = lo = 0.0;
+	q->phi[0] = q->plo[0] = 0.0;
+	q->count[0] = 0;
+	for (j = 0; j < n; j++)
+	{
+		// TwoSum
+		s = hi + q->mag[j];
+		bb = s - hi;
+		lo += (hi - (s - bb)) + (q->mag[j] - bb);
+		hi = s;
+		q->phi[j + 1] = hi;
+		q->plo[j + 1] = lo;
+		q->count[j + 1] = q->count[j] + (q->mag[j] > thresh);
+	}
+	w = min (q->floor_bins, n);
+	for (j = 0; j + w <= n; j++)
+		q->avg[j] = range_sum (q, j, j + w - 1) / (double)w;
+	build_rmq (&q->max, q->mag, +1, n);
+	build_rmq (&q->min, q->avg, -1, n - w + 1);
+}
+
+int argmax_bandq (BANDQ q, int j0, int j1)
+{
+	// after build_bandq(); j0 and j1 are bin indices in frequency order
+	return query_rmq (&q->max, q->mag, +1, j0, j1);
+}
+
+static void publish_bandq (BANDQ q)
+{
+	int w = q->w;
+	q->res[w].seq = ++q->seq;
+	q->w = InterlockedExchange (&q->state, w | 4) & 3;
+}
+
+void xbandq (BANDQ q, double scale, double inv_enb)
+{
+	// call with q->cs held, after build_bandq()
+	int i, j0, j1, jm, w, n = q->nbins;
+	double bin = q->rate / (double)(q->offset ? n : 2 * (n - 1));
+	bqres* res = &q->res[q->w];
+	w = min (q->floor_bins, n);
+	for (i = 0; i < q->nbands; i++)
+	{
+		j0 = (int)ceil  (q->fLow[i]  / bin - 1.0e-09) + q->offset;
+		j1 = (int)floor (q->fHigh[i] / bin + 1.0e-09) + q->offset;
+		if (j0 > j1)		// narrower than a bin:  use the nearest
+			j0 = j1 = (int)floor (0.5 * (q->fLow[i] + q->fHigh[i]) / bin + 0.5) + q->offset;
+		j0 = max (0, min (j0, n - 1));
+		j1 = max (0, min (j1, n - 1));
+		jm = argmax_bandq (q, j0, j1);
+		res->peak[i] = 10.0 * mlog10 (scale * q->mag[jm] + 1.0e-60);
+		res->peak_freq[i] = (double)(jm - q->offset) * bin;
+		res->mean[i] = 10.0 * mlog10 (scale * inv_enb * range_sum (q, j0, j1) / (double)(j1 - j0 + 1) + 1.0e-60);
+		if (j1 - j0 + 1 >= w)
+			res->floor[i] = 10.0 * mlog10 (scale * inv_enb * q->avg[query_rmq (&q->min, q->avg, -1, j0, j1 - w + 1)] + 1.0e-60);
+		else
+			res->floor[i] = res->mean[i];
+		res->occupancy[i] = (double)(q->count[j1 + 1] - q->count[j0]) / (double)(j1 - j0 + 1);
+	}
+	res->nbands = q->nbands;
+	publish_bandq (q);
+}
+
+void setTable_bandq (BANDQ q, int run, int ss, int LO, double rate, int nbands, double* fLow, double* fHigh,
+	double occ_dB, int floor_bins)
+{
+	EnterCriticalSection (&q->cs);
+	q->run = run;
+	q->ss = ss;
+	q->LO = LO;
+	q->rate = rate;
+	q->nbands = max (0, min (nbands, BQ_MAX_BANDS));
+	memcpy (q->fLow,  fLow,  q->nbands * sizeof (double));
+	memcpy (q->fHigh, fHigh, q->nbands * sizeof (double));
+	q->occ_dB = occ_dB;
+	q->floor_bins = floor_bins > 0 ? floor_bins : BQ_FLOOR_BINS;
+	InterlockedAnd (&q->state, ~4);		// results of the old table are not delivered
+	LeaveCriticalSection (&q->cs);
+}
+
+int getResults_bandq (BANDQ q, int* nbands, double* peak, double* peak_freq, double* mean, double* floor_dB,
+	double* occupancy, uint64_t* seq)
+{
+	// returns 1 with the newest frame's results if there is a frame not yet read, else 0; NULL arrays are skipped
+	bqres* res;
+	int n;
+	if ((q->state & 4) == 0)
+		return 0;
+	q->r = InterlockedExchange (&q->state, q->r) & 3;
+	res = &q->res[q->r];
+	n = res->nbands;
+	*nbands = n;
+	*seq = res->seq;
+	if (peak)      memcpy (peak,      res->peak,      n * sizeof (double));
+	if (peak_freq) memcpy (peak_freq, res->peak_freq, n * sizeof (double));
+	if (mean)      memcpy (mean,      res->mean,      n * sizeof (double));
+	if (floor_dB)  memcpy (floor_dB,  res->floor,     n * sizeof (double));
+	if (occupancy) memcpy (occupancy, res->occupancy, n * sizeof (double));
+	return 1;
+}
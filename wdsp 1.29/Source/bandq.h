@@ -0,0 +1,121 @@
+/*  bandq.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+
+/********************************************************************************************************
+*																										*
+*										Analyzer Band Queries											*
+*																										*
+********************************************************************************************************/
+
+// A table of up to BQ_MAX_BANDS frequency ranges attached to one (ss, LO) fft of a complex display.  Each
+// frame, one pass over the fft output builds |X|^2 in frequency order with a double-double prefix sum, a
+// prefix count of bins over the occupancy threshold and a blocked sparse table for range maximum and minimum;
+// every band is then answered in O(BQ_BLOCK) time:
+//     peak		maximum bin power, dB, and the frequency of that bin
+//     mean		mean power over the band, dB, corrected for the window's noise bandwidth like the
+//				average detector
+//     floor	minimum over the band of the 'floor_bins'-bin moving mean, dB, same correction
+//     occupancy	fraction of bins whose power exceeds 'occ_dB'
+// dB values are on the same scale as uncalibrated pixels.  The prefix sums are double-double so that a band
+// of noise next to a carrier 150 dB stronger still sums correctly.  Results are published per frame through
+// a lock-free triple buffer; there is one reader per display.
+
+#ifndef _bandq_h
+#define _bandq_h
+#include "comm.h"
+
+#define BQ_MAX_BANDS		1024
+#define BQ_BLOCK			32			// bins per sparse-table block; a power of two
+#define BQ_FLOOR_BINS		8			// default width of the moving mean used for the floor
+
+typedef struct _bqrmq
+{
+	int nb;							// number of blocks
+	int levels;
+	int* tab;						// levels x nb, index of the extreme value over 2^level blocks
+} bqrmq;
+
+typedef struct _bqres
+{
+	int nbands;
+	uint64_t seq;					// frame sequence number
+	double peak[BQ_MAX_BANDS];
+	double peak_freq[BQ_MAX_BANDS];
+	double mean[BQ_MAX_BANDS];
+	double floor[BQ_MAX_BANDS];
+	double occupancy[BQ_MAX_BANDS];
+} bqres;
+
+typedef struct _bandq
+{
+	CRITICAL_SECTION cs;			// table changes against evaluation
+	int max_size;
+	// query table
+	int run;
+	int ss;
+	int LO;
+	double rate;					// sample rate at the fft
+	int nbands;
+	double fLow[BQ_MAX_BANDS];		// band edges, Hz, referenced to the centre of the span
+	double fHigh[BQ_MAX_BANDS];
+	double occ_dB;					// occupancy threshold
+	int floor_bins;
+	// current frame
+	int nbins;						// number of bins, in frequency order
+	int offset;						// index of 0 Hz
+	double* mag;					// |X|^2
+	double* phi;					// prefix sum of mag, high and low parts
+	double* plo;
+	int* count;						// prefix count of bins over the occupancy threshold
+	double* avg;					// 'floor_bins'-bin moving mean of mag
+	bqrmq max;						// over mag
+	bqrmq min;						// over avg
+	// results
+	bqres res[3];
+	int w;							// result buffer owned by the writer
+	int r;							// result buffer owned by the reader
+	volatile LONG state;			// held result buffer in bits 0-1; 4 set until taken by the reader
+	uint64_t seq;
+} bandq, *BANDQ;
+
+extern BANDQ create_bandq (int max_size);
+
+extern void destroy_bandq (BANDQ q);
+
+extern void build_bandq (BANDQ q, fftw_complex* out, int size, int type, double scale);
+
+extern int argmax_bandq (BANDQ q, int j0, int j1);
+
+extern void xbandq (BANDQ q, double scale, double inv_enb);
+
+extern void setTable_bandq (BANDQ q, int run, int ss, int LO, double rate, int nbands, double* fLow, double* fHigh,
+	double occ_dB, int floor_bins);
+
+extern int getResults_bandq (BANDQ q, int* nbands, double* peak, double* peak_freq, double* mean, double* floor_dB,
+	double* occupancy, uint64_t* seq);
+
+#endif
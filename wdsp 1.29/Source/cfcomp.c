@@ -141,49 +141,20 @@ void calc_comp (CFCOMP a)
 
 void calc_cfcomp(CFCOMP a)
 {
-	int i;
 	a->incr = a->fsize / a->ovrlp;
-	if (a->fsize > a->bsize)
-		a->iasize = a->fsize;
-	else
-		a->iasize = a->bsize + a->fsize - a->incr;
-	a->iainidx = 0;
-	a->iaoutidx = 0;
-	if (a->fsize > a->bsize)
-	{
-		if (a->bsize > a->incr)  a->oasize = a->bsize;
-		else					 a->oasize = a->incr;
-		a->oainidx = (a->fsize - a->bsize - a->incr) % a->oasize;
-	}
-	else
-	{
-		a->oasize = a->bsize;
-		a->oainidx = a->fsize - a->incr;
-	}
-	a->init_oainidx = a->oainidx;
-	a->oaoutidx = 0;
 	a->msize = a->fsize / 2 + 1;
 	a->window    = (double *)malloc0 (a->fsize  * sizeof(double));
-	a->inaccum   = (double *)malloc0 (a->iasize * sizeof(double));
-	a->forfftin  = (double *)malloc0 (a->fsize  * sizeof(double));
-	a->forfftout = (double *)malloc0 (a->msize  * sizeof(complex));
 	a->cmask     = (double *)malloc0 (a->msize  * sizeof(double));
 	a->mask      = (double *)malloc0 (a->msize  * sizeof(double));
 	a->cfc_gain  = (double *)malloc0 (a->msize  * sizeof(double));
-	a->revfftin  = (double *)malloc0 (a->msize  * sizeof(complex));
-	a->revfftout = (double *)malloc0 (a->fsize  * sizeof(double));
-	a->save      = (double **)malloc0(a->ovrlp  * sizeof(double *));
-	for (i = 0; i < a->ovrlp; i++)
-		a->save[i] = (double *)malloc0(a->fsize * sizeof(double));
-	a->outaccum = (double *)malloc0(a->oasize * sizeof(double));
-	a->nsamps = 0;
-	a->saveidx = 0;
-	a->Rfor = fftw_plan_dft_r2c_1d(a->fsize, a->forfftin, (fftw_complex *)a->forfftout, FFTW_ESTIMATE);
-	a->Rrev = fftw_plan_dft_c2r_1d(a->fsize, (fftw_complex *)a->revfftin, a->revfftout, FFTW_ESTIMATE);
+	a->stft = create_stft (a->bsize, a->fsize, a->ovrlp);
+	a->forfftout = a->stft->forfftout;
+	a->revfftin  = a->stft->revfftin;
 	calc_cfcwindow(a);
 
 	a->pregain  = (2.0 * a->winfudge) / (double)a->fsize;
 	a->postgain = 0.5 / ((double)a->ovrlp * a->winfudge);
+	setWindow_stft (a->stft, a->window, a->pregain, a->postgain);
 
 	a->fp = (double *) malloc0 ((a->nfreqs + 2) * sizeof (double));
 	a->gp = (double *) malloc0 ((a->nfreqs + 2) * sizeof (double));
@@ -203,7 +174,6 @@ void calc_cfcomp(CFCOMP a)
 
 void decalc_cfcomp(CFCOMP a)
 {
-	int i;
 	_aligned_free (a->cfc_gain_copy);
 	_aligned_free (a->delta_copy);
 	_aligned_free (a->delta);
@@ -213,20 +183,10 @@ void decalc_cfcomp(CFCOMP a)
 	_aligned_free (a->gp);
 	_aligned_free (a->fp);
 
-	fftw_destroy_plan(a->Rrev);
-	fftw_destroy_plan(a->Rfor);
-	_aligned_free(a->outaccum);
-	for (i = 0; i < a->ovrlp; i++)
-		_aligned_free(a->save[i]);
-	_aligned_free(a->save);
-	_aligned_free(a->revfftout);
-	_aligned_free(a->revfftin);
+	destroy_stft (a->stft);
 	_aligned_free(a->cfc_gain);
 	_aligned_free(a->mask);
 	_aligned_free(a->cmask);
-	_aligned_free(a->forfftout);
-	_aligned_free(a->forfftin);
-	_aligned_free(a->inaccum);
 	_aligned_free(a->window);
 }
 
@@ -263,17 +223,7 @@ CFCOMP create_cfcomp (int run, int position, int peq_run, int size, double* in,
 
 void flush_cfcomp (CFCOMP a)
 {
-	int i;
-	memset (a->inaccum, 0, a->iasize * sizeof (double));
-	for (i = 0; i < a->ovrlp; i++)
-		memset (a->save[i], 0, a->fsize * sizeof (double));
-	memset (a->outaccum, 0, a->oasize * sizeof (double));
-	a->nsamps   = 0;
-	a->iainidx  = 0;
-	a->iaoutidx = 0;
-	a->oainidx  = a->init_oainidx;
-	a->oaoutidx = 0;
-	a->saveidx  = 0;
+	flush_stft (a->stft);
 	a->gain = 0.0;
 	memset(a->delta, 0, a->msize * sizeof(double));
 }
@@ -335,50 +285,19 @@ void xcfcomp (CFCOMP a, int pos)
 {
 	if (a->run && pos == a->position)
 	{
-		int i, j, k, sbuff, sbegin;
-		for (i = 0; i < 2 * a->bsize; i += 2)
-		{
-			a->inaccum[a->iainidx] = a->in[i];
-			a->iainidx = (a->iainidx + 1) % a->iasize;
-		}
-		a->nsamps += a->bsize;
-		while (a->nsamps >= a->fsize)
+		int i;
+		xstft_in (a->stft, a->in);
+		while (xstft_frame (a->stft))
 		{
-			for (i = 0, j = a->iaoutidx; i < a->fsize; i++, j = (j + 1) % a->iasize)
-				a->forfftin[i] = a->pregain * a->window[i] * a->inaccum[j];
-			a->iaoutidx = (a->iaoutidx + a->incr) % a->iasize;
-			a->nsamps -= a->incr;
-			fftw_execute (a->Rfor);
 			calc_mask(a);
 			for (i = 0; i < a->msize; i++)
 			{
 				a->revfftin[2 * i + 0] = a->mask[i] * a->forfftout[2 * i + 0];
 				a->revfftin[2 * i + 1] = a->mask[i] * a->forfftout[2 * i + 1];
 			}
-			fftw_execute (a->Rrev);
-			for (i = 0; i < a->fsize; i++)
-				a->save[a->saveidx][i] = a->postgain * a->window[i] * a->revfftout[i];
-			for (i = a->ovrlp; i > 0; i--)
-			{
-				sbuff = (a->saveidx + i) % a->ovrlp;
-				sbegin = a->incr * (a->ovrlp - i);
-				for (j = sbegin, k = a->oainidx; j < a->incr + sbegin; j++, k = (k + 1) % a->oasize)
-				{
-					if ( i == a->ovrlp)
-						a->outaccum[k]  = a->save[sbuff][j];
-					else
-						a->outaccum[k] += a->save[sbuff][j];
-				}
-			}
-			a->saveidx = (a->saveidx + 1) % a->ovrlp;
-			a->oainidx = (a->oainidx + a->incr) % a->oasize;
-		}
-		for (i = 0; i < a->bsize; i++)
-		{
-			a->out[2 * i + 0] = a->outaccum[a->oaoutidx];
-			a->out[2 * i + 1] = 0.0;
-			a->oaoutidx = (a->oaoutidx + 1) % a->oasize;
+			xstft_ola (a->stft);
 		}
+		xstft_out (a->stft, a->out);
 	}
 	else if (a->out != a->in)
 		memcpy (a->out, a->in, a->bsize * sizeof (complex));
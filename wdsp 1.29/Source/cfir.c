@@ -31,7 +31,7 @@ void calc_cfir (CFIR a)
 	double* impulse;
 	a->scale = 1.0 / (double)(2 * a->size);
 	impulse = cfir_impulse (a->nc, a->DD, a->R, a->Pairs, a->runrate, a->cicrate, a->cutoff, a->xtype, a->xbw, 1, a->scale, a->wintype);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse, a->precision);
 	_aligned_free (impulse);
 }
 
@@ -41,7 +41,7 @@ void decalc_cfir (CFIR a)
 }
 
 CFIR create_cfir (int run, int size, int nc, int mp, double* in, double* out, int runrate, int cicrate, 
-	int DD, int R, int Pairs, double cutoff, int xtype, double xbw, int wintype)
+	int DD, int R, int Pairs, double cutoff, int xtype, double xbw, int wintype, int precision)
 //	run:  0 - no action; 1 - operate
 //	size:  number of complex samples in an input buffer to the CFIR filter
 //	nc:  number of filter coefficients
@@ -55,12 +55,14 @@ CFIR create_cfir (int run, int size, int nc, int mp, double* in, double* out, in
 //	cutoff:  cutoff frequency
 //  xtype:  0 - fourth power transition; 1 - raised cosine transition; 2 - brick wall
 //  xbw:  width of raised cosine transition
+//  precision:  0 for double, 1 for single-precision filter kernel
 {
 	CFIR a = (CFIR) malloc0 (sizeof (cfir));
 	a->run = run;
 	a->size = size;
 	a->nc = nc;
 	a->mp = mp;
+	a->precision = precision;
 	a->in = in;
 	a->out = out;
 	a->runrate = runrate;
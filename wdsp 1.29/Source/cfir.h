@@ -33,6 +33,7 @@ typedef struct _cfir
 	int size;
 	int nc;
 	int mp;
+	int precision;
 	double* in;
 	double* out;
 	int runrate;
@@ -49,7 +50,7 @@ typedef struct _cfir
 } cfir, *CFIR;
 
 extern CFIR create_cfir (int run, int size, int nc, int mp, double* in, double* out, int runrate, int cicrate, 
-	int DD, int R, int Pairs, double cutoff, int xtype, double xbw, int wintype);
+	int DD, int R, int Pairs, double cutoff, int xtype, double xbw, int wintype, int precision);
 
 extern void destroy_cfir (CFIR a);
 
@@ -106,7 +106,7 @@ void pre_main_destroy (int channel)
 	InterlockedBitTestAndReset (&ch[channel].exchange, 0);
 	InterlockedBitTestAndReset (&ch[channel].run, 0);
 	InterlockedBitTestAndSet (&ch[channel].iob.pc->exec_bypass, 0);
-	ReleaseSemaphore (a->Sem_BuffReady, 1, 0);
+	release_buffready (a, 1);
 	Sleep (25);
 }
 
@@ -342,4 +342,77 @@ void SetChannelTSlewDown (int channel, double time)
 	destroy_slews (a);
 	create_slews (a);
 	LeaveCriticalSection (&ch[channel].csEXCH);
-}
\ No newline at end of file
+}
+PORT
+void SetChannelPrecision (int channel, int precision)
+{	// call before OpenChannel(); if the channel is already open, main is rebuilt
+	if (precision != ch[channel].precision)
+	{
+		ch[channel].precision = precision;
+		if (_InterlockedAnd (&ch[channel].run, 1))
+		{
+			CloseChannel (channel);
+			build_channel (channel);
+		}
+	}
+}
+
+PORT
+void SetChannelExchangeMode (int channel, int lockfree)
+{	// 0 for semaphore exchange, 1 for lock-free exchange; may be called before OpenChannel()
+	// if the channel is already open, the iobuffs are rebuilt, main is not
+	if (lockfree != ch[channel].lockfree)
+	{
+		if (_InterlockedAnd (&ch[channel].run, 1))
+		{
+			pre_main_destroy (channel);
+			post_main_destroy (channel);
+			ch[channel].lockfree = lockfree;
+			pre_main_build (channel);
+			post_main_build (channel);
+		}
+		else
+			ch[channel].lockfree = lockfree;
+	}
+}
+
+/********************************************************************************************************
+*																										*
+*										DSP Thread Properties											*
+*																										*
+********************************************************************************************************/
+
+PORT
+void SetChannelThreadPriority (int channel, int priority)
+{	// applied by the dsp thread when it next wakes for a buffer
+	ch[channel].thread.priority = priority;
+	InterlockedBitTestAndSet (&ch[channel].thread.update, 0);
+}
+
+PORT
+void SetChannelThreadAffinity (int channel, uint64_t mask)
+{	// applied by the dsp thread when it next wakes for a buffer
+	ch[channel].thread.affinity = mask;
+	InterlockedBitTestAndSet (&ch[channel].thread.update, 0);
+}
+
+PORT
+int GetChannelThreadStatus (int channel)
+{	// result of the dsp thread's last application of priority and affinity:  0 on success, otherwise the
+	// OS error, e.g., EPERM where real-time scheduling is not permitted
+	return (int)ch[channel].thread.status;
+}
+
+PORT
+void SetChannelLockMemory (int channel, int lock)
+{
+	ch[channel].thread.lock_mem = lock;
+	if (_InterlockedAnd (&ch[channel].run, 1))
+	{
+		EnterCriticalSection (&ch[channel].csDSP);
+		EnterCriticalSection (&ch[channel].csEXCH);
+		lock_iobuffs (ch[channel].iob.pc, lock);
+		LeaveCriticalSection (&ch[channel].csEXCH);
+		LeaveCriticalSection (&ch[channel].csDSP);
+	}
+}
@@ -49,12 +49,22 @@ struct _ch
 	double tdelaydown;
 	double tslewdown;
 	int bfo;					// 'block_for_output', block fexchange until output is available
+	int lockfree;				// 1 for lock-free fexchange()/dexchange() hand-off, 0 for semaphores
+	int precision;				// 0 for double, 1 for single-precision (float) filter kernels
 	volatile long flushflag;
 	struct	//io buffers
 	{
 		IOB pc, pd, pe, pf;		// copies for console calls, dsp, exchange, and flush thread
 		volatile long ch_upslew;
 	} iob;
+	struct	// dsp thread characteristics
+	{
+		int priority;				// < 0, normal scheduling; 0, default ("Pro Audio" / SCHED_FIFO); > 0, SCHED_FIFO priority
+		uint64_t affinity;			// bit-mask of cpus the dsp thread may run on; 0 for no pinning
+		int lock_mem;				// when 1, the iobuff pseudo-rings are locked into physical memory
+		volatile long update;		// when 1, the dsp thread re-applies priority and affinity
+		volatile long status;		// result of the last apply:  0, success; else the OS error (errno, GetLastError() on Windows)
+	} thread;
 };
 
 extern struct _ch ch[];
@@ -81,4 +91,16 @@ PORT void SetAllRates (int channel, int in_rate, int dsp_rate, int out_rate);
 
 PORT int SetChannelState (int channel, int state, int dmode);
 
+PORT void SetChannelExchangeMode (int channel, int lockfree);
+
+PORT void SetChannelPrecision (int channel, int precision);
+
+PORT void SetChannelThreadPriority (int channel, int priority);
+
+PORT void SetChannelThreadAffinity (int channel, uint64_t mask);
+
+PORT int GetChannelThreadStatus (int channel);
+
+PORT void SetChannelLockMemory (int channel, int lock);
+
 #endif
\ No newline at end of file
@@ -24,23 +24,30 @@ warren@wpratt.com
 
 */
 
+#if defined(_WIN32)
 #include <Windows.h>
 #include <process.h>
 #include <intrin.h>
+#include <avrt.h>
+#pragma comment(lib, "Synchronization.lib")		// WaitOnAddress(), WakeByAddress*()
+#else
+#include "linux_port.h"
+#endif
 #include <math.h>
 #include <stdint.h>
 #include <time.h>
-#include <avrt.h>
 #include "fftw3.h"
 
 #include "amd.h"
 #include "ammod.h"
 #include "amsq.h"
 #include "analyzer.h"
+#include "anbench.h"
 #include "anf.h"
 #include "anr.h"
 #include "apfshadow.h"
 #include "bandpass.h"
+#include "bandq.h"
 #include "calcc.h"
 #include "cblock.h"
 #include "cfcomp.h"
@@ -56,7 +63,9 @@ warren@wpratt.com
 #include "emnr.h"
 #include "emph.h"
 #include "eq.h"
+#include "fcdesign.h"
 #include "fcurve.h"
+#include "fftplan.h"
 #include "fir.h"
 #include "firmin.h"
 #include "fmd.h"
@@ -76,6 +85,8 @@ warren@wpratt.com
 #include "meter.h"
 #include "meterlog10.h"
 #include "nbp.h"
+#include "nco.h"
+#include "nlms.h"
 #include "nob.h"
 #include "nobII.h"
 #include "osctrl.h"
@@ -87,13 +98,17 @@ warren@wpratt.com
 #include "shift.h"
 #include "siphon.h"
 #include "slew.h"
+#include "slmax.h"
 #include "snb.h"
 #include "ssql.h"
+#include "stft.h"
 #include "syncbuffs.h"
 #include "TXA.h"
 #include "utilities.h"
 #include "varsamp.h"
+#include "vmath.h"
 #include "wcpAGC.h"
+#include "zoom.h"
 
 // manage differences among consoles
 #define _Thetis
@@ -122,6 +137,12 @@ warren@wpratt.com
 #define dMAX_N							100					// maximum number of frequencies at which to calibrate
 #define dMAX_CAL_SETS					2					// maximum number of calibration data sets
 #define dMAX_PIXOUTS					4					// maximum number of det/avg/outputs per display instance
+#define dMAX_AN_THREADS					32					// maximum number of analyzer worker threads
+#define dAN_THREADS						4					// default number of analyzer worker threads
+#define dMAX_AN_QUEUE					1024				// maximum number of fft jobs waiting for a worker
+#define dAN_QUEUE						256					// default limit on fft jobs waiting for a worker
+#define dAN_BATCH						8					// maximum number of same-size ffts run as one batch, a power of two
+#define dAN_BATCH_SIZE					16384				// largest fft size that is batched
 
 // wisdom definitions
 #define MAX_WISDOM_SIZE_DISPLAY			262144
@@ -133,10 +133,14 @@ double* build_doublepole_2sided (int* nc, double rate, double fcenter, double ba
 		H_i[2 * i + 0] = Hres[0] * mult;
 		H_i[2 * i + 1] = Hres[1] * mult;
 	}
+	enter_fftplanner ();
 	fftw_plan prev = fftw_plan_dft_1d (ncc, (fftw_complex*)H_i,
 		(fftw_complex*)h_i, FFTW_BACKWARD, FFTW_PATIENT);
+	leave_fftplanner ();
 	fftw_execute      (prev);
+	enter_fftplanner ();
 	fftw_destroy_plan (prev);
+	leave_fftplanner ();
 	_aligned_free     (H_i);
 	for (i = 0; i < ncc; i++)
 		h_i[2 * i + 1] = 0.0;
@@ -168,7 +172,7 @@ double* build_doublepole_1eff(int* nc, double rate, double fcenter, double bandw
 }
 
 DOUBLEPOLE create_doublepole (int run, int position, int size, double* in, double* out,
-	double f_center, double bandwidth, int samplerate, double gain, int mode)
+	double f_center, double bandwidth, int samplerate, double gain, int mode, int precision)
 {
 	DOUBLEPOLE a = (DOUBLEPOLE)malloc0 (sizeof(doublepole));
 	double* impulse;
@@ -184,7 +188,7 @@ DOUBLEPOLE create_doublepole (int run, int position, int size, double* in, doubl
 	a->scale = a->gain / (double)(2 * a->size);
 	a->mode = mode;
 	impulse = build_doublepole_1eff (&a->nc, a->samplerate, a->f_center, a->bandwidth, a->scale);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, 0, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, 0, impulse, precision);
 	_aligned_free (impulse);
 	return a;
 }
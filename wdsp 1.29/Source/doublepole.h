@@ -52,7 +52,7 @@ typedef struct _doublepole
 } doublepole, *DOUBLEPOLE;
 
 extern DOUBLEPOLE create_doublepole (int run, int position, int size, double* in, double* out,
-	double f_center, double bandwidth, int samplerate, double gain, int mode);
+	double f_center, double bandwidth, int samplerate, double gain, int mode, int precision);
 
 extern void destroy_doublepole (DOUBLEPOLE a);
 
@@ -40,59 +40,26 @@ warren@wpratt.com
 //      Bureau of Standards, 1964.
 // Shanjie Zhang and Jianming Jin, "Computation of Special Functions."  New York, NY, John Wiley and Sons,
 //      Inc., 1996.  [Sample code given in FORTRAN]
+//
+// The gain functions only need exp(-x) * I0(x) and exp(-x) * I1(x), x >= 0.  Both share the polynomial
+// argument; above 3.75 the exponential cancels, so only 'ex' = exp(-x), computed in bulk by the caller, is
+// used below 3.75.
 
-double bessI0 (double x)
+static void bessI01e (double x, double ex, double* i0e, double* i1e)
 {
-	double res, p;
-	if (x == 0.0)
-		res = 1.0;
-	else
-	{
-		if (x < 0.0) x = -x;
-		if (x <= 3.75)
-		{
-			p = x / 3.75;
-			p = p * p;
-			res = ((((( 0.0045813  * p
-					  + 0.0360768) * p
-					  + 0.2659732) * p
-					  + 1.2067492) * p
-					  + 3.0899424) * p
-					  + 3.5156229) * p
-					  + 1.0;
-		}
-		else
-		{
-			p = 3.75 / x;
-			res = exp (x) / sqrt (x)
-				  * (((((((( + 0.00392377  * p
-						     - 0.01647633) * p
-						     + 0.02635537) * p
-						     - 0.02057706) * p
-						     + 0.00916281) * p
-						     - 0.00157565) * p
-						     + 0.00225319) * p
-						     + 0.01328592) * p
-						     + 0.39894228);
-		}
-	}
-	return res;
-}
-
-double bessI1 (double x)
-{
-	
-	double res, p;
-	if (x == 0.0)
-		res = 0.0;
-	else
+	double p, s;
+	if (x <= 3.75)
 	{
-		if (x < 0.0) x = -x;
-		if (x <= 3.75)
-		{
-			p = x / 3.75;
-			p = p * p;
-			res = x 
+		p = x / 3.75;
+		p = p * p;
+		*i0e = ex * ((((((  0.0045813  * p
+						  + 0.0360768) * p
+						  + 0.2659732) * p
+						  + 1.2067492) * p
+						  + 3.0899424) * p
+						  + 3.5156229) * p
+						  + 1.0);
+		*i1e = ex * x
 				  * (((((( 0.00032411  * p
 					     + 0.00301532) * p
 					     + 0.02658733) * p
@@ -100,63 +67,117 @@ double bessI1 (double x)
 					     + 0.51498869) * p
 					     + 0.87890594) * p
 					     + 0.5);
-		}
-		else
-		{
-			p = 3.75 / x;
-			res = exp (x) / sqrt (x)
-				  * (((((((( - 0.00420059  * p
-						     + 0.01787654) * p
-						     - 0.02895312) * p
-						     + 0.02282967) * p
-						     - 0.01031555) * p
-						     + 0.00163801) * p
-						     - 0.00362018) * p
-						     - 0.03988024) * p
-						     + 0.39894228);
-		}
 	}
-	return res;
+	else
+	{
+		p = 3.75 / x;
+		s = 1.0 / sqrt (x);
+		*i0e = s * (((((((( + 0.00392377  * p
+						   - 0.01647633) * p
+						   + 0.02635537) * p
+						   - 0.02057706) * p
+						   + 0.00916281) * p
+						   - 0.00157565) * p
+						   + 0.00225319) * p
+						   + 0.01328592) * p
+						   + 0.39894228);
+		*i1e = s * (((((((( - 0.00420059  * p
+						   + 0.01787654) * p
+						   - 0.02895312) * p
+						   + 0.02282967) * p
+						   - 0.01031555) * p
+						   + 0.00163801) * p
+						   - 0.00362018) * p
+						   - 0.03988024) * p
+						   + 0.39894228);
+	}
 }
 
-// EXPONENTIAL INTEGRAL, E1(x)
+// EXPONENTIAL INTEGRAL, E1(x), Polynomial and Rational Approximations
 // M. Abramowitz and I. Stegun, Eds., "Handbook of Mathematical Functions."  Washington, DC:  National
-//      Bureau of Standards, 1964.
-// Shanjie Zhang and Jianming Jin, "Computation of Special Functions."  New York, NY, John Wiley and Sons,
-//      Inc., 1996.  [Sample code given in FORTRAN]
+//      Bureau of Standards, 1964.  [5.1.53 and 5.1.56]
+//
+// x <= 1:  E1(x) = -ln(x) + e1_poly(x), |error| < 2e-7
+// x >  1:  E1(x) = exp(-x) / x * e1_rat(x), relative error < 2e-8
 
-double e1xb (double x)
+static double e1_poly (double x)
 {
-	double e1, ga, r, t, t0;
-	int k, m;
-	if (x == 0.0) 
-		e1 = 1.0e300;
-	else if (x <= 1.0)
-	{
-        e1 = 1.0;
-        r = 1.0;
+	return ((((( 0.00107857  * x
+			   - 0.00976004) * x
+			   + 0.05519968) * x
+			   - 0.24991055) * x
+			   + 0.99999193) * x
+			   - 0.57721566);
+}
 
-        for (k = 1; k <= 25; k++)
+static double e1_rat (double x)
+{
+	return ((((x + 8.5733287401) * x + 18.0590169730) * x + 8.6347608925) * x + 0.2677737343)
+		 / ((((x + 9.5733223454) * x + 25.6329561486) * x + 21.0996530827) * x + 3.9584969228);
+}
+
+/********************************************************************************************************
+*																										*
+*										Gain Tables for Method 2										*
+*																										*
+********************************************************************************************************/
+
+// GG and GGS are 241 x 241 tables, row 'nxi' and column 'ngamma', on a 0.25 dB grid from 0.001 to 1000 in
+// both xi and gamma.  One float copy of each is built per process, shared by all EMNR instances and never
+// written again.  It is blocked in row pairs:  entry (nxi, ngamma) holds T[nxi][ngamma] and
+// T[nxi + 1][ngamma], so the four corners of a cell are four consecutive floats.
+
+#define GG_DIM		241
+#define GG_PAIRS	(2 * (GG_DIM - 1) * GG_DIM)
+
+static struct _gg_tab
+{
+	float* GG;
+	float* GGS;
+} gg_tab;
+
+static volatile LONG gg_tab_state = 0;		// 0, not built; 1, building; 2, ready
+
+static float* build_gg_pairs (const double* T)
+{
+	int nxi, ng;
+	float* P = (float *) malloc0 (GG_PAIRS * sizeof (float));
+	for (nxi = 0; nxi < GG_DIM - 1; nxi++)
+		for (ng = 0; ng < GG_DIM; ng++)
 		{
-			r = -r * k * x / ((k + 1.0)*(k + 1.0));
-			e1 = e1 + r;
-			if ( fabs (r) <= fabs (e1) * 1.0e-15 )
-				break;
-        }
-
-        ga = 0.5772156649015328;
-        e1 = - ga - log (x) + x * e1;
-	}
-      else
+			P[2 * (GG_DIM * nxi + ng) + 0] = (float)T[GG_DIM * (nxi + 0) + ng];
+			P[2 * (GG_DIM * nxi + ng) + 1] = (float)T[GG_DIM * (nxi + 1) + ng];
+		}
+	return P;
+}
+
+static void init_gg_tables (void)
+{
+	// a file named "calculus" in the working directory, if present and complete, replaces the compiled tables
+	FILE* fileb;
+	double* fbuff = NULL;
+	const double* gg = GG;
+	const double* ggs = GGS;
+	if (gg_tab_state == 2) return;
+	if (InterlockedCompareExchange (&gg_tab_state, 1, 0) == 0)
 	{
-        m = 20 + (int)(80.0 / x);
-        t0 = 0.0;
-        for (k = m; k >= 1; k--)
-			t0 = (double)k / (1.0 + k / (x + t0));
-        t = 1.0 / (x + t0);
-        e1 = exp (- x) * t;
+		if (fileb = fopen ("calculus", "rb"))
+		{
+			fbuff = (double *) malloc0 (2 * GG_DIM * GG_DIM * sizeof (double));
+			if (fread (fbuff, sizeof (double), 2 * GG_DIM * GG_DIM, fileb) == 2 * GG_DIM * GG_DIM)
+			{
+				gg = fbuff;
+				ggs = fbuff + GG_DIM * GG_DIM;
+			}
+			fclose (fileb);
+		}
+		gg_tab.GG = build_gg_pairs (gg);
+		gg_tab.GGS = build_gg_pairs (ggs);
+		_aligned_free (fbuff);
+		InterlockedExchange (&gg_tab_state, 2);
 	}
-    return e1;
+	else
+		while (gg_tab_state != 2) Sleep (0);
 }
 
 /********************************************************************************************************
@@ -308,42 +329,14 @@ void calc_emnr(EMNR a)
 		3.100, 3.380, 4.150, 4.350, 4.250, 3.900, 4.100, 4.700, 5.000 };
 	a->incr = a->fsize / a->ovrlp;
 	a->gain = a->ogain / a->fsize / (double)a->ovrlp;
-	if (a->fsize > a->bsize)
-		a->iasize = a->fsize;
-	else
-		a->iasize = a->bsize + a->fsize - a->incr;
-	a->iainidx = 0;
-	a->iaoutidx = 0;
-	if (a->fsize > a->bsize)
-	{
-		if (a->bsize > a->incr)  a->oasize = a->bsize;
-		else					 a->oasize = a->incr;
-		a->oainidx = (a->fsize - a->bsize - a->incr) % a->oasize;
-	}
-	else
-	{
-		a->oasize = a->bsize;
-		a->oainidx = a->fsize - a->incr;
-	}
-	a->init_oainidx = a->oainidx;
-	a->oaoutidx = 0;
 	a->msize = a->fsize / 2 + 1;
 	a->window = (double *)malloc0(a->fsize * sizeof(double));
-	a->inaccum = (double *)malloc0(a->iasize * sizeof(double));
-	a->forfftin = (double *)malloc0(a->fsize * sizeof(double));
-	a->forfftout = (double *)malloc0(a->msize * sizeof(complex));
 	a->mask = (double *)malloc0(a->msize * sizeof(double));
-	a->revfftin = (double *)malloc0(a->msize * sizeof(complex));
-	a->revfftout = (double *)malloc0(a->fsize * sizeof(double));
-	a->save = (double **)malloc0(a->ovrlp * sizeof(double *));
-	for (i = 0; i < a->ovrlp; i++)
-		a->save[i] = (double *)malloc0(a->fsize * sizeof(double));
-	a->outaccum = (double *)malloc0(a->oasize * sizeof(double));
-	a->nsamps = 0;
-	a->saveidx = 0;
-	a->Rfor = fftw_plan_dft_r2c_1d(a->fsize, a->forfftin, (fftw_complex *)a->forfftout, FFTW_ESTIMATE);
-	a->Rrev = fftw_plan_dft_c2r_1d(a->fsize, (fftw_complex *)a->revfftin, a->revfftout, FFTW_ESTIMATE);
+	a->stft = create_stft (a->bsize, a->fsize, a->ovrlp);
+	a->forfftout = a->stft->forfftout;
+	a->revfftin = a->stft->revfftin;
 	calc_window(a);
+	setWindow_stft (a->stft, a->window, 1.0, 1.0);
 	//
 	// g
 	a->g.msize = a->msize;
@@ -353,6 +346,10 @@ void calc_emnr(EMNR a)
 	a->g.lambda_d    = (double*)malloc0(a->msize * sizeof(double));
 	a->g.prev_gamma  = (double*)malloc0(a->msize * sizeof(double));
 	a->g.prev_mask   = (double*)malloc0(a->msize * sizeof(double));
+	a->g.gamma       = (double*)malloc0(a->msize * sizeof(double));
+	a->g.xi          = (double*)malloc0(a->msize * sizeof(double));
+	a->g.v           = (double*)malloc0(a->msize * sizeof(double));
+	a->g.ex          = (double*)malloc0(a->msize * sizeof(double));
 
 	a->g.gf1p5 = sqrt(PI) / 2.0;
 	{
@@ -370,19 +367,9 @@ void calc_emnr(EMNR a)
 	}
 	a->g.gmax = 10000.0;
 	//
-	a->g.GG = (double *)malloc0(241 * 241 * sizeof(double));
-	a->g.GGS = (double *)malloc0(241 * 241 * sizeof(double));
-	if (a->g.fileb = fopen("calculus", "rb"))
-	{
-		fread(a->g.GG, sizeof(double), 241 * 241, a->g.fileb);
-		fread(a->g.GGS, sizeof(double), 241 * 241, a->g.fileb);
-		fclose(a->g.fileb);
-	}
-	else
-	{
-		memcpy (a->g.GG,  GG,  241 * 241 * sizeof(double));
-		memcpy (a->g.GGS, GGS, 241 * 241 * sizeof(double));
-	}
+	init_gg_tables();
+	a->g.GG = gg_tab.GG;
+	a->g.GGS = gg_tab.GGS;
 	//
 	a->g.dim_zeta = 60;
 	a->g.zeta_hat = (double*)malloc0(a->g.dim_zeta * a->g.dim_zeta * sizeof(double));
@@ -612,25 +599,17 @@ void decalc_emnr(EMNR a)
 	// g
 	_aligned_free(a->g.zeta_true);
 	_aligned_free(a->g.zeta_hat);
-	_aligned_free(a->g.GGS);
-	_aligned_free(a->g.GG);
+	_aligned_free(a->g.ex);
+	_aligned_free(a->g.v);
+	_aligned_free(a->g.xi);
+	_aligned_free(a->g.gamma);
 	_aligned_free(a->g.prev_mask);
 	_aligned_free(a->g.prev_gamma);
 	_aligned_free(a->g.lambda_d);
 	_aligned_free(a->g.lambda_y);
 	//
-	fftw_destroy_plan(a->Rrev);
-	fftw_destroy_plan(a->Rfor);
-	_aligned_free(a->outaccum);
-	for (i = 0; i < a->ovrlp; i++)
-		_aligned_free(a->save[i]);
-	_aligned_free(a->save);
-	_aligned_free(a->revfftout);
-	_aligned_free(a->revfftin);
+	destroy_stft (a->stft);
 	_aligned_free(a->mask);
-	_aligned_free(a->forfftout);
-	_aligned_free(a->forfftin);
-	_aligned_free(a->inaccum);
 	_aligned_free(a->window);
 }
 
@@ -658,17 +637,7 @@ EMNR create_emnr (int run, int position, int size, double* in, double* out, int
 
 void flush_emnr (EMNR a)
 {
-	int i;
-	memset (a->inaccum, 0, a->iasize * sizeof (double));
-	for (i = 0; i < a->ovrlp; i++)
-		memset (a->save[i], 0, a->fsize * sizeof (double));
-	memset (a->outaccum, 0, a->oasize * sizeof (double));
-	a->nsamps   = 0;
-	a->iainidx  = 0;
-	a->iaoutidx = 0;
-	a->oainidx  = a->init_oainidx;
-	a->oaoutidx = 0;
-	a->saveidx  = 0;
+	flush_stft (a->stft);
 }
 
 void destroy_emnr (EMNR a)
@@ -701,26 +670,21 @@ void LambdaD(EMNR a)
 		sum_lambda_y += a->np.lambda_y[k];
 		sum_prev_sigma2N += a->np.sigma2N[k];
 	}
-	for (k = 0; k < a->np.msize; k++)
-	{
-		f0 = a->np.p[k] / a->np.sigma2N[k] - 1.0;
-		a->np.alphaOptHat[k] = 1.0 / (1.0 + f0 * f0);
-	}
 	SNR = sum_prev_p / sum_prev_sigma2N;
 	alphaMin = min (a->np.alphaMin_max_value, pow (SNR, a->np.snrq));
-	for (k = 0; k < a->np.msize; k++)
-		if (a->np.alphaOptHat[k] < alphaMin) a->np.alphaOptHat[k] = alphaMin;
 	f1 = sum_prev_p / sum_lambda_y - 1.0;
 	alphaCtilda = 1.0 / (1.0 + f1 * f1);
 	a->np.alphaC = a->np.alphaCsmooth * a->np.alphaC + (1.0 - a->np.alphaCsmooth) * max (alphaCtilda, a->np.alphaCmin);
 	f2 = a->np.alphaMax * a->np.alphaC;
-	for (k = 0; k < a->np.msize; k++)
-		a->np.alphaHat[k] = f2 * a->np.alphaOptHat[k];
-	for (k = 0; k < a->np.msize; k++)
-		a->np.p[k] = a->np.alphaHat[k] * a->np.p[k] + (1.0 - a->np.alphaHat[k]) * a->np.lambda_y[k];
+	// everything up to the bias correction depends only on bin 'k', so it is done in one pass
 	invQbar = 0.0;
 	for (k = 0; k < a->np.msize; k++)
 	{
+		f0 = a->np.p[k] / a->np.sigma2N[k] - 1.0;
+		a->np.alphaOptHat[k] = 1.0 / (1.0 + f0 * f0);
+		if (a->np.alphaOptHat[k] < alphaMin) a->np.alphaOptHat[k] = alphaMin;
+		a->np.alphaHat[k] = f2 * a->np.alphaOptHat[k];
+		a->np.p[k] = a->np.alphaHat[k] * a->np.p[k] + (1.0 - a->np.alphaHat[k]) * a->np.lambda_y[k];
 		beta = min (a->np.betamax, a->np.alphaHat[k] * a->np.alphaHat[k]);
 		a->np.pbar[k] = beta * a->np.pbar[k] + (1.0 - beta) * a->np.p[k];
 		a->np.p2bar[k] = beta * a->np.p2bar[k] + (1.0 - beta) * a->np.p[k] * a->np.p[k];
@@ -729,25 +693,21 @@ void LambdaD(EMNR a)
 		if (invQeq > a->np.invQeqMax) invQeq = a->np.invQeqMax;
 		a->np.Qeq[k] = 1.0 / invQeq;
 		invQbar += invQeq;
-	}
-	invQbar /= (double)a->np.msize;
-	bc = 1.0 + a->np.av * sqrt (invQbar);
-	for (k = 0; k < a->np.msize; k++)
-	{
 		QeqTilda    = (a->np.Qeq[k] - 2.0 * a->np.MofD) / (1.0 - a->np.MofD);
 		QeqTildaSub = (a->np.Qeq[k] - 2.0 * a->np.MofV) / (1.0 - a->np.MofV);
 		a->np.bmin[k]     = 1.0 + 2.0 * (a->np.D - 1.0) / QeqTilda;
 		a->np.bmin_sub[k] = 1.0 + 2.0 * (a->np.V - 1.0) / QeqTildaSub;
 	}
-	memset (a->np.k_mod, 0, a->np.msize * sizeof (int));
+	invQbar /= (double)a->np.msize;
+	bc = 1.0 + a->np.av * sqrt (invQbar);
 	for (k = 0; k < a->np.msize; k++)
 	{
 		f3 = a->np.p[k] * a->np.bmin[k] * bc;
-		if (f3 < a->np.actmin[k])
+		a->np.k_mod[k] = f3 < a->np.actmin[k];
+		if (a->np.k_mod[k])
 		{
 			a->np.actmin[k] = f3;
 			a->np.actmin_sub[k] = a->np.p[k] * a->np.bmin_sub[k] * bc;
-			a->np.k_mod[k] = 1;
 		}
 	}
 	if (a->np.subwc == a->np.V)
@@ -805,9 +765,12 @@ void LambdaD(EMNR a)
 void LambdaDs (EMNR a)
 {
 	int k;
+	for (k = 0; k < a->nps.msize; k++)
+		a->nps.PH1y[k] = - a->nps.epsH1r * a->nps.lambda_y[k] / a->nps.sigma2N[k];
+	vexp (a->nps.msize, a->nps.PH1y, a->nps.PH1y);
 	for (k = 0; k < a->nps.msize; k++)
 	{
-		a->nps.PH1y[k] = 1.0 / (1.0 + (1.0 + a->nps.epsH1) * exp (- a->nps.epsH1r * a->nps.lambda_y[k] / a->nps.sigma2N[k]));
+		a->nps.PH1y[k] = 1.0 / (1.0 + (1.0 + a->nps.epsH1) * a->nps.PH1y[k]);
 		a->nps.Pbar[k] = a->nps.alpha_Pbar * a->nps.Pbar[k] + (1.0 - a->nps.alpha_Pbar) * a->nps.PH1y[k];
 		if (a->nps.Pbar[k] > 0.99)
 			a->nps.PH1y[k] = min (a->nps.PH1y[k], 0.99);
@@ -998,52 +961,6 @@ void SetRXAEMNRpost2Rate(int channel, double tc)
 *										End Post-Processing Functions									*
 ********************************************************************************************************/
 
-double getKey(double* type, double gamma, double xi)
-{
-	int ngamma1, ngamma2, nxi1, nxi2;
-	double tg, tx, dg, dx;
-	const double dmin = 0.001;
-	const double dmax = 1000.0;
-	if (gamma <= dmin)
-	{
-		ngamma1 = ngamma2 = 0;
-		tg = 0.0;
-	}
-	else if (gamma >= dmax)
-	{
-		ngamma1 = ngamma2 = 240;
-		tg = 60.0;
-	}
-	else
-	{
-		tg = 10.0 * log10(gamma / dmin);
-		ngamma1 = (int)(4.0 * tg);
-		ngamma2 = ngamma1 + 1;
-	}
-	if (xi <= dmin)
-	{
-		nxi1 = nxi2 = 0;
-		tx = 0.0;
-	}
-	else if (xi >= dmax)
-	{
-		nxi1 = nxi2 = 240;
-		tx = 60.0;
-	}
-	else
-	{
-		tx = 10.0 * log10(xi / dmin);
-		nxi1 = (int)(4.0 * tx);
-		nxi2 = nxi1 + 1;
-	}
-	dg = (tg - 0.25 * ngamma1) / 0.25;
-	dx = (tx - 0.25 * nxi1) / 0.25;
-	return (1.0 - dg)  * (1.0 - dx) * type[241 * nxi1 + ngamma1]
-		+  (1.0 - dg)  *        dx  * type[241 * nxi2 + ngamma1]
-		+         dg   * (1.0 - dx) * type[241 * nxi1 + ngamma2]
-		+         dg   *        dx  * type[241 * nxi2 + ngamma2];
-}
-
 int getZeta( EMNR a, double gamma, double eps, double* zeta)
 {
 	int index, i_gamma, i_xi;
@@ -1066,9 +983,151 @@ int getZeta( EMNR a, double gamma, double eps, double* zeta)
 	return 0;
 }
 
+static void calc_snr (EMNR a, double* gamma, double* xi)
+{
+	// a posteriori snr, limited to gamma_max, and the decision-directed a priori snr estimate
+	int k;
+	for (k = 0; k < a->msize; k++)
+	{
+		gamma[k] = min (a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
+		xi[k] = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
+			+ (1.0 - a->g.alpha) * max (gamma[k] - 1.0, a->g.eps_floor);
+	}
+}
+
+static void stsa_gain (EMNR a, double* gamma, double* xi)
+{
+	// Ephraim-Malah amplitude estimator weighted by the probability of speech presence, into a->g.mask.
+	// 'xi' is limited to xi_min in place.  With exp(-v/2) computed in bulk, exp(-v/2) * I0(v/2) and
+	// exp(-v/2) * I1(v/2) need no further exponentials, and the speech-presence weight
+	// witchHat / (1 + witchHat) = 1 / (1 + q / (1 - q) * (1 + eps) * exp(-v)) reuses the same one.
+	// v < gamma_max, so the former limit of v to 700 never applies.
+	int k;
+	double* v = a->g.v;
+	double* ex = a->g.ex;
+	double i0e, i1e, m, eps;
+	double qr = a->g.q / (1.0 - a->g.q);
+	for (k = 0; k < a->msize; k++)
+	{
+		xi[k] = max (xi[k], a->g.xi_min);
+		v[k] = (xi[k] / (1.0 + xi[k])) * gamma[k];
+		ex[k] = -0.5 * v[k];
+	}
+	vexp (a->msize, ex, ex);
+	for (k = 0; k < a->msize; k++)
+	{
+		bessI01e (0.5 * v[k], ex[k], &i0e, &i1e);
+		m = a->g.gf1p5 * sqrt (v[k]) / gamma[k] * ((1.0 + v[k]) * i0e + v[k] * i1e);
+		eps = m * m * a->g.lambda_y[k] / a->g.lambda_d[k] / (1.0 - a->g.q);
+		m /= 1.0 + qr * (1.0 + eps) * ex[k] * ex[k];
+		if (m > a->g.gmax) m = a->g.gmax;
+		if (m != m) m = 0.01;
+		a->g.mask[k] = m;
+	}
+}
+
+static void lsa_gain (EMNR a, double* gamma, double* xi)
+{
+	// log-spectral amplitude estimator, ehr * exp (E1(v) / 2), into a->g.mask.  For v <= 1 the -ln(v) term
+	// of E1 becomes a division by sqrt(v); otherwise E1 needs exp(-v).  Either way E1 / 2 < 0.3 (v > 0), so
+	// the former limit of 700 never applies; v = 0 is raised to 1e-300, where the gain saturates as before.
+	int k;
+	double* v = a->g.v;
+	double* ex = a->g.ex;
+	double m;
+	for (k = 0; k < a->msize; k++)
+	{
+		xi[k] = xi[k] / (1.0 + xi[k]);
+		v[k] = max (xi[k] * gamma[k], 1.0e-300);
+		ex[k] = - v[k];
+	}
+	vexp (a->msize, ex, ex);
+	for (k = 0; k < a->msize; k++)
+	{
+		if (v[k] <= 1.0)
+		{
+			ex[k] = 0.5 * e1_poly (v[k]);
+			a->g.mask[k] = xi[k] / sqrt (v[k]);
+		}
+		else
+		{
+			ex[k] = 0.5 * ex[k] / v[k] * e1_rat (v[k]);
+			a->g.mask[k] = xi[k];
+		}
+	}
+	vexp (a->msize, ex, ex);
+	for (k = 0; k < a->msize; k++)
+	{
+		m = a->g.mask[k] * ex[k];
+		if (m > a->g.gmax) m = a->g.gmax;
+		if (m != m) m = 0.01;
+		a->g.mask[k] = m;
+	}
+}
+
+static void gg_coord (int n, double* t, double* x)
+{
+	// t = 40 * log10 (x / 0.001), the table coordinate in 0.25 dB cells.
+	// log2 (x) is split into its exponent and a mantissa in [sqrt(0.5), sqrt(2)), whose log is an
+	// atanh series accurate to 1.0e-9; there are no calls or table lookups, so the loop vectorizes.
+	const double c2 = 12.041199826559248;		// 40 * log10 (2)
+	const double ce = 17.371779276130073;		// 40 * log10 (e)
+	int k;
+	uint64_t b;
+	double e, m, z, z2;
+	for (k = 0; k < n; k++)
+	{
+		memcpy (&b, &x[k], sizeof (b));
+		e = (double)((int)((b >> 52) & 0x7ff) - 1023);
+		b = (b & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+		memcpy (&m, &b, sizeof (m));
+		if (m > 1.4142135623730951)
+		{
+			m *= 0.5;
+			e += 1.0;
+		}
+		z = (m - 1.0) / (m + 1.0);
+		z2 = z * z;
+		z = 2.0 * z * (1.0 + z2 * (1.0 / 3.0 + z2 * (1.0 / 5.0 + z2 * (1.0 / 7.0 + z2 * (1.0 / 9.0)))));
+		t[k] = c2 * e + ce * z + 120.0;
+	}
+}
+
+static void table_gain (EMNR a, double* gamma, double* xi)
+{
+	// GG(gamma, xi) * GGS(gamma, xi / (1 - q)), bilinear in the 0.25 dB grid and held at its edges
+	int k, ng, nx, nxs;
+	double* tg = a->g.v;
+	double* tx = a->g.ex;
+	double cq = -40.0 * log10 (1.0 - a->g.q);
+	double t, dg, dx, dxs;
+	const float* p;
+	const float* s;
+	gg_coord (a->msize, tg, gamma);
+	gg_coord (a->msize, tx, xi);
+	for (k = 0; k < a->msize; k++)
+	{
+		t = max (0.0, min (tg[k], 240.0));
+		ng = min ((int)t, 239);
+		dg = t - ng;
+		t = max (0.0, min (tx[k], 240.0));
+		nx = min ((int)t, 239);
+		dx = t - nx;
+		t = max (0.0, min (tx[k] + cq, 240.0));
+		nxs = min ((int)t, 239);
+		dxs = t - nxs;
+		p = a->g.GG  + 2 * (GG_DIM * nx  + ng);
+		s = a->g.GGS + 2 * (GG_DIM * nxs + ng);
+		a->g.mask[k] = ((1.0 - dg) * ((1.0 - dx)  * p[0] + dx  * p[1]) + dg * ((1.0 - dx)  * p[2] + dx  * p[3]))
+					 * ((1.0 - dg) * ((1.0 - dxs) * s[0] + dxs * s[1]) + dg * ((1.0 - dxs) * s[2] + dxs * s[3]));
+	}
+}
+
 void calc_gain (EMNR a)
 {
 	int k;
+	double* gamma = a->g.gamma;
+	double* xi = a->g.xi;
 	for (k = 0; k < a->g.msize; k++)
 	{
 		a->g.lambda_y[k] = a->g.y[2 * k + 0] * a->g.y[2 * k + 0] + a->g.y[2 * k + 1] * a->g.y[2 * k + 1];
@@ -1089,108 +1148,45 @@ void calc_gain (EMNR a)
 	{
 	case 0:
 		{
-			double gamma, eps_hat, v;
-			for (k = 0; k < a->g.msize; k++)
-			{
-				gamma = min (a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
-				eps_hat = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
-					+ (1.0 - a->g.alpha) * max (gamma - 1.0, a->g.eps_floor);
-				eps_hat = max(eps_hat, a->g.xi_min);
-				v = (eps_hat / (1.0 + eps_hat)) * gamma;
-				a->g.mask[k] = a->g.gf1p5 * sqrt (v) / gamma * exp (- 0.5 * v)
-					* ((1.0 + v) * bessI0 (0.5 * v) + v * bessI1 (0.5 * v));
-				{
-					double v2 = min (v, 700.0);
-					double eta = a->g.mask[k] * a->g.mask[k] * a->g.lambda_y[k] / a->g.lambda_d[k];
-					double eps = eta / (1.0 - a->g.q);
-					double witchHat = (1.0 - a->g.q) / a->g.q * exp (v2) / (1.0 + eps);
-					a->g.mask[k] *= witchHat / (1.0 + witchHat);
-				}
-				if (a->g.mask[k] > a->g.gmax) a->g.mask[k] = a->g.gmax;
-				if (a->g.mask[k] != a->g.mask[k]) a->g.mask[k] = 0.01;
-				a->g.prev_gamma[k] = gamma;
-				a->g.prev_mask[k] = a->g.mask[k];
-			}
+			calc_snr (a, gamma, xi);
+			stsa_gain (a, gamma, xi);
+			memcpy (a->g.prev_gamma, gamma, a->msize * sizeof (double));
+			memcpy (a->g.prev_mask, a->g.mask, a->msize * sizeof (double));
 			break;
 		}
 	case 1:
 		{
-			double gamma, eps_hat, v, ehr;
-			for (k = 0; k < a->g.msize; k++)
-			{
-				gamma = min (a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
-				eps_hat = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
-					+ (1.0 - a->g.alpha) * max (gamma - 1.0, a->g.eps_floor);
-				ehr = eps_hat / (1.0 + eps_hat);
-				v = ehr * gamma;
-				if((a->g.mask[k] = ehr * exp (min (700.0, 0.5 * e1xb(v)))) > a->g.gmax) a->g.mask[k] = a->g.gmax;
-				if (a->g.mask[k] != a->g.mask[k])a->g.mask[k] = 0.01;
-				a->g.prev_gamma[k] = gamma;
-				a->g.prev_mask[k] = a->g.mask[k];
-			}
+			calc_snr (a, gamma, xi);
+			lsa_gain (a, gamma, xi);
+			memcpy (a->g.prev_gamma, gamma, a->msize * sizeof (double));
+			memcpy (a->g.prev_mask, a->g.mask, a->msize * sizeof (double));
 			break;
 		}
 	case 2:
 		{
-			double gamma, eps_hat, eps_p;
-			for (k = 0; k < a->g.msize; k++)
-			{
-				gamma = min(a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
-				eps_hat = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
-					+ (1.0 - a->g.alpha) * max(gamma - 1.0, a->g.eps_floor);
-				eps_p = eps_hat / (1.0 - a->g.q);
-				a->g.mask[k] = getKey(a->g.GG, gamma, eps_hat) * getKey(a->g.GGS, gamma, eps_p);
-				a->g.prev_gamma[k] = gamma;
-				a->g.prev_mask[k] = a->g.mask[k];
-			}
+			calc_snr (a, gamma, xi);
+			table_gain (a, gamma, xi);
+			memcpy (a->g.prev_gamma, gamma, a->msize * sizeof (double));
+			memcpy (a->g.prev_mask, a->g.mask, a->msize * sizeof (double));
 			break;
 		}
 	case 3:
 		{
-			double gamma, xi_hat, v, zeta_hat;
-			for (k = 0; k < a->g.msize; k++)
-			{
-				gamma = min(a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
-				xi_hat = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
-					+ (1.0 - a->g.alpha) * max(gamma - 1.0, a->g.eps_floor);
-				xi_hat = max(xi_hat, a->g.xi_min);
-				v = (xi_hat / (1.0 + xi_hat)) * gamma;
-				a->g.mask[k] = a->g.gf1p5 * sqrt(v) / gamma * exp(-0.5 * v)
-					* ((1.0 + v) * bessI0(0.5 * v) + v * bessI1(0.5 * v));
-				{
-					double v2 = min(v, 700.0);
-					double eta = a->g.mask[k] * a->g.mask[k] * a->g.lambda_y[k] / a->g.lambda_d[k];
-					double eps = eta / (1.0 - a->g.q);
-					double witchHat = (1.0 - a->g.q) / a->g.q * exp(v2) / (1.0 + eps);
-					a->g.mask[k] *= witchHat / (1.0 + witchHat);
-				}
-				if (a->g.mask[k] > a->g.gmax) a->g.mask[k] = a->g.gmax;
-				if (a->g.mask[k] != a->g.mask[k]) a->g.mask[k] = 0.01;
-				a->g.prev_mask[k] = a->g.mask[k];
-				a->g.prev_gamma[k] = gamma;
-
-				{
-					double xi_ts = a->g.mask[k] * a->g.mask[k] * gamma;
-					xi_ts = max(xi_ts, a->g.xi_min);
-					double v_ts = (xi_ts / (1.0 + xi_ts)) * gamma;
-					a->g.mask[k] = a->g.gf1p5 * sqrt(v_ts) / gamma * exp(-0.5 * v_ts)
-						* ((1.0 + v_ts) * bessI0(0.5 * v_ts) + v_ts * bessI1(0.5 * v_ts));
-					double v2 = min(v_ts, 700.0);
-					double eta = a->g.mask[k] * a->g.mask[k] * a->g.lambda_y[k] / a->g.lambda_d[k];
-					double eps = eta / (1.0 - a->g.q);
-					double witchHat = (1.0 - a->g.q) / a->g.q * exp(v2) / (1.0 + eps);
-					a->g.mask[k] *= witchHat / (1.0 + witchHat);
-					xi_hat = xi_ts;
-				}
-				if (a->g.mask[k] > a->g.gmax) a->g.mask[k] = a->g.gmax;
-				if (a->g.mask[k] != a->g.mask[k]) a->g.mask[k] = 0.01;
-
-				if (getZeta(a, gamma, xi_hat, &zeta_hat) >= 0)
+			double zeta_hat;
+			calc_snr (a, gamma, xi);
+			stsa_gain (a, gamma, xi);
+			memcpy (a->g.prev_gamma, gamma, a->msize * sizeof (double));
+			memcpy (a->g.prev_mask, a->g.mask, a->msize * sizeof (double));
+			// second pass with the a priori snr re-estimated from the first-pass mask
+			for (k = 0; k < a->msize; k++)
+				xi[k] = a->g.mask[k] * a->g.mask[k] * gamma[k];
+			stsa_gain (a, gamma, xi);
+			for (k = 0; k < a->msize; k++)
+				if (getZeta(a, gamma[k], xi[k], &zeta_hat) >= 0)
 				{
 					if (zeta_hat > a->g.zeta_thresh) a->g.mask[k] = 1.0;
 					else                             a->g.mask[k] = 0.0;
 				}
-			}
 			break;
 		}
 	}
@@ -1201,21 +1197,11 @@ void xemnr (EMNR a, int pos)
 {
 	if (a->run && pos == a->position)
 	{
-		int i, j, k, sbuff, sbegin;
+		int i;
 		double g1;
-		for (i = 0; i < 2 * a->bsize; i += 2)
+		xstft_in (a->stft, a->in);
+		while (xstft_frame (a->stft))
 		{
-			a->inaccum[a->iainidx] = a->in[i];
-			a->iainidx = (a->iainidx + 1) % a->iasize;
-		}
-		a->nsamps += a->bsize;
-		while (a->nsamps >= a->fsize)
-		{
-			for (i = 0, j = a->iaoutidx; i < a->fsize; i++, j = (j + 1) % a->iasize)
-				a->forfftin[i] = a->window[i] * a->inaccum[j];
-			a->iaoutidx = (a->iaoutidx + a->incr) % a->iasize;
-			a->nsamps -= a->incr;
-			fftw_execute (a->Rfor);
 			calc_gain(a);
 			for (i = 0; i < a->msize; i++)
 			{
@@ -1224,30 +1210,9 @@ void xemnr (EMNR a, int pos)
 				a->revfftin[2 * i + 1] = g1 * a->forfftout[2 * i + 1];
 			}
 			post2(a);
-			fftw_execute (a->Rrev);
-			for (i = 0; i < a->fsize; i++)
-				a->save[a->saveidx][i] = a->window[i] * a->revfftout[i];
-			for (i = a->ovrlp; i > 0; i--)
-			{
-				sbuff = (a->saveidx + i) % a->ovrlp;
-				sbegin = a->incr * (a->ovrlp - i);
-				for (j = sbegin, k = a->oainidx; j < a->incr + sbegin; j++, k = (k + 1) % a->oasize)
-				{
-					if ( i == a->ovrlp)
-						a->outaccum[k]  = a->save[sbuff][j];
-					else
-						a->outaccum[k] += a->save[sbuff][j];
-				}
-			}
-			a->saveidx = (a->saveidx + 1) % a->ovrlp;
-			a->oainidx = (a->oainidx + a->incr) % a->oasize;
-		}
-		for (i = 0; i < a->bsize; i++)
-		{
-			a->out[2 * i + 0] = a->outaccum[a->oaoutidx];
-			a->out[2 * i + 1] = 0.0;
-			a->oaoutidx = (a->oaoutidx + 1) % a->oasize;
+			xstft_ola (a->stft);
 		}
+		xstft_out (a->stft, a->out);
 	}
 	else if (a->out != a->in)
 		memcpy (a->out, a->in, a->bsize * sizeof (complex));
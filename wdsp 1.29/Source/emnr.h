@@ -38,30 +38,15 @@ typedef struct _emnr
 	int ovrlp;
 	int incr;
 	double* window;
-	int iasize;
-	double* inaccum;
-	double* forfftin;
-	double* forfftout;
+	struct _stft *stft;				// framing, ffts, and overlap-add (see stft.h)
+	double* forfftout;				// stft->forfftout
 	int msize;
 	double* mask;
-	double* revfftin;
-	double* revfftout;
-	double** save;
-	int oasize;
-	double* outaccum;
+	double* revfftin;				// stft->revfftin
 	double rate;
 	int wintype;
 	double ogain;
 	double gain;
-	int nsamps;
-	int iainidx;
-	int iaoutidx;
-	int init_oainidx;
-	int oainidx;
-	int oaoutidx;
-	int saveidx;
-	fftw_plan Rfor;
-	fftw_plan Rrev;
 	struct _g
 	{
 		int gain_method;
@@ -74,6 +59,10 @@ typedef struct _emnr
 		double* lambda_d;
 		double* prev_mask;
 		double* prev_gamma;
+		double* gamma;				// per-frame scratch, msize each:  a posteriori snr,
+		double* xi;					//   a priori snr,
+		double* v;					//   gain function argument,
+		double* ex;					//   and exponentials
 		double gf1p5;
 		double alpha;
 		double eps_floor;
@@ -82,9 +71,8 @@ typedef struct _emnr
 		double q;
 		double gmax;
 		//
-		double* GG;
-		double* GGS;
-		FILE* fileb;
+		const float* GG;			// shared gain tables for method 2, see emnr.c
+		const float* GGS;
 		//
 		int dim_zeta;
 		double* zeta_hat;
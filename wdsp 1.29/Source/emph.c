@@ -32,7 +32,7 @@ warren@wpratt.com
 *																										*
 ********************************************************************************************************/
 
-EMPHP create_emphp (int run, int position, int size, int nc, int mp, double* in, double* out, int rate, int ctype, double f_low, double f_high)
+EMPHP create_emphp (int run, int position, int size, int nc, int mp, double* in, double* out, int rate, int ctype, double f_low, double f_high, int precision)
 {
 	EMPHP a = (EMPHP) malloc0 (sizeof (emphp));
 	double* impulse;
@@ -48,7 +48,7 @@ EMPHP create_emphp (int run, int position, int size, int nc, int mp, double* in,
 	a->f_low = f_low;
 	a->f_high = f_high;
 	impulse = fc_impulse (a->nc, a->f_low, a->f_high, -20.0 * log10(a->f_high / a->f_low), 0.0, a->ctype, a->rate, 1.0 / (2.0 * a->size), 0, 0);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse, precision);
 	_aligned_free (impulse);
 	return a;
 }
@@ -170,14 +170,18 @@ void calc_emph (EMPH a)
 	a->infilt = (double *)malloc0(2 * a->size * sizeof(complex));
 	a->product = (double *)malloc0(2 * a->size * sizeof(complex));
 	a->mults = fc_mults(a->size, a->f_low, a->f_high, -20.0 * log10(a->f_high / a->f_low), 0.0, a->ctype, a->rate, 1.0 / (2.0 * a->size), 0, 0);
+	enter_fftplanner ();
 	a->CFor = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->infilt, (fftw_complex *)a->product, FFTW_FORWARD, FFTW_PATIENT);
 	a->CRev = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->product, (fftw_complex *)a->out, FFTW_BACKWARD, FFTW_PATIENT);
+	leave_fftplanner ();
 }
 
 void decalc_emph (EMPH a)
 {
+	enter_fftplanner ();
 	fftw_destroy_plan(a->CRev);
 	fftw_destroy_plan(a->CFor);
+	leave_fftplanner ();
 	_aligned_free(a->mults);
 	_aligned_free(a->product);
 	_aligned_free(a->infilt);
@@ -50,7 +50,7 @@ typedef struct _emphp
 } emphp, *EMPHP;
 
 extern EMPHP create_emphp (int run, int position, int size, int nc, int mp, 
-	double* in, double* out, int rate, int ctype, double f_low, double f_high);
+	double* in, double* out, int rate, int ctype, double f_low, double f_high, int precision);
 
 extern void destroy_emphp (EMPHP a);
 
@@ -199,7 +199,7 @@ double* eq_impulse (int N, int nfreqs, double* F, double* G, double samplerate,
 *																										*
 ********************************************************************************************************/
 
-EQP create_eqp (int run, int size, int nc, int mp, double *in, double *out, int nfreqs, double* F, double* G, int ctfmode, int wintype, int samplerate)
+EQP create_eqp (int run, int size, int nc, int mp, double *in, double *out, int nfreqs, double* F, double* G, int ctfmode, int wintype, int samplerate, int precision)
 {
 	// NOTE:  'nc' must be >= 'size'
 	EQP a = (EQP) malloc0 (sizeof (eqp));
@@ -219,7 +219,7 @@ EQP create_eqp (int run, int size, int nc, int mp, double *in, double *out, int
 	a->wintype = wintype;
 	a->samplerate = (double)samplerate;
 	impulse = eq_impulse (a->nc, a->nfreqs, a->F, a->G, a->samplerate, 1.0 / (2.0 * a->size), a->ctfmode, a->wintype);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse, precision);
 	_aligned_free (impulse);
 	return a;
 }
@@ -573,15 +573,19 @@ void calc_eq (EQ a)
 	a->scale = 1.0 / (double)(2 * a->size);
 	a->infilt = (double *)malloc0(2 * a->size * sizeof(complex));
 	a->product = (double *)malloc0(2 * a->size * sizeof(complex));
+	enter_fftplanner ();
 	a->CFor = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->infilt, (fftw_complex *)a->product, FFTW_FORWARD, FFTW_PATIENT);
 	a->CRev = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->product, (fftw_complex *)a->out, FFTW_BACKWARD, FFTW_PATIENT);
+	leave_fftplanner ();
 	a->mults = eq_mults(a->size, a->nfreqs, a->F, a->G, a->samplerate, a->scale, a->ctfmode, a->wintype);
 }
 
 void decalc_eq (EQ a)
 {
+	enter_fftplanner ();
 	fftw_destroy_plan(a->CRev);
 	fftw_destroy_plan(a->CFor);
+	leave_fftplanner ();
 	_aligned_free(a->mults);
 	_aligned_free(a->product);
 	_aligned_free(a->infilt);
@@ -53,7 +53,7 @@ typedef struct _eqp
 extern double* eq_impulse (int N, int nfreqs, double* F, double* G, double samplerate, double scale, int ctfmode, int wintype);
 
 extern EQP create_eqp (int run, int size, int nc, int mp, double *in, double *out, 
-	int nfreqs, double* F, double* G, int ctfmode, int wintype, int samplerate);
+	int nfreqs, double* F, double* G, int ctfmode, int wintype, int samplerate, int precision);
 
 extern void destroy_eqp (EQP a);
 
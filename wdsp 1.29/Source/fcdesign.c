@@ -0,0 +1,345 @@
+/*  fcdesign.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at
+
+warren@wpratt.com
+
+*/
+
+#include "comm.h"
+
+/********************************************************************************************************
+*																										*
+*										Background Filter Design										*
+*																										*
+********************************************************************************************************/
+
+typedef struct _fcdjob
+{
+	void* obj;						// object being designed, e.g., a BANDPASS
+	fcd_func func;					// design function
+	int channel;
+	int id;							// request identifier reported to the callback
+	double params[FCD_MAXPARAMS];	// parameters of the latest request
+	int queued;						// waiting in the ready queue
+	int running;					// being designed by a worker
+	int pending;					// re-queue when the running design completes
+	int coalesced;					// requests merged into this one since it was last started
+	LARGE_INTEGER t_post;			// time of the latest request
+	struct _fcdjob* next;			// all jobs
+	struct _fcdjob* qnext;			// ready queue
+} fcdjob, *FCDJOB;
+
+static struct _fcd
+{
+	CRITICAL_SECTION cs;
+	HANDLE sem;						// wakes workers; counts are hints only, workers re-check the queue
+	HANDLE idle;					// set when a running design completes; wakes cancel_fcdesign()
+	FCDJOB jobs;
+	FCDJOB qhead;
+	FCDJOB qtail;
+	int nthreads;					// requested number of workers; 0 designs on the calling thread
+	int nrunning;					// number of live workers
+	double tscale;					// milliseconds per performance-counter tick
+	void (*done)(int channel, int id, int coalesced, double latency);
+	int completed;
+	int coalesced;
+	double last_latency;
+	double max_latency;
+} fcd;
+
+static volatile LONG fcd_state = 0;	// 0, not initialized; 1, initializing; 2, ready
+
+static void init_fcdesign (void)
+{
+	LARGE_INTEGER freq;
+	if (fcd_state == 2) return;
+	if (InterlockedCompareExchange (&fcd_state, 1, 0) == 0)
+	{
+		InitializeCriticalSectionAndSpinCount (&fcd.cs, 2500);
+		fcd.sem = CreateSemaphore (0, 0, 1 << 20, 0);
+		fcd.idle = CreateEvent (0, TRUE, FALSE, 0);
+		fcd.nthreads = FCD_DEFAULT_THREADS;
+		QueryPerformanceFrequency (&freq);
+		fcd.tscale = 1000.0 / (double)freq.QuadPart;
+		InterlockedExchange (&fcd_state, 2);
+	}
+	else
+		while (fcd_state != 2) Sleep (0);
+}
+
+static void enqueue_fcdjob (FCDJOB j)
+{
+	j->qnext = NULL;
+	if (fcd.qtail) fcd.qtail->qnext = j;
+	else           fcd.qhead = j;
+	fcd.qtail = j;
+	j->queued = 1;
+	ReleaseSemaphore (fcd.sem, 1, 0);
+}
+
+static void unqueue_fcdjob (FCDJOB j)
+{
+	FCDJOB* pp = &fcd.qhead;
+	fcd.qtail = NULL;
+	while (*pp)
+	{
+		if (*pp == j)
+			*pp = j->qnext;
+		else
+		{
+			fcd.qtail = *pp;
+			pp = &(*pp)->qnext;
+		}
+	}
+	j->queued = 0;
+}
+
+static double record_fcdjob (LARGE_INTEGER* t_post, int coalesced)
+{
+	// call with fcd.cs held; returns the latency in milliseconds
+	LARGE_INTEGER t_done;
+	double latency;
+	QueryPerformanceCounter (&t_done);
+	latency = (double)(t_done.QuadPart - t_post->QuadPart) * fcd.tscale;
+	fcd.completed++;
+	fcd.coalesced += coalesced;
+	fcd.last_latency = latency;
+	if (latency > fcd.max_latency) fcd.max_latency = latency;
+	return latency;
+}
+
+static void run_fcdjob (FCDJOB j)
+{
+	// call with fcd.cs held and 'j' at the head of the queue; the lock is released while 'j' is designed
+	double params[FCD_MAXPARAMS];
+	LARGE_INTEGER t_post;
+	int channel, id, coalesced;
+	double latency;
+	void (*done)(int, int, int, double);
+	unqueue_fcdjob (j);
+	j->running = 1;
+	memcpy (params, j->params, FCD_MAXPARAMS * sizeof (double));
+	t_post = j->t_post;
+	coalesced = j->coalesced;
+	j->coalesced = 0;
+	LeaveCriticalSection (&fcd.cs);
+	j->func (j->obj, j->channel, params);
+	EnterCriticalSection (&fcd.cs);
+	j->running = 0;
+	SetEvent (fcd.idle);
+	channel = j->channel;
+	id = j->id;
+	if (j->pending)
+	{
+		j->pending = 0;
+		enqueue_fcdjob (j);
+	}
+	latency = record_fcdjob (&t_post, coalesced);
+	done = fcd.done;
+	LeaveCriticalSection (&fcd.cs);
+	if (done) done (channel, id, coalesced, latency);
+	EnterCriticalSection (&fcd.cs);
+}
+
+static void fcd_worker (void* arg)
+{
+	(void)arg;
+	EnterCriticalSection (&fcd.cs);
+	while (1)
+	{
+		if (fcd.nrunning > fcd.nthreads && (fcd.nthreads > 0 || fcd.qhead == NULL))
+			break;
+		if (fcd.qhead == NULL)
+		{
+			LeaveCriticalSection (&fcd.cs);
+			WaitForSingleObject (fcd.sem, INFINITE);
+			EnterCriticalSection (&fcd.cs);
+			continue;
+		}
+		run_fcdjob (fcd.qhead);
+	}
+	fcd.nrunning--;
+	LeaveCriticalSection (&fcd.cs);
+	_endthread ();
+}
+
+static void start_fcd_workers (void)
+{
+	// call with fcd.cs held; if no worker is alive and none can be started, the queue is designed on the
+	// calling thread, so that no request is left waiting for a worker that does not exist
+	while (fcd.nrunning < fcd.nthreads)
+	{
+		fcd.nrunning++;
+		if (_beginthread (fcd_worker, 0, 0) == (uintptr_t)-1L)
+		{
+			fcd.nrunning--;
+			break;
+		}
+	}
+	if (fcd.nrunning == 0)
+		while (fcd.qhead)
+			run_fcdjob (fcd.qhead);
+}
+
+void post_fcdesign (void* obj, fcd_func func, int channel, int id, int nparams, double* params)
+{
+	FCDJOB j;
+	LARGE_INTEGER t_post;
+	double p[FCD_MAXPARAMS] = { 0.0 };
+	double latency;
+	void (*done)(int, int, int, double);
+	init_fcdesign ();
+	memcpy (p, params, nparams * sizeof (double));
+	EnterCriticalSection (&fcd.cs);
+	if (fcd.nthreads == 0)
+	{
+		// synchronous mode:  design on the calling thread, as before
+		LeaveCriticalSection (&fcd.cs);
+		QueryPerformanceCounter (&t_post);
+		func (obj, channel, p);
+		EnterCriticalSection (&fcd.cs);
+		latency = record_fcdjob (&t_post, 0);
+		done = fcd.done;
+		LeaveCriticalSection (&fcd.cs);
+		if (done) done (channel, id, 0, latency);
+		return;
+	}
+	for (j = fcd.jobs; j; j = j->next)
+		if (j->obj == obj && j->func == func) break;
+	if (j == NULL)
+	{
+		j = (FCDJOB) malloc0 (sizeof (fcdjob));
+		j->obj = obj;
+		j->func = func;
+		j->next = fcd.jobs;
+		fcd.jobs = j;
+	}
+	j->channel = channel;
+	j->id = id;
+	memcpy (j->params, p, FCD_MAXPARAMS * sizeof (double));
+	QueryPerformanceCounter (&j->t_post);
+	if (j->queued || j->pending)
+		j->coalesced++;							// the waiting request is superseded
+	else if (j->running)
+		j->pending = 1;
+	else
+		enqueue_fcdjob (j);
+	start_fcd_workers ();
+	LeaveCriticalSection (&fcd.cs);
+}
+
+void cancel_fcdesign (void* obj)
+{
+	// discard waiting requests for 'obj' and wait for a running one to finish; call before destroying 'obj'
+	FCDJOB j;
+	FCDJOB* pp;
+	int busy;
+	init_fcdesign ();
+	EnterCriticalSection (&fcd.cs);
+	do
+	{
+		busy = 0;
+		for (j = fcd.jobs; j; j = j->next)
+			if (j->obj == obj)
+			{
+				if (j->queued) unqueue_fcdjob (j);
+				j->pending = 0;
+				busy |= j->running;
+			}
+		if (busy)
+		{
+			// 'idle' is reset under the lock, so a completion after this point sets it again
+			ResetEvent (fcd.idle);
+			LeaveCriticalSection (&fcd.cs);
+			WaitForSingleObject (fcd.idle, INFINITE);
+			EnterCriticalSection (&fcd.cs);
+		}
+	} while (busy);
+	pp = &fcd.jobs;
+	while (*pp)
+	{
+		if ((*pp)->obj == obj)
+		{
+			j = *pp;
+			*pp = j->next;
+			_aligned_free (j);
+		}
+		else
+			pp = &(*pp)->next;
+	}
+	LeaveCriticalSection (&fcd.cs);
+}
+
+/********************************************************************************************************
+*																										*
+*											Properties													*
+*																										*
+********************************************************************************************************/
+
+PORT
+void SetFilterDesignThreads (int nthreads)
+{
+	// 0 restores synchronous design on the calling thread; workers drain the queue before exiting
+	init_fcdesign ();
+	EnterCriticalSection (&fcd.cs);
+	fcd.nthreads = nthreads < 0 ? 0 : nthreads;
+	if (fcd.nrunning > fcd.nthreads)
+		ReleaseSemaphore (fcd.sem, fcd.nrunning, 0);
+	if (fcd.qhead)
+		start_fcd_workers ();
+	LeaveCriticalSection (&fcd.cs);
+}
+
+PORT
+void SetFilterDesignCallback (void (*done)(int channel, int id, int coalesced, double latency))
+{
+	// 'done' runs on the design thread after a design has been published; 'latency' is in milliseconds,
+	// measured from the request whose parameters were used
+	init_fcdesign ();
+	EnterCriticalSection (&fcd.cs);
+	fcd.done = done;
+	LeaveCriticalSection (&fcd.cs);
+}
+
+PORT
+void GetFilterDesignStats (int* completed, int* coalesced, double* last_latency, double* max_latency)
+{
+	init_fcdesign ();
+	EnterCriticalSection (&fcd.cs);
+	*completed = fcd.completed;
+	*coalesced = fcd.coalesced;
+	*last_latency = fcd.last_latency;
+	*max_latency = fcd.max_latency;
+	LeaveCriticalSection (&fcd.cs);
+}
+
+PORT
+void ResetFilterDesignStats (void)
+{
+	init_fcdesign ();
+	EnterCriticalSection (&fcd.cs);
+	fcd.completed = 0;
+	fcd.coalesced = 0;
+	fcd.last_latency = 0.0;
+	fcd.max_latency = 0.0;
+	LeaveCriticalSection (&fcd.cs);
+}
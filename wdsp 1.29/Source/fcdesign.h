@@ -0,0 +1,65 @@
+/*  fcdesign.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at
+
+warren@wpratt.com
+
+*/
+
+/********************************************************************************************************
+*																										*
+*										Background Filter Design										*
+*																										*
+********************************************************************************************************/
+
+// Filter designs (impulse generation, minimum-phase conversion, mask FFTs) are queued here and run on a
+// small pool of worker threads so that property calls from the GUI return immediately.  Requests are
+// coalesced by (object, function):  if a design for the same object and function is still waiting, its
+// parameters are overwritten by the newer request.  A design function computes into the inactive mask
+// set of its fircore and then publishes with the usual 'cset' flip.
+
+#ifndef _fcdesign_h
+#define _fcdesign_h
+
+#define FCD_MAXPARAMS			4
+#define FCD_DEFAULT_THREADS		2
+
+// request identifiers passed to the completion callback
+#define FCD_RXA_BP_FREQS		0
+#define FCD_RXA_BP_WINDOW		1
+#define FCD_RXA_BP_NC			2
+#define FCD_RXA_BP_MP			3
+
+typedef void (*fcd_func)(void* obj, int channel, double* params);
+
+extern void post_fcdesign (void* obj, fcd_func func, int channel, int id, int nparams, double* params);
+
+extern void cancel_fcdesign (void* obj);
+
+extern __declspec (dllexport) void SetFilterDesignThreads (int nthreads);
+
+extern __declspec (dllexport) void SetFilterDesignCallback (void (*done)(int channel, int id, int coalesced, double latency));
+
+extern __declspec (dllexport) void GetFilterDesignStats (int* completed, int* coalesced, double* last_latency, double* max_latency);
+
+extern __declspec (dllexport) void ResetFilterDesignStats (void);
+
+#endif
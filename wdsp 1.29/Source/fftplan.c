@@ -0,0 +1,175 @@
+/*  fftplan.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at
+
+warren@wpratt.com
+
+*/
+
+#include "comm.h"
+
+/********************************************************************************************************
+*																										*
+*										Shared FFTW Plan Registry										*
+*																										*
+********************************************************************************************************/
+
+#define PLAN_ALIGN		64		// covers the SIMD alignment FFTW may assume (16 for SSE2, 32 for AVX, 64 for AVX-512)
+
+#define PLAN_C2C		0
+#define PLAN_R2C		1
+
+typedef struct _plan_entry
+{
+	int kind;					// PLAN_C2C or PLAN_R2C
+	int size;					// transform length
+	int howmany;				// number of contiguous transforms per execution
+	int sign;					// FFTW_FORWARD or FFTW_BACKWARD
+	int precision;				// 0 for double, 1 for float
+	int inplace;				// 1 if planned with in == out
+	void* plan;					// fftw_plan or fftwf_plan
+	struct _plan_entry* next;
+} plan_entry;
+
+static plan_entry* plan_head = NULL;
+static int plan_count = 0;
+static CRITICAL_SECTION cs_plan;
+static volatile LONG cs_plan_state = 0;		// 0, not initialized; 1, initializing; 2, ready
+
+static void init_plan_registry (void)
+{
+	// the registry is used from create_xxx() on any thread, so the lock is set up on first use
+	if (cs_plan_state == 2) return;
+	if (InterlockedCompareExchange (&cs_plan_state, 1, 0) == 0)
+	{
+		InitializeCriticalSectionAndSpinCount (&cs_plan, 2500);
+		InterlockedExchange (&cs_plan_state, 2);
+	}
+	else
+		while (cs_plan_state != 2) Sleep (0);
+}
+
+static plan_entry* find_plan (int kind, int size, int howmany, int sign, int precision, int inplace)
+{
+	plan_entry* e;
+	for (e = plan_head; e; e = e->next)
+		if (e->kind == kind && e->size == size && e->howmany == howmany && e->sign == sign &&
+			e->precision == precision && e->inplace == inplace)
+			return e;
+	return NULL;
+}
+
+static plan_entry* add_plan (int kind, int size, int howmany, int sign, int precision, int inplace)
+{
+	// Plan on aligned scratch arrays so that the planner never touches live data.
+	// The planner is not thread-safe.  'cs_plan' is held here, and every planner call made outside the
+	// registry takes it through enter_fftplanner(), so batches planned on analyzer workers are serialized
+	// against filter designs and the GUI thread as well.
+	plan_entry* e = (plan_entry *) malloc0 (sizeof (plan_entry));
+	int osize = (kind == PLAN_R2C) ? size / 2 + 1 : size;
+	int bytes = howmany * size * (precision ? 2 * sizeof (float) : sizeof (complex));
+	char* in = (char *) _aligned_malloc (bytes, PLAN_ALIGN);
+	char* out = inplace ? in : (char *) _aligned_malloc (bytes, PLAN_ALIGN);
+	e->kind = kind;
+	e->size = size;
+	e->howmany = howmany;
+	e->sign = sign;
+	e->precision = precision;
+	e->inplace = inplace;
+	if (kind == PLAN_R2C)
+		// batches are planned with FFTW_MEASURE since they may be created on an analyzer worker thread
+		e->plan = (void *) fftw_plan_many_dft_r2c (1, &size, howmany, (double *)in, NULL, 1, size,
+			(fftw_complex *)out, NULL, 1, osize, howmany > 1 ? FFTW_MEASURE : FFTW_PATIENT);
+	else if (precision)
+		e->plan = (void *) fftwf_plan_many_dft (1, &size, howmany, (fftwf_complex *)in, NULL, 1, size,
+			(fftwf_complex *)out, NULL, 1, size, sign, FFTW_MEASURE);
+	else
+		e->plan = (void *) fftw_plan_many_dft (1, &size, howmany, (fftw_complex *)in, NULL, 1, size,
+			(fftw_complex *)out, NULL, 1, size, sign, howmany > 1 ? FFTW_MEASURE : FFTW_PATIENT);
+	if (!inplace) _aligned_free (out);
+	_aligned_free (in);
+	e->next = plan_head;
+	plan_head = e;
+	plan_count++;
+	return e;
+}
+
+static void* get_plan (int kind, int size, int howmany, int sign, int precision, void* in, void* out)
+{
+	plan_entry* e;
+	int inplace = (in == out);
+	init_plan_registry ();
+	EnterCriticalSection (&cs_plan);
+	if ((e = find_plan (kind, size, howmany, sign, precision, inplace)) == NULL)
+		e = add_plan (kind, size, howmany, sign, precision, inplace);
+	LeaveCriticalSection (&cs_plan);
+	return e->plan;
+}
+
+fftw_plan get_fftplan (int size, int sign, double* in, double* out)
+{
+	return (fftw_plan) get_plan (PLAN_C2C, size, 1, sign, 0, in, out);
+}
+
+fftwf_plan get_fftplanf (int size, int sign, float* in, float* out)
+{
+	return (fftwf_plan) get_plan (PLAN_C2C, size, 1, sign, 1, in, out);
+}
+
+fftw_plan get_fftplan_many (int size, int howmany, int sign, double* in, double* out)
+{
+	return (fftw_plan) get_plan (PLAN_C2C, size, howmany, sign, 0, in, out);
+}
+
+fftw_plan get_fftplan_r2c (int size, int howmany, double* in, double* out)
+{
+	return (fftw_plan) get_plan (PLAN_R2C, size, howmany, FFTW_FORWARD, 0, in, out);
+}
+
+void* fftmalloc0 (int size)
+{
+	// zeroed like malloc0(), but cache-line aligned; free with _aligned_free()
+	void* p = _aligned_malloc (size, PLAN_ALIGN);
+	if (p != 0) memset (p, 0, size);
+	return p;
+}
+
+void enter_fftplanner (void)
+{
+	init_plan_registry ();
+	EnterCriticalSection (&cs_plan);
+}
+
+void leave_fftplanner (void)
+{
+	LeaveCriticalSection (&cs_plan);
+}
+
+PORT
+int GetFFTPlanCount (void)
+{
+	int count;
+	init_plan_registry ();
+	EnterCriticalSection (&cs_plan);
+	count = plan_count;
+	LeaveCriticalSection (&cs_plan);
+	return count;
+}
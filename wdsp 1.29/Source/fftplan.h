@@ -0,0 +1,66 @@
+/*  fftplan.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at
+
+warren@wpratt.com
+
+*/
+
+/********************************************************************************************************
+*																										*
+*										Shared FFTW Plan Registry										*
+*																										*
+********************************************************************************************************/
+
+// Complex 1-D DFT plans are created once per (size, direction, precision, placement) and shared by every
+// caller for the life of the process.  Plans are run with the new-array interface, i.e.,
+// fftw_execute_dft(plan, in, out), so the arrays given to the getter only determine the placement (in-place
+// or not).  Plans are made on 64-byte aligned scratch, so every array they execute on must be at least
+// 16-byte aligned (fftw_alignment_of() == 0); fftmalloc0() allocates zeroed 64-byte aligned arrays, and
+// malloc0() and fftw_malloc() arrays also qualify.
+// Batched plans run 'howmany' transforms stored back to back, each 'size' points long (size / 2 + 1
+// complex outputs each for real-to-complex).
+//
+// The FFTW planner is not thread-safe.  Plans made outside the registry, and every fftw_destroy_plan()
+// and wisdom call, must be bracketed by enter_fftplanner() and leave_fftplanner(), which take the same
+// lock the registry plans under.  fftw_execute() and its new-array variants need no lock.
+
+#ifndef _fftplan_h
+#define _fftplan_h
+#include "comm.h"
+
+extern fftw_plan  get_fftplan  (int size, int sign, double* in, double* out);
+
+extern fftwf_plan get_fftplanf (int size, int sign, float* in, float* out);
+
+extern fftw_plan  get_fftplan_many (int size, int howmany, int sign, double* in, double* out);
+
+extern fftw_plan  get_fftplan_r2c (int size, int howmany, double* in, double* out);
+
+extern void* fftmalloc0 (int size);
+
+extern void enter_fftplanner (void);
+
+extern void leave_fftplanner (void);
+
+PORT int GetFFTPlanCount (void);
+
+#endif
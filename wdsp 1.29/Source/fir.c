@@ -30,13 +30,18 @@ double* fftcv_mults (int NM, double* c_impulse)
 {
 	double* mults        = (double *) malloc0 (NM * sizeof (complex));
 	double* cfft_impulse = (double *) malloc0 (NM * sizeof (complex));
-	fftw_plan ptmp = fftw_plan_dft_1d(NM, (fftw_complex *) cfft_impulse,
+	fftw_plan ptmp;
+	enter_fftplanner ();
+	ptmp = fftw_plan_dft_1d(NM, (fftw_complex *) cfft_impulse,
 			(fftw_complex *) mults, FFTW_FORWARD, FFTW_PATIENT);
+	leave_fftplanner ();
 	memset (cfft_impulse, 0, NM * sizeof (complex));
 	// store complex coefs right-justified in the buffer
 	memcpy (&(cfft_impulse[NM - 2]), c_impulse, (NM / 2 + 1) * sizeof(complex));
 	fftw_execute (ptmp);
+	enter_fftplanner ();
 	fftw_destroy_plan (ptmp);
+	leave_fftplanner ();
 	_aligned_free (cfft_impulse);
 	return mults;
 }
@@ -88,8 +93,11 @@ double* fir_fsamp_odd (int N, double* A, int rtype, double scale, int wintype)
 	double* window;
 	double *fcoef     = (double *) malloc0 (N * sizeof (complex));
 	double *c_impulse = (double *) malloc0 (N * sizeof (complex));
-	fftw_plan ptmp = fftw_plan_dft_1d(N, (fftw_complex *)fcoef, (fftw_complex *)c_impulse, FFTW_BACKWARD, FFTW_PATIENT);
+	fftw_plan ptmp;
 	double local_scale = 1.0 / (double)N;
+	enter_fftplanner ();
+	ptmp = fftw_plan_dft_1d(N, (fftw_complex *)fcoef, (fftw_complex *)c_impulse, FFTW_BACKWARD, FFTW_PATIENT);
+	leave_fftplanner ();
 	for (i = 0; i <= mid; i++)
 	{
 		mag = A[i] * local_scale;
@@ -103,7 +111,9 @@ double* fir_fsamp_odd (int N, double* A, int rtype, double scale, int wintype)
 		fcoef[2 * i + 1] = - fcoef[2 * (mid - j) + 1];
 	}
 	fftw_execute (ptmp);
+	enter_fftplanner ();
 	fftw_destroy_plan (ptmp);
+	leave_fftplanner ();
 	_aligned_free (fcoef);
 	window = get_fsamp_window(N, wintype);
 	switch (rtype)
@@ -333,10 +343,18 @@ void analytic (int N, double* in, double* out)
 	double inv_N = 1.0 / (double)N;
 	double two_inv_N = 2.0 * inv_N;
 	double* x = (double *) malloc0 (N * sizeof (complex));
-	fftw_plan pfor = fftw_plan_dft_1d (N, (fftw_complex *) in,
+	double* save = (double *) malloc0 (N * sizeof (complex));
+	fftw_plan pfor, prev;
+	// without wisdom for N, planning overwrites the arrays, 'in' among them
+	memcpy (save, in, N * sizeof (complex));
+	enter_fftplanner ();
+	pfor = fftw_plan_dft_1d (N, (fftw_complex *) in,
 			(fftw_complex *) x, FFTW_FORWARD, FFTW_PATIENT);
-	fftw_plan prev = fftw_plan_dft_1d (N, (fftw_complex *) x,
+	prev = fftw_plan_dft_1d (N, (fftw_complex *) x,
 			(fftw_complex *) out, FFTW_BACKWARD, FFTW_PATIENT);
+	leave_fftplanner ();
+	memcpy (in, save, N * sizeof (complex));
+	_aligned_free (save);
 	fftw_execute (pfor);
 	x[0] *= inv_N;
 	x[1] *= inv_N;
@@ -349,8 +367,10 @@ void analytic (int N, double* in, double* out)
 	x[N + 1] *= inv_N;
 	memset (&x[N + 2], 0, (N - 2) * sizeof (double));
 	fftw_execute (prev);
+	enter_fftplanner ();
 	fftw_destroy_plan (prev);
 	fftw_destroy_plan (pfor);
+	leave_fftplanner ();
 	_aligned_free (x);
 }
 
@@ -376,11 +396,11 @@ void mp_imp (int N, double* fir, double* mpfir, int pfactor, int polarity)
 	HASH_T hf = fnv1a_hash((uint8_t*)fir, arr_len);
 	h ^= hf + GOLDEN_RATIO + (h << 6) + (h >> 2);
 
-	double* imp = get_impulse_cache_entry(MP_CACHE, h, N);
+	const double* imp = acquire_impulse_cache_entry(MP_CACHE, h, N);
 	if (imp)
 	{
-		memcpy(mpfir, imp, N * sizeof(complex)); // need to copy into mpfir
-		_aligned_free (imp);
+		memcpy(mpfir, imp, N * sizeof(complex)); // copy straight from the shared entry into mpfir
+		release_impulse_cache_entry(imp);
 		return;
 	}
 	//
@@ -394,11 +414,14 @@ void mp_imp (int N, double* fir, double* mpfir, int pfactor, int polarity)
 	double* ana     = (double *) malloc0 (size * sizeof (complex));
 	double* impulse = (double *) malloc0 (size * sizeof (complex));
 	double* newfreq = (double *) malloc0 (size * sizeof (complex));
-	memcpy (firpad, fir, N * sizeof (complex));
+	enter_fftplanner ();
 	fftw_plan pfor = fftw_plan_dft_1d (size, (fftw_complex *) firpad,
 			(fftw_complex *) firfreq, FFTW_FORWARD, FFTW_PATIENT);
 	fftw_plan prev = fftw_plan_dft_1d (size, (fftw_complex *) newfreq,
 			(fftw_complex *) impulse, FFTW_BACKWARD, FFTW_PATIENT);
+	leave_fftplanner ();
+	// fill after planning:  without wisdom for 'size', planning overwrites the arrays
+	memcpy (firpad, fir, N * sizeof (complex));
 	// print_impulse("orig_imp.txt", N, fir, 1, 0);
 	fftw_execute (pfor);
 	for (i = 0; i < size; i++)
@@ -424,8 +447,10 @@ void mp_imp (int N, double* fir, double* mpfir, int pfactor, int polarity)
 	else
 		memcpy (mpfir, impulse, N * sizeof (complex));
 	// print_impulse("min_imp.txt", N, mpfir, 1, 0);
+	enter_fftplanner ();
 	fftw_destroy_plan (prev);
 	fftw_destroy_plan (pfor);
+	leave_fftplanner ();
 	_aligned_free (newfreq);
 	_aligned_free (impulse);
 	_aligned_free (ana);
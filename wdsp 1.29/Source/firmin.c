@@ -135,21 +135,21 @@ void plan_firopt (FIROPT a)
 	a->nfor = a->nc / a->size;
 	a->buffidx = 0;
 	a->idxmask = a->nfor - 1;
-	a->fftin = (double *) malloc0 (2 * a->size * sizeof (complex));
+	a->fftin = (double *) fftmalloc0 (2 * a->size * sizeof (complex));
 	a->fftout = (double **) malloc0 (a->nfor * sizeof (double *));
 	a->fmask = (double **) malloc0 (a->nfor * sizeof (double *));
-	a->maskgen = (double *) malloc0 (2 * a->size * sizeof (complex));
+	a->maskgen = (double *) fftmalloc0 (2 * a->size * sizeof (complex));
 	a->pcfor = (fftw_plan *) malloc0 (a->nfor * sizeof (fftw_plan));
 	a->maskplan = (fftw_plan *) malloc0 (a->nfor * sizeof (fftw_plan));
 	for (i = 0; i < a->nfor; i++)
 	{
-		a->fftout[i] = (double *) malloc0 (2 * a->size * sizeof (complex));
-		a->fmask[i] = (double *) malloc0 (2 * a->size * sizeof (complex));
-		a->pcfor[i] = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->fftin, (fftw_complex *)a->fftout[i], FFTW_FORWARD, FFTW_PATIENT);
-		a->maskplan[i] = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->maskgen, (fftw_complex *)a->fmask[i], FFTW_FORWARD, FFTW_PATIENT);
+		a->fftout[i] = (double *) fftmalloc0 (2 * a->size * sizeof (complex));
+		a->fmask[i] = (double *) fftmalloc0 (2 * a->size * sizeof (complex));
+		a->pcfor[i] = get_fftplan (2 * a->size, FFTW_FORWARD, a->fftin, a->fftout[i]);
+		a->maskplan[i] = get_fftplan (2 * a->size, FFTW_FORWARD, a->maskgen, a->fmask[i]);
 	}
-	a->accum = (double *) malloc0 (2 * a->size * sizeof (complex));
-	a->crev = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->accum, (fftw_complex *)a->out, FFTW_BACKWARD, FFTW_PATIENT);
+	a->accum = (double *) fftmalloc0 (2 * a->size * sizeof (complex));
+	a->crev = get_fftplan (2 * a->size, FFTW_BACKWARD, a->accum, a->out);
 }
 
 void calc_firopt (FIROPT a)
@@ -164,7 +164,7 @@ void calc_firopt (FIROPT a)
 		// I right-justified the impulse response => take output from left side of output buff, discard right side
 		// Be careful about flipping an asymmetrical impulse response.
 		memcpy (&(a->maskgen[2 * a->size]), &(impulse[2 * a->size * i]), a->size * sizeof(complex));
-		fftw_execute (a->maskplan[i]);
+		fftw_execute_dft (a->maskplan[i], (fftw_complex *)a->maskgen, (fftw_complex *)a->fmask[i]);
 	}
 	_aligned_free (impulse);
 }
@@ -192,14 +192,11 @@ FIROPT create_firopt (int run, int position, int size, double* in, double* out,
 void deplan_firopt (FIROPT a)
 {
 	int i;
-	fftw_destroy_plan (a->crev);
 	_aligned_free (a->accum);
 	for (i = 0; i < a->nfor; i++)
 	{
 		_aligned_free (a->fftout[i]);
 		_aligned_free (a->fmask[i]);
-		fftw_destroy_plan (a->pcfor[i]);
-		fftw_destroy_plan (a->maskplan[i]);
 	}
 	_aligned_free (a->maskplan);
 	_aligned_free (a->pcfor);
@@ -228,22 +225,18 @@ void xfiropt (FIROPT a, int pos)
 {
 	if (a->run && (a->position == pos))
 	{
-		int i, j, k;
+		int j, k;
 		memcpy (&(a->fftin[2 * a->size]), a->in, a->size * sizeof (complex));
-		fftw_execute (a->pcfor[a->buffidx]);
+		fftw_execute_dft (a->pcfor[a->buffidx], (fftw_complex *)a->fftin, (fftw_complex *)a->fftout[a->buffidx]);
 		k = a->buffidx;
 		memset (a->accum, 0, 2 * a->size * sizeof (complex));
 		for (j = 0; j < a->nfor; j++)
 		{
-			for (i = 0; i < 2 * a->size; i++)
-			{
-				a->accum[2 * i + 0] += a->fftout[k][2 * i + 0] * a->fmask[j][2 * i + 0] - a->fftout[k][2 * i + 1] * a->fmask[j][2 * i + 1];
-				a->accum[2 * i + 1] += a->fftout[k][2 * i + 0] * a->fmask[j][2 * i + 1] + a->fftout[k][2 * i + 1] * a->fmask[j][2 * i + 0];
-			}
+			cmacc (2 * a->size, a->accum, a->fftout[k], a->fmask[j]);
 			k = (k + a->idxmask) & a->idxmask;
 		}
 		a->buffidx = (a->buffidx + 1) & a->idxmask;
-		fftw_execute (a->crev);
+		fftw_execute_dft (a->crev, (fftw_complex *)a->accum, (fftw_complex *)a->out);
 		memcpy (a->fftin, &(a->fftin[2 * a->size]), a->size * sizeof(complex));
 	}
 	else if (a->in != a->out)
@@ -287,6 +280,86 @@ void setFreqs_firopt (FIROPT a, double f_low, double f_high)
 ********************************************************************************************************/
 
 
+void plan_fircore_sp (FIRCORE a)
+{
+	// single-precision buffers; plans are shared through the registry (FFTW_MEASURE, no float wisdom is generated)
+	int i;
+	a->sp.fftin = (float *) fftmalloc0 (2 * a->size * 2 * sizeof (float));
+	a->sp.fftout   = (float **) malloc0 (a->nfor * sizeof (float *));
+	a->sp.fmask    = (float ***) malloc0 (2 * sizeof (float **));
+	a->sp.fmask[0] = (float **) malloc0 (a->nfor * sizeof (float *));
+	a->sp.fmask[1] = (float **) malloc0 (a->nfor * sizeof (float *));
+	a->sp.maskgen = (float *) fftmalloc0 (2 * a->size * 2 * sizeof (float));
+	a->sp.pcfor = (fftwf_plan *) malloc0 (a->nfor * sizeof (fftwf_plan));
+	a->sp.maskplan    = (fftwf_plan **) malloc0 (2 * sizeof (fftwf_plan *));
+	a->sp.maskplan[0] = (fftwf_plan *) malloc0 (a->nfor * sizeof (fftwf_plan));
+	a->sp.maskplan[1] = (fftwf_plan *) malloc0 (a->nfor * sizeof (fftwf_plan));
+	for (i = 0; i < a->nfor; i++)
+	{
+		a->sp.fftout[i]   = (float *) fftmalloc0 (2 * a->size * 2 * sizeof (float));
+		a->sp.fmask[0][i] = (float *) fftmalloc0 (2 * a->size * 2 * sizeof (float));
+		a->sp.fmask[1][i] = (float *) fftmalloc0 (2 * a->size * 2 * sizeof (float));
+		a->sp.pcfor[i] = get_fftplanf (2 * a->size, FFTW_FORWARD, a->sp.fftin, a->sp.fftout[i]);
+		a->sp.maskplan[0][i] = get_fftplanf (2 * a->size, FFTW_FORWARD, a->sp.maskgen, a->sp.fmask[0][i]);
+		a->sp.maskplan[1][i] = get_fftplanf (2 * a->size, FFTW_FORWARD, a->sp.maskgen, a->sp.fmask[1][i]);
+	}
+	a->sp.accum = (float *) fftmalloc0 (2 * a->size * 2 * sizeof (float));
+	a->sp.out   = (float *) fftmalloc0 (2 * a->size * 2 * sizeof (float));
+	a->sp.crev = get_fftplanf (2 * a->size, FFTW_BACKWARD, a->sp.accum, a->sp.out);
+}
+
+void deplan_fircore_sp (FIRCORE a)
+{
+	int i;
+	_aligned_free (a->sp.out);
+	_aligned_free (a->sp.accum);
+	for (i = 0; i < a->nfor; i++)
+	{
+		_aligned_free (a->sp.fftout[i]);
+		_aligned_free (a->sp.fmask[0][i]);
+		_aligned_free (a->sp.fmask[1][i]);
+	}
+	_aligned_free (a->sp.maskplan[0]);
+	_aligned_free (a->sp.maskplan[1]);
+	_aligned_free (a->sp.maskplan);
+	_aligned_free (a->sp.pcfor);
+	_aligned_free (a->sp.maskgen);
+	_aligned_free (a->sp.fmask[0]);
+	_aligned_free (a->sp.fmask[1]);
+	_aligned_free (a->sp.fmask);
+	_aligned_free (a->sp.fftout);
+	_aligned_free (a->sp.fftin);
+}
+
+void xfircore_sp (FIRCORE a)
+{
+	int i, j, k;
+	float* fin = a->sp.fftin + 2 * a->size;
+	for (i = 0; i < 2 * a->size; i++)
+		fin[i] = (float)a->in[i];
+	fftwf_execute_dft (a->sp.pcfor[a->buffidx], (fftwf_complex *)a->sp.fftin, (fftwf_complex *)a->sp.fftout[a->buffidx]);
+	k = a->buffidx;
+	memset (a->sp.accum, 0, 2 * a->size * 2 * sizeof (float));
+	EnterCriticalSection (&a->update);
+	float* accum = a->sp.accum;
+	float** fftout = a->sp.fftout;
+	float** fmask = a->sp.fmask[a->cset];
+	int idxmask = a->idxmask;
+	int sz = a->size;
+	int nfor = a->nfor;
+	for (j = 0; j < nfor; j++)
+	{
+		cmaccf (2 * sz, accum, fftout[k], fmask[j]);
+		k = (k + idxmask) & idxmask;
+	}
+	LeaveCriticalSection (&a->update);
+	a->buffidx = (a->buffidx + 1) & idxmask;
+	fftwf_execute_dft (a->sp.crev, (fftwf_complex *)a->sp.accum, (fftwf_complex *)a->sp.out);
+	for (i = 0; i < 2 * a->size; i++)
+		a->out[i] = (double)a->sp.out[i];
+	memcpy (a->sp.fftin, fin, a->size * 2 * sizeof (float));
+}
+
 void plan_fircore (FIRCORE a)
 {
 	// must call for change in 'nc', 'size', 'out'
@@ -295,35 +368,98 @@ void plan_fircore (FIRCORE a)
 	a->cset = 0;
 	a->buffidx = 0;
 	a->idxmask = a->nfor - 1;
-	a->fftin = (double *) malloc0 (2 * a->size * sizeof (complex));
+	a->masks_ready = 0;
+	if (a->precision)
+	{
+		plan_fircore_sp (a);
+		return;
+	}
+	a->fftin = (double *) fftmalloc0 (2 * a->size * sizeof (complex));
 	a->fftout   = (double **) malloc0 (a->nfor * sizeof (double *));
 	a->fmask    = (double ***) malloc0 (2 * sizeof (double **));
 	a->fmask[0] = (double **) malloc0 (a->nfor * sizeof (double *));
 	a->fmask[1] = (double **) malloc0 (a->nfor * sizeof (double *));
-	a->maskgen = (double *) malloc0 (2 * a->size * sizeof (complex));
+	a->maskgen = (double *) fftmalloc0 (2 * a->size * sizeof (complex));
 	a->pcfor = (fftw_plan *) malloc0 (a->nfor * sizeof (fftw_plan));
 	a->maskplan    = (fftw_plan **) malloc0 (2 * sizeof (fftw_plan *));
 	a->maskplan[0] = (fftw_plan *) malloc0 (a->nfor * sizeof (fftw_plan));
 	a->maskplan[1] = (fftw_plan *) malloc0 (a->nfor * sizeof (fftw_plan));
 	for (i = 0; i < a->nfor; i++)
 	{
-		a->fftout[i]   = (double *) malloc0 (2 * a->size * sizeof (complex));
-		a->fmask[0][i] = (double *) malloc0 (2 * a->size * sizeof (complex));
-		a->fmask[1][i] = (double *) malloc0 (2 * a->size * sizeof (complex));
-		a->pcfor[i] = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->fftin, (fftw_complex *)a->fftout[i], FFTW_FORWARD, FFTW_PATIENT);
-		a->maskplan[0][i] = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->maskgen, (fftw_complex *)a->fmask[0][i], FFTW_FORWARD, FFTW_PATIENT);
-		a->maskplan[1][i] = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->maskgen, (fftw_complex *)a->fmask[1][i], FFTW_FORWARD, FFTW_PATIENT);
+		a->fftout[i]   = (double *) fftmalloc0 (2 * a->size * sizeof (complex));
+		a->fmask[0][i] = (double *) fftmalloc0 (2 * a->size * sizeof (complex));
+		a->fmask[1][i] = (double *) fftmalloc0 (2 * a->size * sizeof (complex));
+		a->pcfor[i] = get_fftplan (2 * a->size, FFTW_FORWARD, a->fftin, a->fftout[i]);
+		a->maskplan[0][i] = get_fftplan (2 * a->size, FFTW_FORWARD, a->maskgen, a->fmask[0][i]);
+		a->maskplan[1][i] = get_fftplan (2 * a->size, FFTW_FORWARD, a->maskgen, a->fmask[1][i]);
 	}
-	a->accum = (double *) malloc0 (2 * a->size * sizeof (complex));
-	a->crev = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->accum, (fftw_complex *)a->out, FFTW_BACKWARD, FFTW_PATIENT);
-	a->masks_ready = 0;
+	a->accum = (double *) fftmalloc0 (2 * a->size * sizeof (complex));
+	a->crev = get_fftplan (2 * a->size, FFTW_BACKWARD, a->accum, a->out);
+}
+
+static HASH_T mask_key_fircore (FIRCORE a)
+{
+	// masks depend on the impulse and on everything that shapes the partitioning and the transform
+	struct Params
+	{
+		int size;
+		int nc;
+		int mp;
+		int precision;
+	};
+	struct Params params;
+	HASH_T h, hi;
+	memset (&params, 0, sizeof (params));
+	params.size = a->size;
+	params.nc = a->nc;
+	params.mp = a->mp;
+	params.precision = a->precision;
+	h = fnv1a_hash (&params, sizeof (params));
+	hi = fnv1a_hash ((uint8_t*)a->impulse, a->nc * sizeof (complex));
+	h ^= hi + GOLDEN_RATIO + (h << 6) + (h >> 2);
+	return h;
+}
+
+static int load_masks_fircore (FIRCORE a, HASH_T key)
+{
+	// copy a cached mask set into the inactive set; returns 0 on a miss
+	int i;
+	int blockN = a->precision ? a->size : 2 * a->size;		// one partition, in units of complex doubles
+	const double* m = acquire_impulse_cache_entry (MASK_CACHE, key, a->nfor * blockN);
+	if (m == NULL) return 0;
+	for (i = 0; i < a->nfor; i++)
+	{
+		if (a->precision)
+			memcpy (a->sp.fmask[1 - a->cset][i], m + 2 * blockN * i, blockN * sizeof (complex));
+		else
+			memcpy (a->fmask[1 - a->cset][i], m + 2 * blockN * i, blockN * sizeof (complex));
+	}
+	release_impulse_cache_entry (m);
+	return 1;
+}
+
+static void save_masks_fircore (FIRCORE a, HASH_T key)
+{
+	if (a->precision)
+		add_blocks_to_cache (MASK_CACHE, key, a->nfor, a->size, (void **)a->sp.fmask[1 - a->cset]);
+	else
+		add_blocks_to_cache (MASK_CACHE, key, a->nfor, 2 * a->size, (void **)a->fmask[1 - a->cset]);
 }
 
 void calc_fircore (FIRCORE a, int flip)
 {
 	// call for change in frequency, rate, wintype, gain
 	// must also call after a call to plan_firopt()
-	int i;
+	int i, j;
+	int cached = mask_cache_active ();
+	HASH_T key = 0;
+	EnterCriticalSection (&a->design);
+	if (cached)
+	{
+		key = mask_key_fircore (a);
+		if (load_masks_fircore (a, key))
+			goto publish;
+	}
 	if (a->mp)
 		mp_imp (a->nc, a->impulse, a->imp, 16, 0);
 	else
@@ -332,9 +468,23 @@ void calc_fircore (FIRCORE a, int flip)
 	{
 		// I right-justified the impulse response => take output from left side of output buff, discard right side
 		// Be careful about flipping an asymmetrical impulse response.
-		memcpy (&(a->maskgen[2 * a->size]), &(a->imp[2 * a->size * i]), a->size * sizeof(complex));
-		fftw_execute (a->maskplan[1 - a->cset][i]);
+		if (a->precision)
+		{
+			float* mg = a->sp.maskgen + 2 * a->size;
+			double* ip = a->imp + 2 * a->size * i;
+			for (j = 0; j < 2 * a->size; j++)
+				mg[j] = (float)ip[j];
+			fftwf_execute_dft (a->sp.maskplan[1 - a->cset][i], (fftwf_complex *)a->sp.maskgen, (fftwf_complex *)a->sp.fmask[1 - a->cset][i]);
+		}
+		else
+		{
+			memcpy (&(a->maskgen[2 * a->size]), &(a->imp[2 * a->size * i]), a->size * sizeof(complex));
+			fftw_execute_dft (a->maskplan[1 - a->cset][i], (fftw_complex *)a->maskgen, (fftw_complex *)a->fmask[1 - a->cset][i]);
+		}
 	}
+	if (cached)
+		save_masks_fircore (a, key);
+publish:
 	a->masks_ready = 1;
 	if (flip)
 	{
@@ -343,17 +493,20 @@ void calc_fircore (FIRCORE a, int flip)
 		LeaveCriticalSection (&a->update);
 		a->masks_ready = 0;
 	}
+	LeaveCriticalSection (&a->design);
 }
 
-FIRCORE create_fircore (int size, double* in, double* out, int nc, int mp, double* impulse)
-{
+FIRCORE create_fircore (int size, double* in, double* out, int nc, int mp, double* impulse, int precision)
+{	// precision:  0 for double, 1 for single-precision (float) masks, delay line and accumulation
 	FIRCORE a = (FIRCORE) malloc0 (sizeof (fircore));
 	a->size = size;
 	a->in = in;
 	a->out = out;
 	a->nc = nc;
 	a->mp = mp;
+	a->precision = precision;
 	InitializeCriticalSectionAndSpinCount (&a->update, 2500);
+	InitializeCriticalSectionAndSpinCount (&a->design, 2500);
 	plan_fircore (a);
 	a->impulse = (double *) malloc0 (a->nc * sizeof (complex));
 	a->imp     = (double *) malloc0 (a->nc * sizeof (complex));
@@ -365,16 +518,17 @@ FIRCORE create_fircore (int size, double* in, double* out, int nc, int mp, doubl
 void deplan_fircore (FIRCORE a)
 {
 	int i;
-	fftw_destroy_plan (a->crev);
+	if (a->precision)
+	{
+		deplan_fircore_sp (a);
+		return;
+	}
 	_aligned_free (a->accum);
 	for (i = 0; i < a->nfor; i++)
 	{
 		_aligned_free (a->fftout[i]);
 		_aligned_free (a->fmask[0][i]);
 		_aligned_free (a->fmask[1][i]);
-		fftw_destroy_plan (a->pcfor[i]);
-		fftw_destroy_plan (a->maskplan[0][i]);
-		fftw_destroy_plan (a->maskplan[1][i]);
 	}
 	_aligned_free (a->maskplan[0]);
 	_aligned_free (a->maskplan[1]);
@@ -393,6 +547,7 @@ void destroy_fircore (FIRCORE a)
 	deplan_fircore (a);
 	_aligned_free (a->imp);
 	_aligned_free (a->impulse);
+	DeleteCriticalSection (&a->design);
 	DeleteCriticalSection (&a->update);
 	_aligned_free (a);
 }
@@ -400,17 +555,31 @@ void destroy_fircore (FIRCORE a)
 void flush_fircore (FIRCORE a)
 {
 	int i; 
-	memset (a->fftin, 0, 2 * a->size * sizeof (complex));
-	for (i = 0; i < a->nfor; i++)
-		memset (a->fftout[i], 0, 2 * a->size * sizeof (complex));
+	if (a->precision)
+	{
+		memset (a->sp.fftin, 0, 2 * a->size * 2 * sizeof (float));
+		for (i = 0; i < a->nfor; i++)
+			memset (a->sp.fftout[i], 0, 2 * a->size * 2 * sizeof (float));
+	}
+	else
+	{
+		memset (a->fftin, 0, 2 * a->size * sizeof (complex));
+		for (i = 0; i < a->nfor; i++)
+			memset (a->fftout[i], 0, 2 * a->size * sizeof (complex));
+	}
 	a->buffidx = 0;
 }
 
 void xfircore (FIRCORE a)
 {
-	int i, j, k;
+	int j, k;
+	if (a->precision)
+	{
+		xfircore_sp (a);
+		return;
+	}
 	memcpy (&(a->fftin[2 * a->size]), a->in, a->size * sizeof (complex));
-	fftw_execute (a->pcfor[a->buffidx]);
+	fftw_execute_dft (a->pcfor[a->buffidx], (fftw_complex *)a->fftin, (fftw_complex *)a->fftout[a->buffidx]);
 	k = a->buffidx;
 	memset (a->accum, 0, 2 * a->size * sizeof (complex));
 	EnterCriticalSection (&a->update);
@@ -423,45 +592,48 @@ void xfircore (FIRCORE a)
 	int nfor = a->nfor;
 	for (j = 0; j < nfor; j++)
 	{
-		for (i = 0; i < 2 * sz; i++)
-		{
-			accum[2 * i + 0] += fftout[k][2 * i + 0] * fmask[cset][j][2 * i + 0] - fftout[k][2 * i + 1] * fmask[cset][j][2 * i + 1];
-			accum[2 * i + 1] += fftout[k][2 * i + 0] * fmask[cset][j][2 * i + 1] + fftout[k][2 * i + 1] * fmask[cset][j][2 * i + 0];
-		}
+		cmacc (2 * sz, accum, fftout[k], fmask[cset][j]);
 		k = (k + idxmask) & idxmask;
 	}
 	LeaveCriticalSection (&a->update);
 	a->buffidx = (a->buffidx + 1) & idxmask;
-	fftw_execute (a->crev);
+	fftw_execute_dft (a->crev, (fftw_complex *)a->accum, (fftw_complex *)a->out);
 	memcpy (a->fftin, &(a->fftin[2 * a->size]), a->size * sizeof(complex));
 }
 
 void setBuffers_fircore (FIRCORE a, double* in, double* out)
 {
+	EnterCriticalSection (&a->design);
 	a->in = in;
 	a->out = out;
 	deplan_fircore (a);
 	plan_fircore (a);
 	calc_fircore (a, 1);
+	LeaveCriticalSection (&a->design);
 }
 
 void setSize_fircore (FIRCORE a, int size)
 {
+	EnterCriticalSection (&a->design);
 	a->size = size;
 	deplan_fircore (a);
 	plan_fircore (a);
 	calc_fircore (a, 1);
+	LeaveCriticalSection (&a->design);
 }
 
 void setImpulse_fircore (FIRCORE a, double* impulse, int update)
 {
+	EnterCriticalSection (&a->design);
 	memcpy (a->impulse, impulse, a->nc * sizeof (complex));
 	calc_fircore (a, update);
+	LeaveCriticalSection (&a->design);
 }
 
 void setNc_fircore (FIRCORE a, int nc, double* impulse)
 {
-	// because of FFT planning, this will probably cause a glitch in audio if done during dataflow
+	// plans come from the shared registry, so this only re-allocates buffers once a size has been seen
+	EnterCriticalSection (&a->design);
 	deplan_fircore (a);
 	_aligned_free (a->impulse);
 	_aligned_free (a->imp);
@@ -471,12 +643,15 @@ void setNc_fircore (FIRCORE a, int nc, double* impulse)
 	a->impulse = (double *) malloc0 (a->nc * sizeof (complex));
 	memcpy (a->impulse, impulse, a->nc * sizeof (complex));
 	calc_fircore (a, 1);
+	LeaveCriticalSection (&a->design);
 }
 
 void setMp_fircore (FIRCORE a, int mp)
 {
+	EnterCriticalSection (&a->design);
 	a->mp = mp;
 	calc_fircore (a, 1);
+	LeaveCriticalSection (&a->design);
 }
 
 void setUpdate_fircore (FIRCORE a)
@@ -102,9 +102,9 @@ typedef struct _firopt
 	int buffidx;			// fft out buffer index
 	int idxmask;			// mask for index computations
 	double* maskgen;		// input for mask generation FFT
-	fftw_plan* pcfor;		// array of forward FFT plans
-	fftw_plan crev;			// reverse fft plan
-	fftw_plan* maskplan;	// plans for frequency domain masks
+	fftw_plan* pcfor;		// array of forward FFT plans, shared (see fftplan.c), not owned
+	fftw_plan crev;			// reverse fft plan, shared
+	fftw_plan* maskplan;	// plans for frequency domain masks, shared
 } firopt, *FIROPT;
 
 extern FIROPT create_firopt (int run, int position, int size, double* in, double* out, 
@@ -132,6 +132,13 @@ extern void setFreqs_firopt (FIROPT a, double f_low, double f_high);
 *																										*
 ********************************************************************************************************/
 
+// With 'precision' 1 the masks, delay line and accumulation are float; the impulse design, the minimum-phase
+// conversion and the 'in' / 'out' buffers stay double.  The single-precision rms error is below 1e-6 of the
+// rms output (tests/fircore_precision.c).  Blocks without a fircore stay double:  shift (its NCO phase would
+// drift in float), resample (a time-domain polyphase FIR between double buffers, where conversions would cost
+// what float saves), wcpagc and emnr (recursive level and noise estimates with long time constants and a wide
+// dynamic range) and meter (negligible cost).
+
 #ifndef _fircore_h
 #define _fircore_h
 
@@ -151,17 +158,31 @@ typedef struct _fircore
 	int buffidx;			// fft out buffer index
 	int idxmask;			// mask for index computations
 	double* maskgen;		// input for mask generation FFT
-	fftw_plan* pcfor;		// array of forward FFT plans
-	fftw_plan crev;			// reverse fft plan
-	fftw_plan** maskplan;	// plans for frequency domain masks
+	fftw_plan* pcfor;		// array of forward FFT plans, shared (see fftplan.c), not owned
+	fftw_plan crev;			// reverse fft plan, shared
+	fftw_plan** maskplan;	// plans for frequency domain masks, shared
 	CRITICAL_SECTION update;
+	CRITICAL_SECTION design;	// serializes mask calculation with re-planning; see fcdesign.c
 	int cset;
 	int mp;
 	int masks_ready;
+	int precision;			// 0 for double, 1 for single-precision (float) processing
+	struct					// single-precision buffers and plans, used when precision == 1
+	{
+		float* fftin;
+		float** fftout;
+		float*** fmask;
+		float* accum;
+		float* maskgen;
+		float* out;			// reverse fft output, converted into 'out'
+		fftwf_plan* pcfor;
+		fftwf_plan crev;
+		fftwf_plan** maskplan;
+	} sp;
 } fircore, *FIRCORE;
 
 extern FIRCORE create_fircore (int size, double* in, double* out, 
-	int nc, int mp, double* impulse);
+	int nc, int mp, double* impulse, int precision);
 
 extern void xfircore (FIRCORE a);
 
@@ -33,7 +33,7 @@ void calc_fmd (FMD a)
 	a->omega_max = TWOPI * a->fmax / a->rate;
 	a->g1 = 1.0 - exp(-2.0 * a->omegaN * a->zeta / a->rate);
 	a->g2 = -a->g1 + 2.0 * (1 - exp(-a->omegaN * a->zeta / a->rate) * cos(a->omegaN / a->rate * sqrt(1.0 - a->zeta * a->zeta)));
-	a->phs = 0.0;
+	init_nco (&a->osc, 0.0);
 	a->fil_out = 0.0;
 	a->omega = 0.0;
 	a->pllpole = a->omegaN * sqrt(2.0 * a->zeta * a->zeta + 1.0 + sqrt((2.0 * a->zeta * a->zeta + 1.0) * (2.0 * a->zeta * a->zeta + 1.0) + 1)) / TWOPI;
@@ -79,7 +79,7 @@ void decalc_fmd (FMD a)
 }
 
 FMD create_fmd( int run, int size, double* in, double* out, int rate, double deviation, double f_low, double f_high, 
-	double fmin, double fmax, double zeta, double omegaN, double tau, double afgain, int sntch_run, double ctcss_freq, int nc_de, int mp_de, int nc_aud, int mp_aud)
+	double fmin, double fmax, double zeta, double omegaN, double tau, double afgain, int sntch_run, double ctcss_freq, int nc_de, int mp_de, int nc_aud, int mp_aud, int precision)
 {
 	FMD a = (FMD) malloc0 (sizeof (fmd));
 	double* impulse;
@@ -103,6 +103,7 @@ FMD create_fmd( int run, int size, double* in, double* out, int rate, double dev
 	a->mp_de = mp_de;
 	a->nc_aud = nc_aud;
 	a->mp_aud = mp_aud;
+	a->precision = precision;
 	a->lim_run = 0;
 	a->lim_pre_gain = 0.4;
 	a->lim_gain = 2.5;
@@ -110,11 +111,11 @@ FMD create_fmd( int run, int size, double* in, double* out, int rate, double dev
 	// de-emphasis filter
 	a->audio = (double *) malloc0 (a->size * sizeof (complex));
 	impulse = fc_impulse (a->nc_de, a->f_low, a->f_high, +20.0 * log10(a->f_high / a->f_low), 0.0, 1, a->rate, 1.0 / (2.0 * a->size), 0, 0);
-	a->pde = create_fircore (a->size, a->audio, a->out, a->nc_de, a->mp_de, impulse);
+	a->pde = create_fircore (a->size, a->audio, a->out, a->nc_de, a->mp_de, impulse, a->precision);
 	_aligned_free (impulse);
 	// audio filter
 	impulse = fir_bandpass(a->nc_aud, 0.8 * a->f_low, 1.1 * a->f_high, a->rate, 0, 1, a->afgain / (2.0 * a->size));
-	a->paud = create_fircore (a->size, a->out, a->out, a->nc_aud, a->mp_aud, impulse);
+	a->paud = create_fircore (a->size, a->out, a->out, a->nc_aud, a->mp_aud, impulse, a->precision);
 	_aligned_free (impulse);
 	return a;
 }
@@ -133,7 +134,7 @@ void flush_fmd (FMD a)
 	memset (a->audio, 0, a->size * sizeof (complex));
 	flush_fircore (a->pde);
 	flush_fircore (a->paud);
-	a->phs = 0.0;
+	flush_nco (&a->osc);
 	a->fil_out = 0.0;
 	a->omega = 0.0;
 	a->fmdc = 0.0;
@@ -151,20 +152,17 @@ void xfmd (FMD a)
 		for (i = 0; i < a->size; i++)
 		{
 			// pll
-			vco[0]  = cos (a->phs);
-			vco[1]  = sin (a->phs);
+			cs_nco (&a->osc, vco);
 			corr[0] = + a->in[2 * i + 0] * vco[0] + a->in[2 * i + 1] * vco[1];
 			corr[1] = - a->in[2 * i + 0] * vco[1] + a->in[2 * i + 1] * vco[0];
 			if ((corr[0] == 0.0) && (corr[1] == 0.0)) corr[0] = 1.0;
-			det = atan2 (corr[1], corr[0]);
+			det = fatan2 (corr[1], corr[0]);
 			del_out = a->fil_out;
 			a->omega += a->g2 * det;
 			if (a->omega < a->omega_min) a->omega = a->omega_min;
 			if (a->omega > a->omega_max) a->omega = a->omega_max;
 			a->fil_out = a->g1 * det + a->omega;
-			a->phs += del_out;
-			while (a->phs >= TWOPI) a->phs -= TWOPI;
-			while (a->phs < 0.0) a->phs += TWOPI;
+			advance_nco (&a->osc, del_out);
 			// dc removal, gain, & demod output
 			a->fmdc = a->mtau * a->fmdc + a->onem_mtau * a->fil_out;
 			a->audio[2 * i + 0] = a->again * (a->fil_out - a->fmdc);
@@ -226,12 +224,12 @@ void setSize_fmd (FMD a, int size)
 	// de-emphasis filter
 	destroy_fircore (a->pde);
 	impulse = fc_impulse (a->nc_de, a->f_low, a->f_high, +20.0 * log10(a->f_high / a->f_low), 0.0, 1, a->rate, 1.0 / (2.0 * a->size), 0, 0);
-	a->pde = create_fircore (a->size, a->audio, a->out, a->nc_de, a->mp_de, impulse);
+	a->pde = create_fircore (a->size, a->audio, a->out, a->nc_de, a->mp_de, impulse, a->precision);
 	_aligned_free (impulse);
 	// audio filter
 	destroy_fircore (a->paud);
 	impulse = fir_bandpass(a->nc_aud, 0.8 * a->f_low, 1.1 * a->f_high, a->rate, 0, 1, a->afgain / (2.0 * a->size));
-	a->paud = create_fircore (a->size, a->out, a->out, a->nc_aud, a->mp_aud, impulse);
+	a->paud = create_fircore (a->size, a->out, a->out, a->nc_aud, a->mp_aud, impulse, a->precision);
 	_aligned_free (impulse);
 	setSize_wcpagc (a->plim, a->size);
 }
@@ -27,6 +27,7 @@ warren@wpratt.com
 #ifndef _fmd_h
 #define _fmd_h
 #include "iir.h"
+#include "nco.h"
 #include "firmin.h"
 #include "wcpAGC.h"
 typedef struct _fmd
@@ -45,7 +46,7 @@ typedef struct _fmd
 	double omega_max;					// pll - maximum lock check parameter
 	double zeta;						// pll - damping factor; as coded, must be <=1.0
 	double omegaN;						// pll - natural frequency
-	double phs;							// pll - phase accumulator
+	nco osc;							// pll - vco
 	double omega;						// pll - locked pll frequency
 	double fil_out;						// pll - filter output
 	double g1, g2;						// pll - filter gain parameters
@@ -67,6 +68,7 @@ typedef struct _fmd
 	FIRCORE paud;
 	int nc_aud;
 	int mp_aud;
+	int precision;				// precision of both filter kernels
 	double afgain;
 	// CTCSS removal
 	SNOTCH sntch;
@@ -81,7 +83,7 @@ typedef struct _fmd
 
 extern FMD create_fmd ( int run, int size, double* in, double* out, int rate, double deviation, 
 	double f_low, double f_high, double fmin, double fmax, double zeta, double omegaN, double tau, 
-	double afgain, int sntch_run, double ctcss_freq, int nc_de, int mp_de, int nc_aud, int mp_aud);
+	double afgain, int sntch_run, double ctcss_freq, int nc_de, int mp_de, int nc_aud, int mp_aud, int precision);
 
 extern void destroy_fmd (FMD a);
 
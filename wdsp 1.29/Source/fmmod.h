@@ -56,7 +56,7 @@ typedef struct _fmmod
 }fmmod, *FMMOD;
 
 extern FMMOD create_fmmod (int run, int size, double* in, double* out, int rate, double dev, double f_low, double f_high, 
-	int ctcss_run, double ctcss_level, double ctcss_freq, int bp_run, int nc, int mp);
+	int ctcss_run, double ctcss_level, double ctcss_freq, int bp_run, int nc, int mp, int precision);
 
 extern void destroy_fmmod (FMMOD a);
 
@@ -42,7 +42,7 @@ void calc_fmsq (FMSQ a)
 	a->G[2] = 3.0;
 	a->G[3] = +20.0 * log10(20000.0 / *a->pllpole);
 	impulse = eq_impulse (a->nc, 3, a->F, a->G, a->rate, 1.0 / (2.0 * a->size), 0, 0);
-	a->p = create_fircore (a->size, a->trigger, a->noise, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->trigger, a->noise, a->nc, a->mp, impulse, a->precision);
 	_aligned_free (impulse);
 	// noise averaging
 	a->avm = exp(-1.0 / (a->rate * a->avtau));
@@ -87,7 +87,7 @@ void decalc_fmsq (FMSQ a)
 
 FMSQ create_fmsq (int run, int size, double* insig, double* outsig, double* trigger, int rate, double fc, 
 	double* pllpole, double tdelay, double avtau, double longtau, double tup, double tdown, double tail_thresh, 
-	double unmute_thresh, double min_tail, double max_tail, int nc, int mp)
+	double unmute_thresh, double min_tail, double max_tail, int nc, int mp, int precision)
 {
 	FMSQ a = (FMSQ) malloc0 (sizeof (fmsq));
 	a->run = run;
@@ -109,6 +109,7 @@ FMSQ create_fmsq (int run, int size, double* insig, double* outsig, double* trig
 	a->max_tail = max_tail;
 	a->nc = nc;
 	a->mp = mp;
+	a->precision = precision;
 	calc_fmsq (a);
 	return a;
 }
@@ -66,12 +66,13 @@ typedef struct _fmsq
 	double tdelay;
 	int nc;
 	int mp;
+	int precision;
 	FIRCORE p;
 } fmsq, *FMSQ;
 
 extern FMSQ create_fmsq (int run, int size, double* insig, double* outsig, double* trigger, int rate, double fc, 
 	double* pllpole, double tdelay, double avtau, double longtau, double tup, double tdown, double tail_thresh, 
-	double unmute_thresh, double min_tail, double max_tail, int nc, int mp);
+	double unmute_thresh, double min_tail, double max_tail, int nc, int mp, int precision);
 
 extern void destroy_fmsq (FMSQ a);
 
@@ -103,7 +103,7 @@ double* build_gaussian(int* pnc, double rate, double f, double fwhm, double scal
 ********************************************************************************************************/
 
 GAUSSIAN create_gaussian (int run, int position, int size, int nc, double* in, double* out,
-	double f_center, double bandwidth, int samplerate, double gain, double nsigma, int mode)
+	double f_center, double bandwidth, int samplerate, double gain, double nsigma, int mode, int precision)
 {
 	// NOTE:  'nc' must be >= 'size'
 	GAUSSIAN a = (GAUSSIAN)malloc0 (sizeof(gaussian));
@@ -124,7 +124,7 @@ GAUSSIAN create_gaussian (int run, int position, int size, int nc, double* in, d
 	if (a->nc == 0) a->nc_var = 1;
 	else            a->nc_var = 0;
 	impulse = build_gaussian (&a->nc, (double)a->samplerate, a->f_center, a->bandwidth, a->scale, a->nsigma);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, 0, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, 0, impulse, precision);
 	_aligned_free (impulse);
 	return a;
 }
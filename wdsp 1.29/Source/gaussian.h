@@ -53,7 +53,7 @@ typedef struct _gaussian
 }gaussian, *GAUSSIAN;
 
 extern GAUSSIAN create_gaussian(int run, int position, int size, int nc, double* in, double* out,
-	double f_center, double bandwidth, int samplerate, double gain, double nsigma, int mode);
+	double f_center, double bandwidth, int samplerate, double gain, double nsigma, int mode, int precision);
 
 extern void destroy_gaussian(GAUSSIAN a);
 
@@ -28,27 +28,18 @@ warren@wpratt.com
 
 void calc_tone (GEN a)
 {
-	a->tone.phs = 0.0;
-	a->tone.delta = TWOPI * a->tone.freq / a->rate;
-	a->tone.cosdelta = cos (a->tone.delta);
-	a->tone.sindelta = sin (a->tone.delta);
+	init_nco (&a->tone.osc, TWOPI * a->tone.freq / a->rate);
 }
 
 void calc_tt (GEN a)
 {
-	a->tt.phs1 = 0.0;
-	a->tt.phs2 = 0.0;
-	a->tt.delta1 = TWOPI * a->tt.f1 / a->rate;
-	a->tt.delta2 = TWOPI * a->tt.f2 / a->rate;
-	a->tt.cosdelta1 = cos (a->tt.delta1);
-	a->tt.cosdelta2 = cos (a->tt.delta2);
-	a->tt.sindelta1 = sin (a->tt.delta1);
-	a->tt.sindelta2 = sin (a->tt.delta2);
+	init_nco (&a->tt.osc1, TWOPI * a->tt.f1 / a->rate);
+	init_nco (&a->tt.osc2, TWOPI * a->tt.f2 / a->rate);
 }
 
 void calc_sweep (GEN a)
 {
-	a->sweep.phs = 0.0;
+	init_nco (&a->sweep.osc, 0.0);
 	a->sweep.dphs = TWOPI * a->sweep.f1 / a->rate;
 	a->sweep.d2phs = TWOPI * a->sweep.sweeprate / (a->rate * a->rate);
 	a->sweep.dphsmax = TWOPI * a->sweep.f2 / a->rate;
@@ -75,10 +66,7 @@ void calc_pulse (GEN a)
 	int i;
 	double delta, theta;
 	a->pulse.pperiod = 1.0 / a->pulse.pf;
-	a->pulse.tphs = 0.0;
-	a->pulse.tdelta = TWOPI * a->pulse.tf / a->rate;
-	a->pulse.tcosdelta = cos (a->pulse.tdelta);
-	a->pulse.tsindelta = sin (a->pulse.tdelta);
+	init_nco (&a->pulse.tosc, TWOPI * a->pulse.tf / a->rate);
 	a->pulse.pntrans = (int)(a->pulse.ptranstime * a->rate);
 	a->pulse.pnon = (int)(a->pulse.pdutycycle * a->pulse.pperiod * a->rate);
 	a->pulse.pnoff = (int)(a->pulse.pperiod * a->rate) - a->pulse.pnon - 2 * a->pulse.pntrans;
@@ -100,14 +88,8 @@ void calc_ttpulse(GEN a)
 	int i;
 	double delta, theta;
 	a->ttpulse.pperiod = 1.0 / a->ttpulse.pf;
-	a->ttpulse.tphs1 = 0.0;
-	a->ttpulse.tphs2 = 0.0;
-	a->ttpulse.tdelta1 = TWOPI * a->ttpulse.tf1 / a->rate;
-	a->ttpulse.tdelta2 = TWOPI * a->ttpulse.tf2 / a->rate;
-	a->ttpulse.tcosdelta1 = cos(a->ttpulse.tdelta1);
-	a->ttpulse.tcosdelta2 = cos(a->ttpulse.tdelta2);
-	a->ttpulse.tsindelta1 = sin(a->ttpulse.tdelta1);
-	a->ttpulse.tsindelta2 = sin(a->ttpulse.tdelta2);
+	init_nco (&a->ttpulse.tosc1, TWOPI * a->ttpulse.tf1 / a->rate);
+	init_nco (&a->ttpulse.tosc2, TWOPI * a->ttpulse.tf2 / a->rate);
 	a->ttpulse.pntrans = (int)(a->ttpulse.ptranstime * a->rate);
 	a->ttpulse.pnon = (int)(a->ttpulse.pdutycycle * a->ttpulse.pperiod * a->rate);
 	a->ttpulse.pnoff = (int)(a->ttpulse.pperiod * a->rate) - a->ttpulse.pnon - 2 * a->ttpulse.pntrans;
@@ -150,6 +132,7 @@ GEN create_gen (int run, int size, double* in, double* out, int rate, int mode)
 	a->out = out;
 	a->rate = (double)rate;
 	a->mode = mode;
+	a->cs = (double *) malloc0 (2 * a->size * sizeof (complex));
 	// tone
 	a->tone.mag = 1.0;
 	a->tone.freq = 1000.0;
@@ -195,6 +178,7 @@ GEN create_gen (int run, int size, double* in, double* out, int rate, int mode)
 void destroy_gen (GEN a)
 {
 	decalc_gen (a);
+	_aligned_free (a->cs);
 	_aligned_free (a);
 }
 
@@ -221,49 +205,25 @@ void xgen (GEN a)
 		case 0:	// tone
 			{
 				int i;
-				double t1, t2;
-				double cosphase = cos (a->tone.phs);
-				double sinphase = sin (a->tone.phs);
+				xncob (&a->tone.osc, a->size, a->out);
 				for (i = 0; i < a->size; i++)
 				{
-					a->out[2 * i + 0] = + a->tone.mag * cosphase;
-					a->out[2 * i + 1] = - a->tone.mag * sinphase;
-					t1 = cosphase;
-					t2 = sinphase;
-					cosphase = t1 * a->tone.cosdelta - t2 * a->tone.sindelta;
-					sinphase = t1 * a->tone.sindelta + t2 * a->tone.cosdelta;
-					a->tone.phs += a->tone.delta;
-					if (a->tone.phs >= TWOPI) a->tone.phs -= TWOPI;
-					if (a->tone.phs <   0.0 ) a->tone.phs += TWOPI;
+					a->out[2 * i + 0] *= + a->tone.mag;
+					a->out[2 * i + 1] *= - a->tone.mag;
 				}
 				break;
 			}
 		case 1:	// two-tone
 			{
 				int i;
-				double tcos, tsin;
-				double cosphs1 = cos (a->tt.phs1);
-				double sinphs1 = sin (a->tt.phs1);
-				double cosphs2 = cos (a->tt.phs2);
-				double sinphs2 = sin (a->tt.phs2);
+				double* cs1 = a->cs;
+				double* cs2 = a->cs + 2 * a->size;
+				xncob (&a->tt.osc1, a->size, cs1);
+				xncob (&a->tt.osc2, a->size, cs2);
 				for (i = 0; i < a->size; i++)
 				{
-					a->out[2 * i + 0] = + a->tt.mag1 * cosphs1 + a->tt.mag2 * cosphs2;
-					a->out[2 * i + 1] = - a->tt.mag1 * sinphs1 - a->tt.mag2 * sinphs2;
-					tcos = cosphs1;
-					tsin = sinphs1;
-					cosphs1 = tcos * a->tt.cosdelta1 - tsin * a->tt.sindelta1;
-					sinphs1 = tcos * a->tt.sindelta1 + tsin * a->tt.cosdelta1;
-					a->tt.phs1 += a->tt.delta1;
-					if (a->tt.phs1 >= TWOPI) a->tt.phs1 -= TWOPI;
-					if (a->tt.phs1 <   0.0 ) a->tt.phs1 += TWOPI;
-					tcos = cosphs2;
-					tsin = sinphs2;
-					cosphs2 = tcos * a->tt.cosdelta2 - tsin * a->tt.sindelta2;
-					sinphs2 = tcos * a->tt.sindelta2 + tsin * a->tt.cosdelta2;
-					a->tt.phs2 += a->tt.delta2;
-					if (a->tt.phs2 >= TWOPI) a->tt.phs2 -= TWOPI;
-					if (a->tt.phs2 <   0.0 ) a->tt.phs2 += TWOPI;
+					a->out[2 * i + 0] = + a->tt.mag1 * cs1[2 * i + 0] + a->tt.mag2 * cs2[2 * i + 0];
+					a->out[2 * i + 1] = - a->tt.mag1 * cs1[2 * i + 1] - a->tt.mag2 * cs2[2 * i + 1];
 				}
 				break;
 			}
@@ -288,14 +248,14 @@ void xgen (GEN a)
 		case 3:  // sweep
 			{
 				int i;
+				double cs[2];
 				for (i = 0; i < a->size; i++)
 				{
-					a->out[2 * i + 0] = + a->sweep.mag * cos(a->sweep.phs);
-					a->out[2 * i + 1] = - a->sweep.mag * sin(a->sweep.phs);
-					a->sweep.phs += a->sweep.dphs;
+					cs_nco (&a->sweep.osc, cs);
+					a->out[2 * i + 0] = + a->sweep.mag * cs[0];
+					a->out[2 * i + 1] = - a->sweep.mag * cs[1];
+					advance_nco (&a->sweep.osc, a->sweep.dphs);
 					a->sweep.dphs += a->sweep.d2phs;
-					if (a->sweep.phs >= TWOPI) a->sweep.phs -= TWOPI;
-					if (a->sweep.phs <   0.0 ) a->sweep.phs += TWOPI;
 					if (a->sweep.dphs > a->sweep.dphsmax)
 						a->sweep.dphs = TWOPI * a->sweep.f1 / a->rate;
 				}
@@ -330,11 +290,12 @@ void xgen (GEN a)
 		case 6:  // pulse (audio or IQ output)
 			{
 				int i;
-				double t1, t2;
-				double cosphase = cos (a->pulse.tphs);
-				double sinphase = sin (a->pulse.tphs);
+				double cosphase, sinphase;
+				xncob (&a->pulse.tosc, a->size, a->cs);
 				for (i = 0; i < a->size; i++)
 				{
+					cosphase = a->cs[2 * i + 0];
+					sinphase = a->cs[2 * i + 1];
 					if (a->pulse.pnoff != 0)
 					{
 						switch (a->pulse.state)
@@ -408,26 +369,23 @@ void xgen (GEN a)
 						a->out[2 * i + 0] = 0.0;
 						a->out[2 * i + 1] = 0.0;
 					}
-					t1 = cosphase;
-					t2 = sinphase;
-					cosphase = t1 * a->pulse.tcosdelta - t2 * a->pulse.tsindelta;
-					sinphase = t1 * a->pulse.tsindelta + t2 * a->pulse.tcosdelta;
-					a->pulse.tphs += a->pulse.tdelta;
-					if (a->pulse.tphs >= TWOPI) a->pulse.tphs -= TWOPI;
-					if (a->pulse.tphs <   0.0 ) a->pulse.tphs += TWOPI;
 				}
 			}
 			break;
 		case 7:		// two-tone pulse (audio or IQ)
 			{
 				int i;
-				double t1a, t1b, t2a, t2b;
-				double cosphase1 = cos(a->ttpulse.tphs1);
-				double cosphase2 = cos(a->ttpulse.tphs2);
-				double sinphase1 = sin(a->ttpulse.tphs1);
-				double sinphase2 = sin(a->ttpulse.tphs2);
+				double* cs1 = a->cs;
+				double* cs2 = a->cs + 2 * a->size;
+				double cosphase1, cosphase2, sinphase1, sinphase2;
+				xncob (&a->ttpulse.tosc1, a->size, cs1);
+				xncob (&a->ttpulse.tosc2, a->size, cs2);
 				for (i = 0; i < a->size; i++)
 				{
+					cosphase1 = cs1[2 * i + 0];
+					cosphase2 = cs2[2 * i + 0];
+					sinphase1 = cs1[2 * i + 1];
+					sinphase2 = cs2[2 * i + 1];
 					if (a->ttpulse.pnoff != 0)
 					{
 						switch (a->ttpulse.state)
@@ -499,20 +457,6 @@ void xgen (GEN a)
 						a->out[2 * i + 0] = 0.0;
 						a->out[2 * i + 1] = 0.0;
 					}
-					t1a = cosphase1;
-					t1b = sinphase1;
-					cosphase1 = t1a * a->ttpulse.tcosdelta1 - t1b * a->ttpulse.tsindelta1;
-					sinphase1 = t1a * a->ttpulse.tsindelta1 + t1b * a->ttpulse.tcosdelta1;
-					a->ttpulse.tphs1 += a->ttpulse.tdelta1;
-					if (a->ttpulse.tphs1 >= TWOPI) a->ttpulse.tphs1 -= TWOPI;
-					if (a->ttpulse.tphs1 <  0.0)   a->ttpulse.tphs1 += TWOPI;
-					t2a = cosphase2;
-					t2b = sinphase2;
-					cosphase2 = t2a * a->ttpulse.tcosdelta2 - t2b * a->ttpulse.tsindelta2;
-					sinphase2 = t2a * a->ttpulse.tsindelta2 + t2b * a->ttpulse.tcosdelta2;
-					a->ttpulse.tphs2 += a->ttpulse.tdelta2;
-					if (a->ttpulse.tphs2 >= TWOPI) a->ttpulse.tphs2 -= TWOPI;
-					if (a->ttpulse.tphs2 <  0.0)   a->ttpulse.tphs2 += TWOPI;
 				}
 			}
 			break;
@@ -543,6 +487,8 @@ void setSamplerate_gen (GEN a, int rate)
 void setSize_gen (GEN a, int size)
 {
 	a->size = size;
+	_aligned_free (a->cs);
+	a->cs = (double *) malloc0 (2 * a->size * sizeof (complex));
 	flush_gen (a);
 }
 
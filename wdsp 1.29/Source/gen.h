@@ -26,6 +26,7 @@ warren@wpratt.com
 
 #ifndef _gen_h
 #define _gen_h
+#include "nco.h"
 
 typedef struct _gen
 {
@@ -35,14 +36,12 @@ typedef struct _gen
 	double* out;				// output buffer
 	double rate;				// sample rate
 	int mode;					
+	double* cs;					// oscillator output for one buffer, two oscillators
 	struct _tone
 	{
 		double mag;
 		double freq;
-		double phs;
-		double delta;
-		double cosdelta;
-		double sindelta;
+		nco osc;
 	} tone;
 	struct _tt
 	{
@@ -50,14 +49,8 @@ typedef struct _gen
 		double mag2;
 		double f1;
 		double f2;
-		double phs1;
-		double phs2;
-		double delta1;
-		double delta2;
-		double cosdelta1;
-		double cosdelta2;
-		double sindelta1;
-		double sindelta2;
+		nco osc1;
+		nco osc2;
 	} tt;
 	struct _noise
 	{
@@ -69,7 +62,7 @@ typedef struct _gen
 		double f1;
 		double f2;
 		double sweeprate;
-		double phs;
+		nco osc;
 		double dphs;
 		double d2phs;
 		double dphsmax;
@@ -105,10 +98,7 @@ typedef struct _gen
 		int pnoff;
 		double pperiod;
 		double tf;
-		double tphs;
-		double tdelta;
-		double tcosdelta;
-		double tsindelta;
+		nco tosc;
 		int state;
 		int IQout;
 	} pulse;
@@ -127,14 +117,8 @@ typedef struct _gen
 		double pperiod;
 		double tf1;
 		double tf2;
-		double tphs1;
-		double tphs2;
-		double tdelta1;
-		double tdelta2;
-		double tcosdelta1;
-		double tcosdelta2;
-		double tsindelta1;
-		double tsindelta2;
+		nco tosc1;
+		nco tosc2;
 		int state;
 		int IQout;
 	} ttpulse;
@@ -31,7 +31,7 @@ void calc_icfir (ICFIR a)
 	double* impulse;
 	a->scale = 1.0 / (double)(2 * a->size);
 	impulse = icfir_impulse (a->nc, a->DD, a->R, a->Pairs, a->runrate, a->cicrate, a->cutoff, a->xtype, a->xbw, 1, a->scale, a->wintype);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse, a->precision);
 	_aligned_free (impulse);
 }
 
@@ -41,7 +41,7 @@ void decalc_icfir (ICFIR a)
 }
 
 ICFIR create_icfir (int run, int size, int nc, int mp, double* in, double* out, int runrate, int cicrate, 
-	int DD, int R, int Pairs, double cutoff, int xtype, double xbw, int wintype)
+	int DD, int R, int Pairs, double cutoff, int xtype, double xbw, int wintype, int precision)
 //	run:  0 - no action; 1 - operate
 //	size:  number of complex samples in an input buffer to the CFIR filter
 //	nc:  number of filter coefficients
@@ -55,12 +55,14 @@ ICFIR create_icfir (int run, int size, int nc, int mp, double* in, double* out,
 //	cutoff:  cutoff frequency
 //  xtype:  0 - fourth power transition; 1 - raised cosine transition
 //  xbw:  width of raised cosine transition
+//  precision:  0 for double, 1 for single-precision filter kernel
 {
 	ICFIR a = (ICFIR) malloc0 (sizeof (icfir));
 	a->run = run;
 	a->size = size;
 	a->nc = nc;
 	a->mp = mp;
+	a->precision = precision;
 	a->in = in;
 	a->out = out;
 	a->runrate = runrate;
@@ -41,6 +41,10 @@ mw0lge@grange-lane.co.uk
 
 #define _CRT_SECURE_NO_WARNINGS
 #include "comm.h"
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
 
 /********************************************************************************************************
 *																										*
@@ -76,155 +80,571 @@ mw0lge@grange-lane.co.uk
 	}
 #endif
 
+// The cache is split into CACHE_SHARDS independently locked shards selected by the key hash, so designs on
+// different channels rarely contend.  Each shard keeps a chained hash table for lookup and a doubly-linked
+// list in recency order, which makes lookup, promotion, insertion and eviction O(1).  The byte budget is
+// divided evenly among the shards.  Entries are reference counted:  the cache holds one reference while an
+// entry is linked, and acquire_impulse_cache_entry() hands out another, so a reader can use the impulse in
+// place even if the entry is evicted before it is released.
+
 typedef struct _cache_entry {
 	HASH_T  hash;
+	int		bucket;
 	int		N;							// N complex entries in impulse. Leave as signed int as that is used everywhere
-	double* impulse;
+	size_t	bytes;						// allocation size, charged against the budget
+	volatile LONG refs;
+	struct _cache_entry* hnext;			// hash chain
+	struct _cache_entry* prev;			// recency list, head is most recently used
 	struct _cache_entry* next;
+	double* impulse;					// read-only once published; stored just after this header
 } cache_entry;
 
-static size_t _cache_counts[CACHE_BUCKETS] = { 0 };
-static cache_entry* _cache_heads[CACHE_BUCKETS] = { NULL };
-static CRITICAL_SECTION _cs_use_cache;
-static int _run = 0;
-static int _use_cache = 1;
+#define CACHE_ENTRY_HDR		((sizeof(cache_entry) + 63) & ~(size_t)63)
+
+typedef struct _cache_shard {
+	CRITICAL_SECTION cs;
+	cache_entry* slots[CACHE_SLOTS];
+	cache_entry* head;
+	cache_entry* tail;
+	size_t bytes;
+	int64_t entries;
+	int64_t hits;
+	int64_t misses;
+	int64_t evictions;
+} cache_shard;
+
+static cache_shard _shards[CACHE_SHARDS];
+static size_t _budget = IMPULSE_CACHE_BUDGET;
+static volatile LONG _run = 0;
+static volatile LONG _use_cache = 1;
+static volatile LONG _use_mask_cache = 0;
+
+static __forceinline size_t key_mix(size_t bucket, HASH_T hash)
+{
+	uint64_t k = ((uint64_t)hash ^ ((uint64_t)bucket << 56)) * 0x9E3779B97F4A7C15ULL;
+	return (size_t)(k >> 32);
+}
 
-void remove_impulse_cache_tail(size_t bucket)
+static __forceinline cache_shard* shard_of(size_t bucket, HASH_T hash)
 {
-	if (bucket >= CACHE_BUCKETS) return;
+	return &_shards[key_mix(bucket, hash) & (CACHE_SHARDS - 1)];
+}
 
-	cache_entry** pp = &_cache_heads[bucket];
+static __forceinline cache_entry** slot_of(cache_shard* s, size_t bucket, HASH_T hash)
+{
+	return &s->slots[(key_mix(bucket, hash) >> 8) & (CACHE_SLOTS - 1)];
+}
 
-	while (*pp && (*pp)->next) 
-	{
-		pp = &(*pp)->next;
-	}
+static void release_entry(cache_entry* e)
+{
+	if (InterlockedDecrement(&e->refs) == 0)
+		_aligned_free(e);
+}
 
-	if (*pp) 
+static void unlink_lru(cache_shard* s, cache_entry* e)
+{
+	if (e->prev) e->prev->next = e->next;
+	else         s->head = e->next;
+	if (e->next) e->next->prev = e->prev;
+	else         s->tail = e->prev;
+	e->prev = e->next = NULL;
+}
+
+static void push_lru(cache_shard* s, cache_entry* e)
+{
+	e->prev = NULL;
+	e->next = s->head;
+	if (s->head) s->head->prev = e;
+	else         s->tail = e;
+	s->head = e;
+}
+
+static void remove_entry(cache_shard* s, cache_entry* e)
+{
+	// call with the shard locked; drops the cache's reference
+	cache_entry** pp = slot_of(s, e->bucket, e->hash);
+	while (*pp != e) pp = &(*pp)->hnext;
+	*pp = e->hnext;
+	unlink_lru(s, e);
+	s->bytes -= e->bytes;
+	s->entries--;
+	release_entry(e);
+}
+
+static cache_entry* find_entry(cache_shard* s, size_t bucket, HASH_T hash, int N)
+{
+	cache_entry* e;
+	for (e = *slot_of(s, bucket, hash); e; e = e->hnext)
+		if (e->hash == hash && e->N == N && e->bucket == (int)bucket)
+			return e;
+	return NULL;
+}
+
+static void trim_shard(cache_shard* s, size_t limit)
+{
+	while (s->bytes > limit && s->tail)
 	{
-		_aligned_free((*pp)->impulse);
-		_aligned_free(*pp);
-		*pp = NULL;
-		_cache_counts[bucket]--;
+		remove_entry(s, s->tail);
+		s->evictions++;
 	}
 }
 
 void free_impulse_cache(void)
 {
-	for (size_t b = 0; b < CACHE_BUCKETS; ++b) {
-		cache_entry* e = _cache_heads[b];
-		while (e) {
-			cache_entry* next = e->next;
-			_aligned_free(e->impulse);
-			_aligned_free(e);
-			e = next;
-		}
-		_cache_heads[b] = NULL;
-		_cache_counts[b] = 0;
+	for (size_t i = 0; i < CACHE_SHARDS; i++) {
+		cache_shard* s = &_shards[i];
+		EnterCriticalSection(&s->cs);
+		while (s->head) remove_entry(s, s->head);
+		LeaveCriticalSection(&s->cs);
 	}
 }
 
-double* get_impulse_cache_entry(size_t bucket, HASH_T hash, int N)
+static const double* pin_entry(size_t bucket, HASH_T hash, int N, int count)
 {
-	if (!_run) return NULL;
-
-	int use;
-	EnterCriticalSection(&_cs_use_cache);
-	use = _use_cache;
-	LeaveCriticalSection(&_cs_use_cache);
-
-	if (!use || bucket >= CACHE_BUCKETS) return NULL;
-
-	// lru, least recently used, moves cache hit to head
-	// old cache entries will move towards the tail and eventually be dumped
-	cache_entry* prev = NULL;
-	cache_entry* e = _cache_heads[bucket];
-	
-	while (e) {
-		if (e->hash == hash && e->N == N) 
-		{
-			if (prev)
-			{
-				prev->next = e->next;
-				e->next = _cache_heads[bucket];
-				_cache_heads[bucket] = e;
-			}
-			double* imp = (double*) malloc0(e->N * sizeof(complex));
-			memcpy(imp, e->impulse, e->N * sizeof(complex));
-			return imp;
-		}
-		prev = e;
-		e = e->next;
+	cache_shard* s = shard_of(bucket, hash);
+	cache_entry* e;
+	EnterCriticalSection(&s->cs);
+	if ((e = find_entry(s, bucket, hash, N)) != NULL)
+	{
+		unlink_lru(s, e);
+		push_lru(s, e);
+		InterlockedIncrement(&e->refs);
+		if (count) s->hits++;
 	}
+	else if (count)
+		s->misses++;
+	LeaveCriticalSection(&s->cs);
+	return e ? e->impulse : NULL;
+}
 
-	return NULL;
+static const double* page_in_entry(size_t bucket, HASH_T hash, int N);
+
+const double* acquire_impulse_cache_entry(size_t bucket, HASH_T hash, int N)
+{
+	// returns a shared, read-only impulse, or NULL on a miss; pair with release_impulse_cache_entry()
+	if (!_run || !_use_cache || bucket >= CACHE_KINDS) return NULL;
+	if (bucket == MASK_CACHE && !_use_mask_cache) return NULL;
+
+	const double* imp = pin_entry(bucket, hash, N, 1);
+	if (!imp && bucket < CACHE_BUCKETS)
+		imp = page_in_entry(bucket, hash, N);
+	return imp;
 }
 
-void add_impulse_to_cache(size_t bucket, HASH_T hash, int N, double* impulse)
+void release_impulse_cache_entry(const double* impulse)
 {
-	if (!_run) return;
+	if (impulse) release_entry((cache_entry*)((char*)impulse - CACHE_ENTRY_HDR));
+}
 
-	int use;
-	EnterCriticalSection(&_cs_use_cache);
-	use = _use_cache;
-	LeaveCriticalSection(&_cs_use_cache);
+double* get_impulse_cache_entry(size_t bucket, HASH_T hash, int N)
+{
+	// returns a private copy that the caller frees with _aligned_free()
+	const double* e = acquire_impulse_cache_entry(bucket, hash, N);
+	if (!e) return NULL;
+	double* imp = (double*) malloc0(N * sizeof(complex));
+	memcpy(imp, e, N * sizeof(complex));
+	release_impulse_cache_entry(e);
+	return imp;
+}
 
-	if (!use || bucket >= CACHE_BUCKETS) return;
+void add_blocks_to_cache(size_t bucket, HASH_T hash, int nblocks, int blockN, void** blocks)
+{
+	// stores the concatenation of 'nblocks' arrays of 'blockN' complex values each under a single key
+	if (!_run || !_use_cache || bucket >= CACHE_KINDS) return;
+	if (bucket == MASK_CACHE && !_use_mask_cache) return;
 
-	if (_cache_counts[bucket] >= MAX_CACHE_ENTRIES) remove_impulse_cache_tail(bucket);
+	int N = nblocks * blockN;
+	size_t bytes = CACHE_ENTRY_HDR + (size_t)N * sizeof(complex);
+	size_t limit = _budget / CACHE_SHARDS;
+	if (bytes > limit) return;
 
-	cache_entry* e = malloc0(sizeof(cache_entry));
+	// build outside the lock
+	cache_entry* e = (cache_entry*) malloc0((int)bytes);
 	e->hash = hash;
+	e->bucket = (int)bucket;
 	e->N = N;
-	e->impulse = (double *) malloc0(N * sizeof(complex));
-	memcpy(e->impulse, impulse, N * sizeof(complex));
-	e->next = _cache_heads[bucket];
-	_cache_heads[bucket] = e;
-	_cache_counts[bucket]++;
+	e->bytes = bytes;
+	e->refs = 1;
+	e->impulse = (double*)((char*)e + CACHE_ENTRY_HDR);
+	for (int i = 0; i < nblocks; i++)
+		memcpy(e->impulse + 2 * (size_t)i * blockN, blocks[i], blockN * sizeof(complex));
+
+	cache_shard* s = shard_of(bucket, hash);
+	EnterCriticalSection(&s->cs);
+	cache_entry* old = find_entry(s, bucket, hash, N);
+	if (old) remove_entry(s, old);				// same key, another thread got here first
+	cache_entry** slot = slot_of(s, bucket, hash);
+	e->hnext = *slot;
+	*slot = e;
+	push_lru(s, e);
+	s->bytes += bytes;
+	s->entries++;
+	trim_shard(s, limit);
+	LeaveCriticalSection(&s->cs);
 }
 
-PORT
-int save_impulse_cache(const char* path)
+void add_impulse_to_cache(size_t bucket, HASH_T hash, int N, double* impulse)
 {
-	if (!_run) return 0;
+	void* block = impulse;
+	add_blocks_to_cache(bucket, hash, 1, N, &block);
+}
 
-	int use;
-	EnterCriticalSection(&_cs_use_cache);
-	use = _use_cache;
-	LeaveCriticalSection(&_cs_use_cache);
-	if (!use) return 0;
+int mask_cache_active(void)
+{
+	return _run && _use_cache && _use_mask_cache;
+}
 
-	FILE* fp = fopen(path, "wb");
-	if (!fp) return -1;
-	uint32_t buckets = CACHE_BUCKETS;
-	if (fwrite(&buckets, sizeof(buckets), 1, fp) != 1) { fclose(fp); return -1; }
-	for (size_t b = 0; b < CACHE_BUCKETS; b++) {
-		uint32_t count = 0;
-		for (cache_entry* e = _cache_heads[b]; e; e = e->next) count++;
-		if (fwrite(&count, sizeof(count), 1, fp) != 1) { fclose(fp); return -1; }
-		for (cache_entry* e = _cache_heads[b]; e; e = e->next) {
-			if (fwrite(&e->hash, sizeof(HASH_T), 1, fp) != 1) { fclose(fp); return -1; }
-			if (fwrite(&e->N, sizeof(e->N), 1, fp) != 1) { fclose(fp); return -1; }
-			if (fwrite(e->impulse, sizeof(complex), e->N, fp) != (size_t)e->N) { fclose(fp); return -1; }
-		}
+/********************************************************************************************************
+*																										*
+*										Cache File														*
+*																										*
+********************************************************************************************************/
+
+// File layout (version 1), native byte order, checked with 'endian':
+//     icf_header
+//     icf_index[count]         sorted by (bucket, hash, N)
+//     impulse data             each entry starts on a 64-byte boundary
+// The header and the index are checked with CRC-32 when the file is attached; each entry's data is checked
+// the first time it is paged in.  The file is mapped read-only, so the pages are shared by every process on
+// the host that attaches the same file, and only the entries that are actually looked up are ever read.
+// Entries carry their own bucket number, so a change to CACHE_BUCKETS no longer invalidates the file.
+// Files written in the original unversioned format are still read.
+
+#define ICF_MAGIC			"WDSPIMPC"
+#define ICF_VERSION			1
+#define ICF_ENDIAN			0x01020304
+#define ICF_ALIGN			64
+
+typedef struct _icf_header {
+	char     magic[8];
+	uint32_t version;
+	uint32_t endian;
+	uint32_t hash_bytes;				// sizeof(HASH_T) of the writer; 32- and 64-bit builds hash differently
+	uint32_t count;						// number of index entries
+	uint64_t index_offset;
+	uint64_t data_offset;
+	uint64_t file_size;
+	uint32_t index_crc;
+	uint32_t header_crc;				// computed with this field set to zero
+} icf_header;
+
+typedef struct _icf_index {
+	uint64_t hash;
+	uint64_t offset;					// from the start of the file
+	uint32_t bucket;
+	int32_t  N;
+	uint32_t crc;						// of the N complex values
+	uint32_t reserved;
+} icf_index;
+
+static struct _icf_map {
+	CRITICAL_SECTION cs;
+	const char* base;					// mapped file, NULL if none
+	size_t size;
+	const icf_index* index;
+	uint32_t count;
+	unsigned char* state;				// per entry:  0, unchecked; 1, good; 2, bad checksum
+	int64_t disk_hits;
+	int64_t bad_crc;
+#if defined(_WIN32)
+	HANDLE hfile;
+	HANDLE hmap;
+#endif
+} _map;
+
+static uint32_t _crc_table[256];
+
+static void init_crc32(void)
+{
+	for (uint32_t n = 0; n < 256; n++) {
+		uint32_t c = n;
+		for (int k = 0; k < 8; k++)
+			c = (c & 1) ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+		_crc_table[n] = c;
 	}
-	fclose(fp);
+}
+
+static uint32_t crc32_update(uint32_t crc, const void* data, size_t len)
+{
+	const uint8_t* p = (const uint8_t*)data;
+	crc = ~crc;
+	while (len--)
+		crc = _crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+static int icf_compare(size_t bucket, uint64_t hash, int N, const icf_index* x)
+{
+	if (bucket != x->bucket) return bucket < x->bucket ? -1 : 1;
+	if (hash != x->hash) return hash < x->hash ? -1 : 1;
+	if (N != x->N) return N < x->N ? -1 : 1;
 	return 0;
 }
 
-PORT
-int read_impulse_cache(const char* path)
+static int icf_sort(const void* pa, const void* pb)
 {
-	if (!_run) return 0;
+	const icf_index* b = (const icf_index*)pb;
+	const icf_index* a = (const icf_index*)pa;
+	return icf_compare(a->bucket, a->hash, a->N, b);
+}
 
-	free_impulse_cache();
+static long icf_find(size_t bucket, uint64_t hash, int N)
+{
+	// call with _map.cs held; binary search of the mapped index
+	long lo = 0, hi = (long)_map.count - 1;
+	while (lo <= hi) {
+		long mid = lo + (hi - lo) / 2;
+		int c = icf_compare(bucket, hash, N, &_map.index[mid]);
+		if (c == 0) return mid;
+		if (c < 0) hi = mid - 1;
+		else       lo = mid + 1;
+	}
+	return -1;
+}
 
-	int use;
-	EnterCriticalSection(&_cs_use_cache);
-	use = _use_cache;
-	LeaveCriticalSection(&_cs_use_cache);
-	if (!use) return 0;
+static const double* icf_data(long i)
+{
+	// call with _map.cs held; verifies the entry on first use, returns NULL if it is corrupt
+	const icf_index* x = &_map.index[i];
+	if (_map.state[i] == 0)
+		_map.state[i] = crc32_update(0, _map.base + x->offset, (size_t)x->N * sizeof(complex)) == x->crc ? 1 : 2;
+	if (_map.state[i] != 1) {
+		_map.bad_crc++;
+		return NULL;
+	}
+	return (const double*)(_map.base + x->offset);
+}
 
+static void unmap_cache_file(void)
+{
+	// call with _map.cs held
+	if (!_map.base) return;
+#if defined(_WIN32)
+	UnmapViewOfFile(_map.base);
+	CloseHandle(_map.hmap);
+	CloseHandle(_map.hfile);
+#else
+	munmap((void*)_map.base, _map.size);
+#endif
+	free(_map.state);
+	_map.base = NULL;
+	_map.index = NULL;
+	_map.state = NULL;
+	_map.count = 0;
+	_map.size = 0;
+}
+
+static int map_cache_file(const char* path)
+{
+	// call with _map.cs held; returns 0 if 'path' is a valid version 1 file and is now attached,
+	// 1 if it is not a version 1 file, -1 if it is a damaged or incompatible version 1 file
+	const char* base;
+	size_t size;
+	unmap_cache_file();
+#if defined(_WIN32)
+	LARGE_INTEGER fsize;
+	HANDLE hfile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hfile == INVALID_HANDLE_VALUE) return -1;
+	if (!GetFileSizeEx(hfile, &fsize) || fsize.QuadPart < (LONGLONG)sizeof(icf_header)) { CloseHandle(hfile); return 1; }
+	HANDLE hmap = CreateFileMappingA(hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!hmap) { CloseHandle(hfile); return -1; }
+	base = (const char*)MapViewOfFile(hmap, FILE_MAP_READ, 0, 0, 0);
+	if (!base) { CloseHandle(hmap); CloseHandle(hfile); return -1; }
+	size = (size_t)fsize.QuadPart;
+	_map.hfile = hfile;
+	_map.hmap = hmap;
+#else
+	struct stat st;
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return -1;
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(icf_header)) { close(fd); return 1; }
+	base = (const char*)mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == (const char*)MAP_FAILED) return -1;
+	size = (size_t)st.st_size;
+#endif
+	_map.base = base;
+	_map.size = size;
+
+	icf_header h = *(const icf_header*)base;
+	if (memcmp(h.magic, ICF_MAGIC, 8) != 0) { unmap_cache_file(); return 1; }
+	uint32_t hcrc = h.header_crc;
+	h.header_crc = 0;
+	if (h.version != ICF_VERSION || h.endian != ICF_ENDIAN || h.hash_bytes != sizeof(HASH_T) ||
+		crc32_update(0, &h, sizeof(h)) != hcrc || h.file_size != size ||
+		h.index_offset + (uint64_t)h.count * sizeof(icf_index) > size ||
+		crc32_update(0, base + h.index_offset, (size_t)h.count * sizeof(icf_index)) != h.index_crc)
+	{
+		unmap_cache_file();
+		return -1;
+	}
+	_map.index = (const icf_index*)(base + h.index_offset);
+	_map.count = h.count;
+	_map.state = (unsigned char*)calloc(h.count ? h.count : 1, 1);
+	for (uint32_t i = 0; i < h.count; i++)
+		if (_map.index[i].N <= 0 || _map.index[i].offset + (uint64_t)_map.index[i].N * sizeof(complex) > size)
+			_map.state[i] = 2;
+	return 0;
+}
+
+static const double* page_in_entry(size_t bucket, HASH_T hash, int N)
+{
+	// on a memory miss, copy the entry from the mapped file into the cache
+	const double* imp = NULL;
+	if (!_map.base) return NULL;
+	EnterCriticalSection(&_map.cs);
+	long i = _map.base ? icf_find(bucket, (uint64_t)hash, N) : -1;
+	const double* data = i >= 0 ? icf_data(i) : NULL;
+	if (data) {
+		add_impulse_to_cache(bucket, hash, N, (double*)data);
+		imp = pin_entry(bucket, hash, N, 0);
+		_map.disk_hits++;
+	}
+	LeaveCriticalSection(&_map.cs);
+	return imp;
+}
+
+typedef struct _save_item {
+	icf_index x;
+	const double* data;
+	cache_entry* e;						// referenced memory entry, or NULL for data in the mapped file
+} save_item;
+
+static int save_item_sort(const void* pa, const void* pb)
+{
+	return icf_sort(&((const save_item*)pa)->x, &((const save_item*)pb)->x);
+}
+
+static int rename_cache_file(const char* from, const char* to)
+{
+#if defined(_WIN32)
+	return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) ? 0 : -1;
+#else
+	return rename(from, to);
+#endif
+}
+
+PORT
+int save_impulse_cache(const char* path)
+{
+	if (!_run || !_use_cache) return 0;
+
+	size_t n = 0, cap = 256;
+	int rc = 0;
+	save_item* items = (save_item*)malloc(cap * sizeof(save_item));
+	if (!items) return -1;
+	EnterCriticalSection(&_map.cs);
+
+	// memory entries, referenced so they survive eviction while being written
+	for (size_t i = 0; i < CACHE_SHARDS; i++) {
+		cache_shard* s = &_shards[i];
+		EnterCriticalSection(&s->cs);
+		for (cache_entry* e = s->head; e; e = e->next) {
+			if (e->bucket >= CACHE_BUCKETS) continue;
+			if (n == cap) {
+				save_item* t = (save_item*)realloc(items, 2 * cap * sizeof(save_item));
+				if (!t) break;
+				items = t;
+				cap *= 2;
+			}
+			memset(&items[n], 0, sizeof(save_item));
+			items[n].x.hash = (uint64_t)e->hash;
+			items[n].x.bucket = (uint32_t)e->bucket;
+			items[n].x.N = e->N;
+			items[n].data = e->impulse;
+			items[n].e = e;
+			InterlockedIncrement(&e->refs);
+			n++;
+		}
+		LeaveCriticalSection(&s->cs);
+	}
+
+	// entries that are only in the attached file
+	qsort(items, n, sizeof(save_item), save_item_sort);
+	size_t nmem = n;
+	for (uint32_t i = 0; i < _map.count; i++) {
+		const icf_index* x = &_map.index[i];
+		if (x->bucket >= CACHE_BUCKETS) continue;
+		save_item key;
+		key.x = *x;
+		if (bsearch(&key, items, nmem, sizeof(save_item), save_item_sort)) continue;
+		const double* data = icf_data(i);
+		if (!data) continue;
+		if (n == cap) {
+			save_item* t = (save_item*)realloc(items, 2 * cap * sizeof(save_item));
+			if (!t) break;
+			items = t;
+			cap *= 2;
+		}
+		memset(&items[n], 0, sizeof(save_item));
+		items[n].x = *x;
+		items[n].data = data;
+		n++;
+	}
+	qsort(items, n, sizeof(save_item), save_item_sort);
+
+	// lay out and write to a temporary file, then replace 'path'
+	icf_header h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, ICF_MAGIC, 8);
+	h.version = ICF_VERSION;
+	h.endian = ICF_ENDIAN;
+	h.hash_bytes = sizeof(HASH_T);
+	h.count = (uint32_t)n;
+	h.index_offset = (sizeof(icf_header) + ICF_ALIGN - 1) & ~(uint64_t)(ICF_ALIGN - 1);
+	h.data_offset = (h.index_offset + n * sizeof(icf_index) + ICF_ALIGN - 1) & ~(uint64_t)(ICF_ALIGN - 1);
+	uint64_t offset = h.data_offset;
+	for (size_t i = 0; i < n; i++) {
+		items[i].x.offset = offset;
+		items[i].x.crc = crc32_update(0, items[i].data, (size_t)items[i].x.N * sizeof(complex));
+		items[i].x.reserved = 0;
+		offset += ((uint64_t)items[i].x.N * sizeof(complex) + ICF_ALIGN - 1) & ~(uint64_t)(ICF_ALIGN - 1);
+	}
+	h.file_size = offset;
+	icf_index* index = (icf_index*)malloc(n ? n * sizeof(icf_index) : 1);
+	for (size_t i = 0; i < n; i++)
+		index[i] = items[i].x;
+	h.index_crc = crc32_update(0, index, n * sizeof(icf_index));
+	h.header_crc = crc32_update(0, &h, sizeof(h));
+
+	char tmp[1040];
+	snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+	static const char zeros[ICF_ALIGN] = { 0 };
+	FILE* fp = fopen(tmp, "wb");
+	if (!fp) rc = -1;
+	if (rc == 0 && fwrite(&h, sizeof(h), 1, fp) != 1) rc = -1;
+	if (rc == 0 && fwrite(zeros, 1, (size_t)(h.index_offset - sizeof(h)), fp) != (size_t)(h.index_offset - sizeof(h))) rc = -1;
+	if (rc == 0 && n && fwrite(index, sizeof(icf_index), n, fp) != n) rc = -1;
+	uint64_t pos = h.index_offset + n * sizeof(icf_index);
+	for (size_t i = 0; i < n && rc == 0; i++) {
+		size_t pad = (size_t)(items[i].x.offset - pos);
+		size_t len = (size_t)items[i].x.N * sizeof(complex);
+		if (fwrite(zeros, 1, pad, fp) != pad || fwrite(items[i].data, 1, len, fp) != len) rc = -1;
+		pos = items[i].x.offset + len;
+	}
+	if (rc == 0 && fwrite(zeros, 1, (size_t)(h.file_size - pos), fp) != (size_t)(h.file_size - pos)) rc = -1;
+	if (fp && fclose(fp) != 0) rc = -1;
+
+	for (size_t i = 0; i < n; i++)
+		if (items[i].e) release_entry(items[i].e);
+	free(items);
+	free(index);
+
+	// the mapped file may be the one being replaced; detach before the rename, then attach the new file
+	if (rc == 0) {
+		unmap_cache_file();
+		rc = rename_cache_file(tmp, path);
+		if (rc == 0) map_cache_file(path);
+	}
+	else
+		remove(tmp);
+	LeaveCriticalSection(&_map.cs);
+	return rc;
+}
+
+static int read_legacy_cache(const char* path)
+{
+	// original format:  bucket count, then per bucket a count and (hash, N, data) records
 	FILE* fp = fopen(path, "rb");
 	if (!fp) return -1;
 	uint32_t buckets;
@@ -233,58 +653,146 @@ int read_impulse_cache(const char* path)
 	for (size_t b = 0; b < buckets; b++) {
 		uint32_t count;
 		if (fread(&count, sizeof(count), 1, fp) != 1) { fclose(fp); return -1; }
-		cache_entry* tail = NULL;
 		for (uint32_t i = 0; i < count; i++) {
 			HASH_T hash;
 			int    N;
 			if (fread(&hash, sizeof(HASH_T), 1, fp) != 1) { fclose(fp); return -1; }
 			if (fread(&N, sizeof(N), 1, fp) != 1) { fclose(fp); return -1; }
+			if (N <= 0) { fclose(fp); return -1; }
 			double* data = (double*)malloc0(N * sizeof(complex));
 			if (fread(data, sizeof(complex), N, fp) != (size_t)N) { _aligned_free(data); fclose(fp); return -1; }
-			cache_entry* e = (cache_entry*)malloc0(sizeof(cache_entry));
-			e->hash = hash;
-			e->N = N;
-			e->impulse = data;
-			e->next = NULL;
-			if (tail)       
-				tail->next = e;
-			else
-				_cache_heads[b] = e;
-			tail = e;
-			_cache_counts[b]++;
+			add_impulse_to_cache(b, hash, N, data);
+			_aligned_free(data);
 		}
 	}
 	fclose(fp);
 	return 0;
 }
 
+PORT
+int read_impulse_cache(const char* path)
+{
+	// attaches a version 1 file without reading it; entries are paged in on first lookup
+	if (!_run) return 0;
+
+	free_impulse_cache();
+
+	if (!_use_cache) return 0;
+
+	EnterCriticalSection(&_map.cs);
+	int rc = map_cache_file(path);
+	LeaveCriticalSection(&_map.cs);
+	if (rc == 1)
+		rc = read_legacy_cache(path);
+	return rc;
+}
+
+PORT
+void get_impulse_cache_file_stats(int64_t* mapped_entries, int64_t* disk_hits, int64_t* bad_checksums)
+{
+	*mapped_entries = *disk_hits = *bad_checksums = 0;
+	if (!_run) return;
+	EnterCriticalSection(&_map.cs);
+	*mapped_entries = _map.count;
+	*disk_hits = _map.disk_hits;
+	*bad_checksums = _map.bad_crc;
+	LeaveCriticalSection(&_map.cs);
+}
+
 PORT
 void use_impulse_cache(int use) 
 {
-	EnterCriticalSection(&_cs_use_cache);
-	_use_cache = use;
-	LeaveCriticalSection(&_cs_use_cache);
+	InterlockedExchange(&_use_cache, use);
+}
+
+PORT
+void use_mask_cache(int use)
+{
+	// optional tier holding ready fircore mask sets; when it is off, existing mask entries are dropped
+	InterlockedExchange(&_use_mask_cache, use);
+	if (!use && _run)
+		for (size_t i = 0; i < CACHE_SHARDS; i++) {
+			cache_shard* s = &_shards[i];
+			EnterCriticalSection(&s->cs);
+			for (cache_entry* e = s->head, *n; e; e = n) {
+				n = e->next;
+				if (e->bucket == MASK_CACHE) remove_entry(s, e);
+			}
+			LeaveCriticalSection(&s->cs);
+		}
+}
+
+PORT
+void set_impulse_cache_budget(int64_t bytes)
+{
+	// total memory allowed for cached impulses, including entry headers
+	_budget = bytes > 0 ? (size_t)bytes : 0;
+	if (!_run) return;
+	for (size_t i = 0; i < CACHE_SHARDS; i++) {
+		cache_shard* s = &_shards[i];
+		EnterCriticalSection(&s->cs);
+		trim_shard(s, _budget / CACHE_SHARDS);
+		LeaveCriticalSection(&s->cs);
+	}
+}
+
+PORT
+void get_impulse_cache_stats(int64_t* hits, int64_t* misses, int64_t* evictions, int64_t* entries, int64_t* bytes)
+{
+	*hits = *misses = *evictions = *entries = *bytes = 0;
+	if (!_run) return;
+	for (size_t i = 0; i < CACHE_SHARDS; i++) {
+		cache_shard* s = &_shards[i];
+		EnterCriticalSection(&s->cs);
+		*hits += s->hits;
+		*misses += s->misses;
+		*evictions += s->evictions;
+		*entries += s->entries;
+		*bytes += (int64_t)s->bytes;
+		LeaveCriticalSection(&s->cs);
+	}
+}
+
+PORT
+void reset_impulse_cache_stats(void)
+{
+	if (!_run) return;
+	for (size_t i = 0; i < CACHE_SHARDS; i++) {
+		cache_shard* s = &_shards[i];
+		EnterCriticalSection(&s->cs);
+		s->hits = s->misses = s->evictions = 0;
+		LeaveCriticalSection(&s->cs);
+	}
 }
 
 PORT
 void init_impulse_cache(int use)
 {
-	//InitializeCriticalSection(&_cs_use_cache);
-	InitializeCriticalSectionAndSpinCount(&_cs_use_cache, 2500);
+	for (size_t i = 0; i < CACHE_SHARDS; i++) {
+		memset(&_shards[i], 0, sizeof(cache_shard));
+		InitializeCriticalSectionAndSpinCount(&_shards[i].cs, 2500);
+	}
 
-	EnterCriticalSection(&_cs_use_cache);
-	_use_cache = use;
-	LeaveCriticalSection(&_cs_use_cache);
+	memset(&_map, 0, sizeof(_map));
+	InitializeCriticalSectionAndSpinCount(&_map.cs, 2500);
+	init_crc32();
 
-	_run = 1;
+	InterlockedExchange(&_use_cache, use);
+	InterlockedExchange(&_run, 1);
 }
 
 PORT
 void destroy_impulse_cache(void)
 {
-	_run = 0;
-
-	DeleteCriticalSection(&_cs_use_cache);
+	InterlockedExchange(&_run, 0);
 
 	free_impulse_cache();
+
+	EnterCriticalSection(&_map.cs);
+	unmap_cache_file();
+	LeaveCriticalSection(&_map.cs);
+	DeleteCriticalSection(&_map.cs);
+
+	for (size_t i = 0; i < CACHE_SHARDS; i++)
+		DeleteCriticalSection(&_shards[i].cs);
 }
@@ -63,20 +63,33 @@ mw0lge@grange-lane.co.uk
 	#define GOLDEN_RATIO GOLDEN_RATIO_32
 #endif
 
-#define MAX_CACHE_ENTRIES		4096	// max number of cache entires per cache bucket
+#define IMPULSE_CACHE_BUDGET	(128 * 1024 * 1024)	// default memory budget in bytes, shared by all buckets
+#define CACHE_SHARDS			16		// independently locked shards, power of two
+#define CACHE_SLOTS				256		// hash slots per shard, power of two
 #define CACHE_BUCKETS			4		// 4 cache buckets, for fir_bandpass, mp, eq, fc. Unique indexes in the #defines below
 
 #define FIR_CACHE	0
 #define MP_CACHE	1
 #define EQ_CACHE	2
 #define FC_CACHE	3
+#define MASK_CACHE	4			// frequency-domain fircore masks; derived data, never saved to disk
+#define CACHE_KINDS	5			// CACHE_BUCKETS impulse buckets plus the mask tier
 
 double* get_impulse_cache_entry(size_t bucket, HASH_T hash, int N);
+const double* acquire_impulse_cache_entry(size_t bucket, HASH_T hash, int N);
+void release_impulse_cache_entry(const double* impulse);
 void add_impulse_to_cache(size_t bucket, HASH_T hash, int N, double* impulse);
+void add_blocks_to_cache(size_t bucket, HASH_T hash, int nblocks, int blockN, void** blocks);
+int mask_cache_active(void);
 
 __declspec (dllexport) int save_impulse_cache(const char* path);
 __declspec (dllexport) int read_impulse_cache(const char* path);
 __declspec (dllexport) void use_impulse_cache(int use);
+__declspec (dllexport) void use_mask_cache(int use);
+__declspec (dllexport) void set_impulse_cache_budget(int64_t bytes);
+__declspec (dllexport) void get_impulse_cache_stats(int64_t* hits, int64_t* misses, int64_t* evictions, int64_t* entries, int64_t* bytes);
+__declspec (dllexport) void reset_impulse_cache_stats(void);
+__declspec (dllexport) void get_impulse_cache_file_stats(int64_t* mapped_entries, int64_t* disk_hits, int64_t* bad_checksums);
 
 __declspec (dllexport) void init_impulse_cache(int use);
 __declspec (dllexport) void destroy_impulse_cache(void);
@@ -375,12 +375,159 @@ void downslew2 (IOB a, OUTREAL* pIout, OUTREAL* pQout)
 	}
 }
 
+/********************************************************************************************************
+*																										*
+*										Begin Exchange Signalling										*
+*																										*
+********************************************************************************************************/
+
+// In lock-free mode, fexchange() (the only producer of input and consumer of output) and the dsp thread
+// (the only consumer of input and producer of output) hand off through atomic counters.  A waiting thread
+// spins for an adaptive interval and then sleeps on the counter's address (WaitOnAddress / futex); the
+// poster only makes a kernel call when a waiter may actually be asleep.
+
+#define LF_SPIN_MIN		16
+#define LF_SPIN_MAX		8192
+
+void post_lfsem (volatile LONG* count, volatile LONG* waiters, LONG n)
+{
+	InterlockedExchangeAdd (count, n);
+	if (*waiters) WakeByAddressAll ((void*)count);
+}
+
+void wait_lfsem (volatile LONG* count, volatile LONG* waiters, int* spin)
+{
+	LONG c;
+	int i = 0;
+	int slept = 0;
+	for (;;)
+	{
+		if ((c = *count) > 0)
+		{
+			if (InterlockedCompareExchange (count, c - 1, c) == c)
+				break;
+		}
+		else if (i < *spin)
+		{
+			YieldProcessor();
+			i++;
+		}
+		else
+		{
+			InterlockedIncrement (waiters);
+			WaitOnAddress (count, &c, sizeof (LONG), INFINITE);
+			InterlockedDecrement (waiters);
+			slept = 1;
+		}
+	}
+	if (slept)
+	{	// spinning did not pay off; spin less next time
+		if ((*spin -= *spin >> 3) < LF_SPIN_MIN) *spin = LF_SPIN_MIN;
+	}
+	else if (i > 0)
+	{	// spinning avoided a sleep; allow a little more next time
+		if ((*spin += (*spin >> 3) + 1) > LF_SPIN_MAX) *spin = LF_SPIN_MAX;
+	}
+}
+
+void wait_buffready (IOB a)
+{
+	if (a->lockfree)
+		wait_lfsem (&a->lf_buffready, &a->lf_waiters[0], &a->lf_spin[0]);
+	else
+		WaitForSingleObject (a->Sem_BuffReady, INFINITE);
+}
+
+void release_buffready (IOB a, int n)
+{
+	if (a->lockfree)
+		post_lfsem (&a->lf_buffready, &a->lf_waiters[0], n);
+	else
+		ReleaseSemaphore (a->Sem_BuffReady, n, 0);
+}
+
+void wait_outready (IOB a)
+{
+	if (a->lockfree)
+		wait_lfsem (&a->lf_outready, &a->lf_waiters[1], &a->lf_spin[1]);
+	else
+		WaitForSingleObject (a->Sem_OutReady, INFINITE);
+}
+
+void release_outready (IOB a, int n)
+{
+	if (a->lockfree)
+		post_lfsem (&a->lf_outready, &a->lf_waiters[1], n);
+	else
+		ReleaseSemaphore (a->Sem_OutReady, n, 0);
+}
+
+int take_outsamps (IOB a)
+{	// take 'out_size' samples from the output pseudo-ring; returns 1 if they were available
+	LONG have, left;
+	int doit;
+	if (a->lockfree)
+	{
+		do
+		{
+			have = a->r2_havesamps;
+			if ((left = have - a->out_size) < 0) left = 0;
+		} while (InterlockedCompareExchange (&a->r2_havesamps, left, have) != have);
+		doit = have >= a->out_size;
+	}
+	else
+	{
+		EnterCriticalSection (&a->r2_ControlSection);
+		doit = a->r2_havesamps >= a->out_size;
+		if ((a->r2_havesamps -= a->out_size) < 0) a->r2_havesamps = 0;
+		LeaveCriticalSection (&a->r2_ControlSection);
+	}
+	return doit;
+}
+
+void queue_insamps (IOB a, int* error)
+{	// account for 'in_size' samples just written to the input pseudo-ring and queue full buffers for the dsp
+	// r1_havesamps is not clamped:  every completed buffer is queued, so the dsp reads one buffer for each
+	// buffer written and its read index stays in step with r1_inidx; r1_havesamps therefore always equals
+	// samples written minus samples taken, and exceeds r1_active_buffsize while unread input is overwritten
+	int n;
+	if ((n = InterlockedExchangeAdd (&a->r1_havesamps, a->in_size) + a->in_size) > a->r1_active_buffsize)
+	{	// unprocessed input was overwritten
+		InterlockedIncrement (&a->overruns);
+		*error += -1;
+	}
+	if ((a->r1_unqueuedsamps += a->in_size) >= a->r1_outsize)
+	{
+		n = a->r1_unqueuedsamps / a->r1_outsize;
+		release_buffready (a, n);
+		a->r1_unqueuedsamps -= n * a->r1_outsize;
+	}
+	if ((a->r1_inidx += a->in_size) == a->r1_active_buffsize)
+		a->r1_inidx = 0;
+}
+
 /********************************************************************************************************
 *																										*
 *										  Begin Buffer Code												*
 *																										*
 ********************************************************************************************************/
 
+void lock_iobuffs (IOB a, int lock)
+{	// keep the pseudo-rings resident so the dsp and exchange threads never take a page fault
+	if (lock && !a->locked)
+	{
+		VirtualLock (a->r1_baseptr, a->r1_active_buffsize * sizeof (complex));
+		VirtualLock (a->r2_baseptr, a->r2_active_buffsize * sizeof (complex));
+		a->locked = 1;
+	}
+	else if (!lock && a->locked)
+	{
+		VirtualUnlock (a->r2_baseptr, a->r2_active_buffsize * sizeof (complex));
+		VirtualUnlock (a->r1_baseptr, a->r1_active_buffsize * sizeof (complex));
+		a->locked = 0;
+	}
+}
+
 void create_iobuffs (int channel)
 {
 	int n;
@@ -403,9 +550,12 @@ void create_iobuffs (int channel)
 	a->r2_active_buffsize = DSP_MULT * a->r2_size;
 	a->r1_baseptr = (double*) malloc0 (a->r1_active_buffsize * sizeof (complex));
 	a->r2_baseptr = (double*) malloc0 (a->r2_active_buffsize * sizeof (complex));
+	a->r2_zeros = (double*) malloc0 (a->out_size * sizeof (complex));
+	lock_iobuffs (a, ch[channel].thread.lock_mem);
 	a->r1_inidx = 0;
 	a->r1_outidx = 0;
 	a->r1_unqueuedsamps = 0;
+	a->r1_havesamps = 0;
 	a->r2_inidx = (DSP_MULT - 1) * a->r2_size;
 	a->r2_outidx = 0;
 	a->r2_havesamps = (DSP_MULT - 1) * a->r2_size;
@@ -414,6 +564,10 @@ void create_iobuffs (int channel)
 	InitializeCriticalSectionAndSpinCount(&a->r2_ControlSection, 2500);
 	a->Sem_BuffReady = CreateSemaphore(0, 0, 1000, 0);
 	a->Sem_OutReady  = CreateSemaphore(0, n, 1000, 0);
+	a->lockfree = ch[channel].lockfree;
+	a->lf_buffready = 0;
+	a->lf_outready = n;
+	a->lf_spin[0] = a->lf_spin[1] = LF_SPIN_MIN;
 	a->bfo = ch[channel].bfo;
 	create_slews (a);
 
@@ -435,6 +589,8 @@ void destroy_iobuffs (int channel)
 	CloseHandle (a->Sem_OutReady);
 	CloseHandle (a->Sem_BuffReady);
 	DeleteCriticalSection(&a->r2_ControlSection);
+	lock_iobuffs (a, 0);
+	_aligned_free (a->r2_zeros);
 	_aligned_free (a->r2_baseptr);
 	_aligned_free (a->r1_baseptr);
 	_aligned_free (a);
@@ -449,14 +605,23 @@ void flush_iobuffs (int channel)
 	a->r1_inidx = 0;
 	a->r1_outidx = 0;
 	a->r1_unqueuedsamps = 0;
+	a->r1_havesamps = 0;
 	a->r2_inidx = (DSP_MULT - 1) * a->r2_size;
 	a->r2_outidx = 0;
 	a->r2_havesamps = (DSP_MULT - 1) * a->r2_size;
-	while (!WaitForSingleObject (a->Sem_BuffReady, 1));
 	n = a->r2_havesamps / a->out_size;
 	a->r2_unqueuedsamps = a->r2_havesamps - n * a->out_size;
-	CloseHandle (a->Sem_OutReady);
-	a->Sem_OutReady  = CreateSemaphore(0, n, 1000, 0);
+	if (a->lockfree)
+	{
+		InterlockedExchange (&a->lf_buffready, 0);
+		InterlockedExchange (&a->lf_outready, n);
+	}
+	else
+	{
+		while (!WaitForSingleObject (a->Sem_BuffReady, 1));
+		CloseHandle (a->Sem_OutReady);
+		a->Sem_OutReady  = CreateSemaphore(0, n, 1000, 0);
+	}
 	flush_slews (a);
 }
 
@@ -464,7 +629,6 @@ void flush_iobuffs (int channel)
 PORT	//double, interleaved I/Q
 void fexchange0 (int channel, double* in, double* out, int* error)
 {
-	int n;
 	int doit = 0;
 	IOB a;
 	*error = 0;
@@ -476,22 +640,10 @@ void fexchange0 (int channel, double* in, double* out, int* error)
 			upslew0 (a, in);
 		else
 			memcpy (a->r1_baseptr + 2 * a->r1_inidx, in, a->in_size * sizeof (complex));
-																											// add check with *error += -1; for case when r1 is full and an overwrite occurs
-		if ((a->r1_unqueuedsamps += a->in_size) >= a->r1_outsize)
-		{
-			n = a->r1_unqueuedsamps / a->r1_outsize;
-			ReleaseSemaphore(a->Sem_BuffReady, n, 0);
-			a->r1_unqueuedsamps -= n * a->r1_outsize;
-		}
-		if ((a->r1_inidx += a->in_size) == a->r1_active_buffsize)
-			a->r1_inidx = 0;
+		queue_insamps (a, error);
 
-		EnterCriticalSection (&a->r2_ControlSection);
-		if (a->r2_havesamps >= a->out_size)
-			doit = 1;
-		if ((a->r2_havesamps -= a->out_size) < 0) a->r2_havesamps = 0;
-		LeaveCriticalSection (&a->r2_ControlSection);
-		if (a->bfo) WaitForSingleObject (a->Sem_OutReady, INFINITE);
+		doit = take_outsamps (a);
+		if (a->bfo) wait_outready (a);
 		if (a->bfo || doit)
 			if (_InterlockedAnd (&a->slew.downflag, 1))
 			{
@@ -507,6 +659,7 @@ void fexchange0 (int channel, double* in, double* out, int* error)
 		else
 		{
 			memset (out, 0, a->out_size * sizeof (complex));
+			InterlockedIncrement (&a->underruns);
 			*error += -2;
 		}
 		if ((a->r2_outidx += a->out_size) == a->r2_active_buffsize)
@@ -518,7 +671,7 @@ void fexchange0 (int channel, double* in, double* out, int* error)
 PORT	//separate I/Q buffers
 void fexchange2 (int channel, INREAL *Iin, INREAL *Qin, OUTREAL *Iout, OUTREAL *Qout, int* error)
 {
-	int i, n;
+	int i;
 	int doit = 0;
 	IOB a;
 	*error = 0;
@@ -534,22 +687,10 @@ void fexchange2 (int channel, INREAL *Iin, INREAL *Qin, OUTREAL *Iout, OUTREAL *
 				(a->r1_baseptr + 2 * a->r1_inidx)[2 * i + 0] = (double)(Iin[i]);
 				(a->r1_baseptr + 2 * a->r1_inidx)[2 * i + 1] = (double)(Qin[i]);
 			}
-																										// add check with *error += -1; for case when r1 is full and an overwrite occurs
-		if ((a->r1_unqueuedsamps += a->in_size) >= a->r1_outsize)
-		{
-			n = a->r1_unqueuedsamps / a->r1_outsize;
-			ReleaseSemaphore(a->Sem_BuffReady, n, 0);	
-			a->r1_unqueuedsamps -= n * a->r1_outsize;
-		}
-		if ((a->r1_inidx += a->in_size) == a->r1_active_buffsize)
-			a->r1_inidx = 0;
+		queue_insamps (a, error);
 
-		EnterCriticalSection (&a->r2_ControlSection);
-		if (a->r2_havesamps >= a->out_size)
-			doit = 1;
-		if ((a->r2_havesamps -= a->out_size) < 0) a->r2_havesamps = 0;
-		LeaveCriticalSection (&a->r2_ControlSection);
-		if (a->bfo) WaitForSingleObject (a->Sem_OutReady, INFINITE);
+		doit = take_outsamps (a);
+		if (a->bfo) wait_outready (a);
 		if (a->bfo || doit)
 		{
 			if (_InterlockedAnd (&a->slew.downflag, 1))
@@ -572,6 +713,7 @@ void fexchange2 (int channel, INREAL *Iin, INREAL *Qin, OUTREAL *Iout, OUTREAL *
 		{
 			memset (Iout, 0, a->out_size * sizeof (OUTREAL));
 			memset (Qout, 0, a->out_size * sizeof (OUTREAL));
+			InterlockedIncrement (&a->underruns);
 			*error += -2;
 		}
 		if ((a->r2_outidx += a->out_size) == a->r2_active_buffsize)
@@ -580,25 +722,159 @@ void fexchange2 (int channel, INREAL *Iin, INREAL *Qin, OUTREAL *Iout, OUTREAL *
 	}
 }
 
+/********************************************************************************************************
+*																										*
+*										Zero-Copy Exchange												*
+*																										*
+********************************************************************************************************/
+
+// Equivalent to fexchange0() without the copies:  the caller is lent the next input slot of the input
+// pseudo-ring and the next output slot of the output pseudo-ring and works on them in place.  The four
+// calls must be made in order, from one thread, for each block:
+//		in = BorrowExchangeInput (channel);					// NULL if the channel is not exchanging
+//		... write 'in_size' interleaved I/Q samples to in ...
+//		CommitExchangeInput (channel, &error);
+//		out = BorrowExchangeOutput (channel, &error);
+//		... read 'out_size' interleaved I/Q samples from out ...
+//		ReturnExchangeOutput (channel);
+// csEXCH is held from BorrowExchangeInput() until ReturnExchangeOutput(); as with fexchange0(), the
+// output slot must be consumed promptly since the dsp thread continues to fill the ring.  A call out of
+// sequence abandons the block:  csEXCH is released, the sequence restarts at BorrowExchangeInput(), and
+// -4 is added to 'error' (or returned, by ReturnExchangeOutput()).  The output slot may be written; when
+// processed output is not available it is a zeroed scratch slot.
+
+static void abandon_lend (int channel, IOB a)
+{
+	// csEXCH is held only between BorrowExchangeInput() and ReturnExchangeOutput()
+	if (a->lend_state != 0)
+	{
+		a->lend_state = 0;
+		LeaveCriticalSection (&ch[channel].csEXCH);
+	}
+}
+
+PORT
+double* BorrowExchangeInput (int channel)
+{
+	IOB a;
+	if (!_InterlockedAnd (&ch[channel].exchange, 1))
+		return 0;
+	EnterCriticalSection (&ch[channel].csEXCH);
+	a = ch[channel].iob.pe;
+	abandon_lend (channel, a);								// drop the hold of an unfinished sequence
+	a->lend_state = 1;
+	return a->r1_baseptr + 2 * a->r1_inidx;
+}
+
+PORT
+void CommitExchangeInput (int channel, int* error)
+{
+	IOB a = ch[channel].iob.pe;
+	*error = 0;
+	if (a->lend_state != 1)
+	{
+		abandon_lend (channel, a);
+		*error += -4;
+		return;
+	}
+	if (_InterlockedAnd (&a->slew.upflag, 1))
+		upslew0 (a, a->r1_baseptr + 2 * a->r1_inidx);		// in place
+	queue_insamps (a, error);
+	a->lend_state = 2;
+}
+
+PORT
+double* BorrowExchangeOutput (int channel, int* error)
+{
+	IOB a = ch[channel].iob.pe;
+	double* slot;
+	int doit;
+	if (a->lend_state != 2)
+	{
+		abandon_lend (channel, a);
+		*error += -4;
+		return 0;
+	}
+	doit = take_outsamps (a);
+	if (a->bfo) wait_outready (a);
+	a->lend_state = 3;
+	if (a->bfo || doit)
+	{
+		slot = a->r2_baseptr + 2 * a->r2_outidx;
+		if (_InterlockedAnd (&a->slew.downflag, 1))
+		{
+			downslew0 (a, slot);							// in place
+			if (!_InterlockedAnd (&a->slew.downflag, 1))
+			{
+				InterlockedBitTestAndReset (&ch[channel].exchange, 0);
+				ReleaseSemaphore(a->Sem_Flush, 1, 0);
+			}
+		}
+		return slot;
+	}
+	InterlockedIncrement (&a->underruns);
+	*error += -2;
+	memset (a->r2_zeros, 0, a->out_size * sizeof (complex));	// the previous borrower may have written it
+	return a->r2_zeros;
+}
+
+PORT
+int ReturnExchangeOutput (int channel)
+{
+	IOB a = ch[channel].iob.pe;
+	if (a->lend_state != 3)
+	{
+		abandon_lend (channel, a);
+		return -4;
+	}
+	if ((a->r2_outidx += a->out_size) == a->r2_active_buffsize)
+		a->r2_outidx = 0;
+	a->lend_state = 0;
+	LeaveCriticalSection (&ch[channel].csEXCH);
+	return 0;
+}
+
 void dexchange (int channel, double* in, double* out)
 {
 	int n;
 	IOB a = ch[channel].iob.pd;
 	if (!_InterlockedAnd (&ch[channel].run, 1)) _endthread();
 
-	EnterCriticalSection (&a->r2_ControlSection);
-	a->r2_havesamps += a->r2_insize;
-	LeaveCriticalSection (&a->r2_ControlSection);
+	if (!a->lockfree)
+	{
+		EnterCriticalSection (&a->r2_ControlSection);
+		a->r2_havesamps += a->r2_insize;
+		LeaveCriticalSection (&a->r2_ControlSection);
+	}
 	memcpy (a->r2_baseptr + 2 * a->r2_inidx, in, a->r2_insize * sizeof (complex));
 	if ((a->r2_inidx += a->r2_insize) == a->r2_active_buffsize)
 		a->r2_inidx = 0;
+	if (a->lockfree)	// publish only after the samples are in place
+		InterlockedExchangeAdd (&a->r2_havesamps, a->r2_insize);
 	if (a->bfo && (a->r2_unqueuedsamps += a->r2_insize) >= a->out_size)
 	{
 		n = a->r2_unqueuedsamps / a->out_size;
-		ReleaseSemaphore(a->Sem_OutReady, n, 0);	
+		release_outready (a, n);
 		a->r2_unqueuedsamps -= n * a->out_size;
 	}
 	memcpy (out, a->r1_baseptr + 2 * a->r1_outidx, a->r1_outsize * sizeof (complex));
 	if ((a->r1_outidx += a->r1_outsize) == a->r1_active_buffsize)
 		a->r1_outidx = 0;
+	InterlockedExchangeAdd (&a->r1_havesamps, -a->r1_outsize);
+}
+
+PORT
+void GetChannelExchangeErrors (int channel, int* overruns, int* underruns)
+{
+	IOB a = ch[channel].iob.pc;
+	*overruns  = (int)a->overruns;
+	*underruns = (int)a->underruns;
+}
+
+PORT
+void ResetChannelExchangeErrors (int channel)
+{
+	IOB a = ch[channel].iob.pc;
+	InterlockedExchange (&a->overruns, 0);
+	InterlockedExchange (&a->underruns, 0);
 }
@@ -43,17 +43,28 @@ typedef struct _iobf
 	int   r1_inidx;								// in 'double', actual index into the buffer is 2 times this
 	int   r1_outidx;							// in 'double', actual index into the buffer is 2 times this
 	int   r1_unqueuedsamps;						// number of input samples not yet queued/released for execution
+	volatile LONG r1_havesamps;					// input samples written but not yet taken for processing; > r1_active_buffsize after an overrun
 
 	double* r2_baseptr;							// pointer to output pseudo-ring
 	int   r2_inidx;								// in 'double', actual index into the buffer is 2 times this
 	int   r2_outidx;							// in 'double', actual index into the buffer is 2 times this
-	int   r2_havesamps;							// number of processed samples in output pseudo-ring
+	volatile LONG r2_havesamps;					// number of processed samples in output pseudo-ring
 	int   r2_unqueuedsamps;						// number of output samples not yet queued / released for output
 	CRITICAL_SECTION r2_ControlSection;
+	int   locked;								// pseudo-rings are locked into physical memory
 
 	int bfo;									// block_for_output, wait until output is available before proceeding
 	HANDLE Sem_OutReady;						// count = number of 'out_size' buffers processed and available for output
 	HANDLE Sem_BuffReady;						// count = number of 'dsp_size' buffers queued for processing
+	int   lockfree;								// 1 for lock-free exchange:  the counters below replace the semaphores and r2_ControlSection
+	volatile LONG lf_buffready;					// lock-free count = number of 'dsp_size' buffers queued for processing
+	volatile LONG lf_outready;					// lock-free count = number of 'out_size' buffers processed and available for output
+	volatile LONG lf_waiters[2];				// number of threads that may be asleep on lf_buffready [0] and lf_outready [1]
+	int   lf_spin[2];							// adaptive spin counts before sleeping on lf_buffready [0] and lf_outready [1]
+	volatile LONG overruns;						// count of fexchange() calls that overwrote unprocessed input
+	volatile LONG underruns;					// count of fexchange() calls that returned zeros for lack of processed output
+	int   lend_state;							// progress through a Borrow/Commit/Borrow/Return sequence, 0 when idle
+	double* r2_zeros;							// output slot lent when processed output is not available
 	volatile long exec_bypass;
 	volatile long flush_bypass;
 	HANDLE Sem_Flush;
@@ -80,6 +91,12 @@ extern void destroy_slews (IOB a);
 
 extern void flush_slews (IOB a);
 
+extern void lock_iobuffs (IOB a, int lock);
+
+extern void wait_buffready (IOB a);
+
+extern void release_buffready (IOB a, int n);
+
 extern void create_iobuffs (int channel);
 
 extern void destroy_iobuffs (int channel);
@@ -94,4 +111,22 @@ extern void fexchange2 (int channel, INREAL *Iin, INREAL *Qin, OUTREAL *Iout, OU
 
 extern void dexchange (int channel, double* in, double* out);
 
+PORT	// zero-copy, double, interleaved I/Q
+double* BorrowExchangeInput (int channel);
+
+PORT
+void CommitExchangeInput (int channel, int* error);
+
+PORT
+double* BorrowExchangeOutput (int channel, int* error);
+
+PORT
+int ReturnExchangeOutput (int channel);
+
+PORT
+void GetChannelExchangeErrors (int channel, int* overruns, int* underruns);
+
+PORT
+void ResetChannelExchangeErrors (int channel);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,354 @@
+/*  linux_port.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at
+
+warren@wpratt.com
+
+*/
+
+#include "comm.h"
+
+#if !defined(_WIN32)
+
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+/********************************************************************************************************
+*																										*
+*											Critical Sections											*
+*																										*
+********************************************************************************************************/
+
+BOOL InitializeCriticalSectionAndSpinCount (LPCRITICAL_SECTION cs, DWORD spin)
+{	// Win32 critical sections are recursive; the spin count is left to glibc's adaptive mutex
+	pthread_mutexattr_t attr;
+	(void)spin;
+	pthread_mutexattr_init (&attr);
+	pthread_mutexattr_settype (&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init (cs, &attr);
+	pthread_mutexattr_destroy (&attr);
+	return TRUE;
+}
+
+void InitializeCriticalSection (LPCRITICAL_SECTION cs)
+{
+	InitializeCriticalSectionAndSpinCount (cs, 0);
+}
+
+/********************************************************************************************************
+*																										*
+*									Futex Semaphores and Events											*
+*																										*
+********************************************************************************************************/
+
+enum _lhtype
+{
+	LH_SEMAPHORE = 0,
+	LH_AUTO_EVENT,
+	LH_MANUAL_EVENT
+};
+
+typedef struct _lhandle
+{
+	int type;
+	int maximum;								// maximum semaphore count
+	volatile int count;							// semaphore count or event state; this is the futex word
+	volatile int waiters;						// number of threads that may be sleeping on 'count'
+} lhandle, *LHANDLE;
+
+static long futex (volatile int* uaddr, int op, int val, const struct timespec* timeout)
+{
+	return syscall (SYS_futex, uaddr, op, val, timeout, NULL, 0);
+}
+
+static void wake_lhandle (LHANDLE a, int n)
+{	// only enter the kernel when someone may be asleep
+	if (__atomic_load_n (&a->waiters, __ATOMIC_SEQ_CST) > 0)
+		futex (&a->count, FUTEX_WAKE_PRIVATE, n, NULL);
+}
+
+HANDLE CreateSemaphore (void* attr, LONG initial, LONG maximum, void* name)
+{
+	LHANDLE a = (LHANDLE) malloc0 (sizeof (lhandle));
+	(void)attr;
+	(void)name;
+	a->type = LH_SEMAPHORE;
+	a->maximum = (int)maximum;
+	a->count = (int)initial;
+	return (HANDLE)a;
+}
+
+BOOL ReleaseSemaphore (HANDLE h, LONG count, LONG* prev)
+{
+	LHANDLE a = (LHANDLE)h;
+	int c = __atomic_load_n (&a->count, __ATOMIC_RELAXED);
+	do
+	{
+		if (c + count > a->maximum) return FALSE;
+	} while (!__atomic_compare_exchange_n (&a->count, &c, c + (int)count, 1, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+	if (prev) *prev = c;
+	wake_lhandle (a, (int)count);
+	return TRUE;
+}
+
+HANDLE CreateEvent (void* attr, BOOL manual, BOOL initial, const char* name)
+{
+	LHANDLE a = (LHANDLE) malloc0 (sizeof (lhandle));
+	(void)attr;
+	(void)name;
+	a->type = manual ? LH_MANUAL_EVENT : LH_AUTO_EVENT;
+	a->maximum = 1;
+	a->count = initial ? 1 : 0;
+	return (HANDLE)a;
+}
+
+BOOL SetEvent (HANDLE h)
+{
+	LHANDLE a = (LHANDLE)h;
+	__atomic_store_n (&a->count, 1, __ATOMIC_SEQ_CST);
+	wake_lhandle (a, a->type == LH_MANUAL_EVENT ? INT_MAX : 1);
+	return TRUE;
+}
+
+BOOL ResetEvent (HANDLE h)
+{
+	LHANDLE a = (LHANDLE)h;
+	__atomic_store_n (&a->count, 0, __ATOMIC_SEQ_CST);
+	return TRUE;
+}
+
+static int try_lhandle (LHANDLE a)
+{
+	int c = __atomic_load_n (&a->count, __ATOMIC_ACQUIRE);
+	while (c > 0)
+	{
+		if (a->type == LH_MANUAL_EVENT)
+			return 1;
+		if (__atomic_compare_exchange_n (&a->count, &c, c - 1, 1, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE))
+			return 1;
+	}
+	return 0;
+}
+
+DWORD WaitForSingleObject (HANDLE h, DWORD ms)
+{
+	LHANDLE a = (LHANDLE)h;
+	struct timespec now, deadline, rel;
+	if (try_lhandle (a)) return WAIT_OBJECT_0;
+	if (ms == 0) return WAIT_TIMEOUT;
+	if (ms != INFINITE)
+	{
+		clock_gettime (CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec  += ms / 1000;
+		deadline.tv_nsec += (long)(ms % 1000) * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L)
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+	}
+	__atomic_add_fetch (&a->waiters, 1, __ATOMIC_SEQ_CST);
+	while (!try_lhandle (a))
+	{
+		if (ms == INFINITE)
+			futex (&a->count, FUTEX_WAIT_PRIVATE, 0, NULL);
+		else
+		{
+			clock_gettime (CLOCK_MONOTONIC, &now);
+			rel.tv_sec  = deadline.tv_sec  - now.tv_sec;
+			rel.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+			if (rel.tv_nsec < 0)
+			{
+				rel.tv_sec--;
+				rel.tv_nsec += 1000000000L;
+			}
+			if (rel.tv_sec < 0 || (futex (&a->count, FUTEX_WAIT_PRIVATE, 0, &rel) < 0 && errno == ETIMEDOUT))
+			{
+				if (try_lhandle (a)) break;
+				__atomic_sub_fetch (&a->waiters, 1, __ATOMIC_SEQ_CST);
+				return WAIT_TIMEOUT;
+			}
+		}
+	}
+	__atomic_sub_fetch (&a->waiters, 1, __ATOMIC_SEQ_CST);
+	return WAIT_OBJECT_0;
+}
+
+BOOL CloseHandle (HANDLE h)
+{
+	_aligned_free (h);
+	return TRUE;
+}
+
+BOOL WaitOnAddress (volatile void* addr, void* cmp, size_t size, DWORD ms)
+{	// like Win32, may return spuriously; callers re-check the value
+	struct timespec rel;
+	(void)size;
+	if (ms == INFINITE)
+		return futex ((volatile int*)addr, FUTEX_WAIT_PRIVATE, *(int*)cmp, NULL) == 0 || errno != ETIMEDOUT;
+	rel.tv_sec = ms / 1000;
+	rel.tv_nsec = (long)(ms % 1000) * 1000000L;
+	return futex ((volatile int*)addr, FUTEX_WAIT_PRIVATE, *(int*)cmp, &rel) == 0 || errno != ETIMEDOUT;
+}
+
+void WakeByAddressSingle (void* addr)
+{
+	futex ((volatile int*)addr, FUTEX_WAKE_PRIVATE, 1, NULL);
+}
+
+void WakeByAddressAll (void* addr)
+{
+	futex ((volatile int*)addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL);
+}
+
+/********************************************************************************************************
+*																										*
+*												Threads													*
+*																										*
+********************************************************************************************************/
+
+typedef struct _lthread
+{
+	void  (*vfunc)(void*);
+	DWORD (*dfunc)(void*);
+	void* arg;
+} lthread, *LTHREAD;
+
+static void* lthread_start (void* p)
+{
+	LTHREAD t = (LTHREAD)p;
+	void  (*vfunc)(void*) = t->vfunc;
+	DWORD (*dfunc)(void*) = t->dfunc;
+	void* arg = t->arg;
+	free (t);
+	if (vfunc) vfunc (arg);
+	else       dfunc (arg);
+	return NULL;
+}
+
+static int create_lthread (void (*vfunc)(void*), DWORD (*dfunc)(void*), unsigned stack, void* arg)
+{
+	pthread_t tid;
+	pthread_attr_t attr;
+	int rc;
+	LTHREAD t = (LTHREAD) malloc (sizeof (lthread));
+	if (!t) return -1;
+	t->vfunc = vfunc;
+	t->dfunc = dfunc;
+	t->arg = arg;
+	pthread_attr_init (&attr);
+	pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+	if (stack) pthread_attr_setstacksize (&attr, stack < PTHREAD_STACK_MIN ? PTHREAD_STACK_MIN : stack);
+	rc = pthread_create (&tid, &attr, lthread_start, t);
+	pthread_attr_destroy (&attr);
+	if (rc != 0)
+	{
+		free (t);
+		return -1;
+	}
+	return 0;
+}
+
+uintptr_t _beginthread (void (*start)(void*), unsigned stack, void* arg)
+{
+	if (create_lthread (start, NULL, stack, arg) != 0)
+		return (uintptr_t)-1;
+	return 0;
+}
+
+BOOL QueueUserWorkItem (DWORD (*func)(void*), void* arg, DWORD flags)
+{
+	(void)flags;
+	return create_lthread (NULL, func, 0, arg) == 0;
+}
+
+int linux_set_rt_thread (int priority, uint64_t mask)
+{	// priority:  < 0, leave as SCHED_OTHER; 0, default real-time priority; > 0, SCHED_FIFO priority
+	// mask:  cpu affinity bit-mask; 0 leaves affinity unchanged
+	// returns 0 on success, otherwise the first error encountered (e.g., EPERM without CAP_SYS_NICE)
+	int rc = 0;
+	int i, pmin, pmax;
+	struct sched_param sp;
+	memset (&sp, 0, sizeof (sp));
+	if (priority < 0)
+		rc = pthread_setschedparam (pthread_self(), SCHED_OTHER, &sp);
+	else
+	{
+		pmin = sched_get_priority_min (SCHED_FIFO);
+		pmax = sched_get_priority_max (SCHED_FIFO);
+		if (priority == 0) priority = LINUX_DEFAULT_RT_PRIORITY;
+		if (priority < pmin) priority = pmin;
+		if (priority > pmax) priority = pmax;
+		sp.sched_priority = priority;
+		rc = pthread_setschedparam (pthread_self(), SCHED_FIFO, &sp);
+	}
+	if (mask)
+	{
+		cpu_set_t cpus;
+		CPU_ZERO (&cpus);
+		for (i = 0; i < 64 && i < CPU_SETSIZE; i++)
+			if (mask & ((uint64_t)1 << i))
+				CPU_SET (i, &cpus);
+		i = pthread_setaffinity_np (pthread_self(), sizeof (cpus), &cpus);
+		if (rc == 0) rc = i;
+	}
+	return rc;
+}
+
+void Sleep (DWORD ms)
+{
+	struct timespec ts;
+	ts.tv_sec = ms / 1000;
+	ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+	while (nanosleep (&ts, &ts) == -1 && errno == EINTR);
+}
+
+BOOL QueryPerformanceCounter (LARGE_INTEGER* count)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	count->QuadPart = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+	return TRUE;
+}
+
+BOOL QueryPerformanceFrequency (LARGE_INTEGER* freq)
+{
+	freq->QuadPart = 1000000000LL;
+	return TRUE;
+}
+
+/********************************************************************************************************
+*																										*
+*												Memory													*
+*																										*
+********************************************************************************************************/
+
+void* linux_aligned_malloc (size_t size, size_t align)
+{
+	void* p = 0;
+	if (align < sizeof (void*)) align = sizeof (void*);
+	if (posix_memalign (&p, align, size ? size : 1) != 0)
+		return 0;
+	return p;
+}
+
+#endif
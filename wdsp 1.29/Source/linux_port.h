@@ -0,0 +1,164 @@
+/*  linux_port.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at
+
+warren@wpratt.com
+
+*/
+
+// POSIX (pthreads + futex) implementation of the subset of the Win32 API used by WDSP.
+// Included by comm.h in place of <Windows.h> when not building for Windows.  The
+// semantics of each call match the Win32 behaviour that WDSP relies upon so that
+// fexchange0(), fexchange2(), dexchange() and the channel/flush threads are unchanged.
+
+#ifndef _linux_port_h
+#define _linux_port_h
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/mman.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#include <pmmintrin.h>
+#else
+#define _MM_FLUSH_ZERO_ON				0
+#define _MM_SET_FLUSH_ZERO_MODE(x)
+#endif
+
+// types
+typedef int								BOOL;
+typedef unsigned char					BYTE;
+typedef unsigned char					byte;
+typedef unsigned short					WORD;
+typedef uint32_t						DWORD;
+typedef int32_t							LONG;				// 32 bits as on Windows, so LONGs can be futex words
+typedef uint64_t						DWORD_PTR;
+typedef void*							HANDLE;
+typedef pthread_mutex_t					CRITICAL_SECTION;
+typedef pthread_mutex_t*				LPCRITICAL_SECTION;
+typedef union { struct { DWORD LowPart; LONG HighPart; } u; int64_t QuadPart; } LARGE_INTEGER;
+
+#define TRUE							1
+#define FALSE							0
+#define INFINITE						0xFFFFFFFF
+#define WAIT_OBJECT_0					0x00000000L
+#define WAIT_TIMEOUT					0x00000102L
+#define WAIT_FAILED						0xFFFFFFFF
+#define WINAPI
+#define __cdecl
+#define __stdcall
+#define __declspec(x)					__declspec_##x
+#define __declspec_dllexport			__attribute__((visibility("default")))
+#define __declspec_align(n)				__attribute__((aligned(n)))
+#define __declspec_thread				__thread
+#define __forceinline					inline __attribute__((always_inline))
+#define TEXT(x)							x
+#define THREAD_PRIORITY_NORMAL			0
+#define THREAD_PRIORITY_HIGHEST			2
+#define LINUX_DEFAULT_RT_PRIORITY		80		// SCHED_FIFO priority used in place of MMCSS "Pro Audio"
+
+#ifndef max
+#define max(a, b)						(((a) > (b)) ? (a) : (b))
+#endif
+#ifndef min
+#define min(a, b)						(((a) < (b)) ? (a) : (b))
+#endif
+
+// critical sections (recursive, as on Windows)
+extern BOOL InitializeCriticalSectionAndSpinCount (LPCRITICAL_SECTION cs, DWORD spin);
+extern void InitializeCriticalSection (LPCRITICAL_SECTION cs);
+#define EnterCriticalSection(cs)		pthread_mutex_lock(cs)
+#define LeaveCriticalSection(cs)		pthread_mutex_unlock(cs)
+#define DeleteCriticalSection(cs)		pthread_mutex_destroy(cs)
+
+// semaphores and events (futex based)
+extern HANDLE CreateSemaphore (void* attr, LONG initial, LONG maximum, void* name);
+extern BOOL ReleaseSemaphore (HANDLE h, LONG count, LONG* prev);
+extern HANDLE CreateEvent (void* attr, BOOL manual, BOOL initial, const char* name);
+extern BOOL SetEvent (HANDLE h);
+extern BOOL ResetEvent (HANDLE h);
+extern DWORD WaitForSingleObject (HANDLE h, DWORD ms);
+extern BOOL CloseHandle (HANDLE h);
+
+// address waits (futex based; only 4-byte words are supported)
+extern BOOL WaitOnAddress (volatile void* addr, void* cmp, size_t size, DWORD ms);
+extern void WakeByAddressSingle (void* addr);
+extern void WakeByAddressAll (void* addr);
+#if defined(__x86_64__) || defined(__i386__)
+#define YieldProcessor()				_mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define YieldProcessor()				__asm__ __volatile__ ("yield")
+#else
+#define YieldProcessor()
+#endif
+
+// threads
+extern uintptr_t _beginthread (void (*start)(void*), unsigned stack, void* arg);
+#define _endthread()					pthread_exit(NULL)
+extern BOOL QueueUserWorkItem (DWORD (*func)(void*), void* arg, DWORD flags);
+#define SetThreadPriority(h, p)			({ (void)(h); TRUE; })		// real-time scheduling is applied through linux_set_rt_thread()
+extern int linux_set_rt_thread (int priority, uint64_t mask);
+extern void Sleep (DWORD ms);
+
+// timing (CLOCK_MONOTONIC, nanosecond ticks)
+extern BOOL QueryPerformanceCounter (LARGE_INTEGER* count);
+extern BOOL QueryPerformanceFrequency (LARGE_INTEGER* freq);
+
+// memory
+#define _aligned_malloc(size, align)	linux_aligned_malloc(size, align)
+#define _aligned_free(p)				free(p)
+#define VirtualLock(p, size)			({ mlock ((p), (size)) == 0; })
+#define VirtualUnlock(p, size)			({ munlock ((p), (size)) == 0; })
+extern void* linux_aligned_malloc (size_t size, size_t align);
+
+// console (used by wisdom)
+#define AllocConsole()
+#define FreeConsole()
+#define freopen_s(pstream, name, mode, f)	({ *(pstream) = (f); 0; })
+
+// interlocked operations; like Win32 these are full barriers
+#define InterlockedIncrement(p)				__atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define InterlockedDecrement(p)				__atomic_sub_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define InterlockedExchange(p, v)			__atomic_exchange_n((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedExchangeAdd(p, v)		__atomic_fetch_add((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedCompareExchange(p, v, c)	__sync_val_compare_and_swap((p), (c), (v))
+#define InterlockedAnd(p, v)				__atomic_fetch_and((p), (v), __ATOMIC_SEQ_CST)
+#define _InterlockedAnd(p, v)				__atomic_fetch_and((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedOr(p, v)					__atomic_fetch_or((p), (v), __ATOMIC_SEQ_CST)
+
+// statement expressions, so the usual statement-form calls don't leave an unused value; typed from '*p'
+// since both LONG and long words are used
+#define InterlockedBitTestAndSet(p, b)		({ __typeof__ (*(p) + 0) _m = (__typeof__ (*(p) + 0))1 << (b); \
+											(BYTE)((__atomic_fetch_or ((p), _m, __ATOMIC_SEQ_CST) & _m) != 0); })
+#define InterlockedBitTestAndReset(p, b)	({ __typeof__ (*(p) + 0) _m = (__typeof__ (*(p) + 0))1 << (b); \
+											(BYTE)((__atomic_fetch_and ((p), ~_m, __ATOMIC_SEQ_CST) & _m) != 0); })
+
+#endif
@@ -26,17 +26,47 @@ warren@wpratt.com
 
 #include "comm.h"
 
-void wdspmain (void *pargs)
+void set_thread_main (int channel, HANDLE* hTask)
 {
+	long rc = 0;
+#if defined(_WIN32)
 	DWORD taskIndex = 0;
-	HANDLE hTask = AvSetMmThreadCharacteristics(TEXT("Pro Audio"), &taskIndex);
-	if (hTask != 0) AvSetMmThreadPriority(hTask, 2);
-	else SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+	if (*hTask != 0)
+	{
+		AvRevertMmThreadCharacteristics (*hTask);
+		*hTask = 0;
+	}
+	if (ch[channel].thread.priority >= 0)
+	{
+		*hTask = AvSetMmThreadCharacteristics(TEXT("Pro Audio"), &taskIndex);
+		if (*hTask != 0) AvSetMmThreadPriority(*hTask, 2);
+		else if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST)) rc = GetLastError();
+	}
+	else if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_NORMAL))
+		rc = GetLastError();
+	if (ch[channel].thread.affinity)
+		if (!SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)ch[channel].thread.affinity) && rc == 0)
+			rc = GetLastError();
+#else
+	*hTask = 0;
+	rc = linux_set_rt_thread (ch[channel].thread.priority, ch[channel].thread.affinity);
+#endif
+	// kept for GetChannelThreadStatus(); the setters only request the change
+	InterlockedExchange (&ch[channel].thread.status, rc);
+}
 
+void wdspmain (void *pargs)
+{
+	HANDLE hTask = 0;
 	int channel = (int)(uintptr_t)pargs;
+	InterlockedBitTestAndReset (&ch[channel].thread.update, 0);
+	set_thread_main (channel, &hTask);
+
 	while (_InterlockedAnd (&ch[channel].run, 1))
 	{
-		WaitForSingleObject(ch[channel].iob.pd->Sem_BuffReady,INFINITE);
+		wait_buffready (ch[channel].iob.pd);
+		if (InterlockedBitTestAndReset (&ch[channel].thread.update, 0))
+			set_thread_main (channel, &hTask);
 		EnterCriticalSection (&ch[channel].csDSP);
 		if (!_InterlockedAnd (&ch[channel].iob.pd->exec_bypass, 1))
 		{
@@ -57,7 +87,9 @@ void wdspmain (void *pargs)
 		}
 		LeaveCriticalSection (&ch[channel].csDSP);
 	}
+#if defined(_WIN32)
 	if (hTask != 0) AvRevertMmThreadCharacteristics (hTask);
+#endif
 }
 
 void create_main (int channel)
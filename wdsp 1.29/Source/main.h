@@ -29,6 +29,8 @@ warren@wpratt.com
 
 extern void wdspmain (void *pargs);
 
+extern void set_thread_main (int channel, HANDLE* hTask);
+
 extern void create_main (int channel);
 
 extern void destroy_main (int channel);
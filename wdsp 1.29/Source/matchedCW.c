@@ -121,7 +121,7 @@ double* build_matched(int* imp_size, double rate, double f, double fwhm, double
 ********************************************************************************************************/
 
 MATCHED create_matched (int run, int position, int size, double* in, double* out,
-	double f_center, double bandwidth, int samplerate, double gain, int mode)
+	double f_center, double bandwidth, int samplerate, double gain, int mode, int precision)
 {
 	MATCHED a = (MATCHED) malloc0 (sizeof(matched));
 	double* impulse;
@@ -137,7 +137,7 @@ MATCHED create_matched (int run, int position, int size, double* in, double* out
 	a->scale = a->gain / (double)(2 * a->size);
 	a->mode = mode;
 	impulse = build_matched (&a->nc, a->samplerate, a->f_center, a->bandwidth, a->scale, 0);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, 0, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, 0, impulse, precision);
 	_aligned_free (impulse);
 	return a;
 }
@@ -51,7 +51,7 @@ typedef struct _matchedCW
 } matched, *MATCHED;
 
 extern MATCHED create_matched (int run, int position, int size, double* in, double* out,
-	double f_center, double bandwidth, int samplerate, double gain, int mode);
+	double f_center, double bandwidth, int samplerate, double gain, int mode, int precision);
 
 extern void destroy_matched (MATCHED a);
 
@@ -24,4 +24,10 @@ warren@wpratt.com
 
 */
 
+#define MLOG10_BITS		11			// mantissa bits used to index mlog10_table
+
+extern const double mlog10_conv;
+
+extern const double mlog10_table[];
+
 extern double mlog10 (double val);
\ No newline at end of file
@@ -242,7 +242,7 @@ void calc_nbp_impulse (NBP a)
 }
 
 NBP create_nbp(int run, int fnfrun, int position, int size, int nc, int mp, double* in, double* out, 
-	double flow, double fhigh, int rate, int wintype, double gain, int autoincr, int maxpb, NOTCHDB* ptraddr)
+	double flow, double fhigh, int rate, int wintype, double gain, int autoincr, int maxpb, NOTCHDB* ptraddr, int precision)
 {
 	NBP a = (NBP) malloc0 (sizeof (nbp));
 	a->run = run;
@@ -264,7 +264,7 @@ NBP create_nbp(int run, int fnfrun, int position, int size, int nc, int mp, doub
 	a->bplow   = (double *) malloc0 (a->maxpb * sizeof (double));
 	a->bphigh  = (double *) malloc0 (a->maxpb * sizeof (double));
 	calc_nbp_impulse (a);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, a->impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, a->impulse, precision);
 	// print_impulse ("nbp.txt", a->size + 1, impulse, 1, 0);
 	_aligned_free(a->impulse);
 	return a;
@@ -73,7 +73,7 @@ typedef struct _nbp
 } nbp, *NBP;
 
 extern NBP create_nbp(int run, int fnfrun, int position, int size, int nc, int mp, double* in, double* out, 
-	double flow, double fhigh, int rate, int wintype, double gain, int autoincr, int maxpb, NOTCHDB* ptraddr);
+	double flow, double fhigh, int rate, int wintype, double gain, int autoincr, int maxpb, NOTCHDB* ptraddr, int precision);
 
 extern void destroy_nbp (NBP a);
 
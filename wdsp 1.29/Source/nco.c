@@ -0,0 +1,194 @@
+/*  nco.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+#include "comm.h"
+
+/********************************************************************************************************
+*																										*
+*									Numerically Controlled Oscillator									*
+*																										*
+********************************************************************************************************/
+
+#define NCO_BITS		10
+#define NCO_SIZE		(1 << NCO_BITS)
+#define NCO_SHIFT		(64 - NCO_BITS)
+
+static double nco_tab[2 * NCO_SIZE];		// cos and sin of 2 * pi * k / NCO_SIZE
+static volatile LONG nco_tab_state = 0;		// 0, not built; 1, building; 2, ready
+
+static void init_nco_tab (void)
+{
+	int k;
+	if (nco_tab_state == 2) return;
+	if (InterlockedCompareExchange (&nco_tab_state, 1, 0) == 0)
+	{
+		for (k = 0; k < NCO_SIZE; k++)
+		{
+			nco_tab[2 * k + 0] = cos (TWOPI * (double)k / (double)NCO_SIZE);
+			nco_tab[2 * k + 1] = sin (TWOPI * (double)k / (double)NCO_SIZE);
+		}
+		InterlockedExchange (&nco_tab_state, 2);
+	}
+	else
+		while (nco_tab_state != 2) Sleep (0);
+}
+
+static uint64_t nco_turns (double rad)
+{
+	// radians to 2^-64 turns, in two 32-bit parts so that the full precision of 'rad' is kept
+	double s = rad * (4294967296.0 / TWOPI);
+	int64_t hi = (int64_t)s;
+	int64_t lo = (int64_t)((s - (double)hi) * 4294967296.0);
+	return ((uint64_t)hi << 32) + (uint64_t)lo;
+}
+
+static void nco_cs (uint64_t phase, double* cs)
+{
+	uint64_t k = (phase + ((uint64_t)1 << (NCO_SHIFT - 1))) >> NCO_SHIFT;
+	double e = (double)(int64_t)(phase - (k << NCO_SHIFT)) * (TWOPI / 18446744073709551616.0);
+	double e2 = e * e;
+	double se = e * (1.0 - e2 * (1.0 / 6.0) * (1.0 - e2 * (1.0 / 20.0)));	// sin (e)
+	double ce = e2 * 0.5 * (1.0 - e2 * (1.0 / 12.0));						// 1 - cos (e)
+	double* t = nco_tab + 2 * (k & (NCO_SIZE - 1));
+	cs[0] = t[0] - (t[0] * ce + t[1] * se);
+	cs[1] = t[1] - (t[1] * ce - t[0] * se);
+}
+
+void init_nco (NCO a, double delta)
+{
+	a->phase = 0;
+	setDelta_nco (a, delta);
+}
+
+void flush_nco (NCO a)
+{
+	a->phase = 0;
+}
+
+void setDelta_nco (NCO a, double delta)
+{
+	// 'delta' is the phase increment in radians per sample
+	int j;
+	init_nco_tab ();
+	a->freq = nco_turns (delta);
+	for (j = 0; j < NCO_STEPS; j++)
+		nco_cs ((uint64_t)j * a->freq, a->rot + 2 * j);
+}
+
+void advance_nco (NCO a, double dphs)
+{
+	a->phase += nco_turns (dphs);
+}
+
+void cs_nco (NCO a, double* cs)
+{
+	// cos and sin of the current phase
+	nco_cs (a->phase, cs);
+}
+
+void xnco (NCO a, double* cs)
+{
+	// cos and sin of the current phase, then step
+	nco_cs (a->phase, cs);
+	a->phase += a->freq;
+}
+
+void xncob (NCO a, int n, double* cs)
+{
+	// 'n' interleaved cos, sin pairs, then step 'n' times
+	int i, j, m;
+	double w[2];
+	for (i = 0; i < n; i += NCO_STEPS)
+	{
+		nco_cs (a->phase + (uint64_t)i * a->freq, w);
+		m = n - i < NCO_STEPS ? n - i : NCO_STEPS;
+		for (j = 0; j < m; j++)
+		{
+			cs[2 * (i + j) + 0] = w[0] * a->rot[2 * j + 0] - w[1] * a->rot[2 * j + 1];
+			cs[2 * (i + j) + 1] = w[0] * a->rot[2 * j + 1] + w[1] * a->rot[2 * j + 0];
+		}
+	}
+	a->phase += (uint64_t)n * a->freq;
+}
+
+/********************************************************************************************************
+*																										*
+*											Fast atan2											*
+*																										*
+********************************************************************************************************/
+
+#define TAN_PI_8		0.41421356237309504880
+
+static const double atan_c[11] =
+{
+	+1.00000000000000000e+00,
+	-3.33333333333284521e-01,
+	+1.99999999988567073e-01,
+	-1.42857141810728033e-01,
+	+1.11111061835429847e-01,
+	-9.09077313556982403e-02,
+	+7.68995427503776641e-02,
+	-6.64024043654616036e-02,
+	+5.68838317100882757e-02,
+	-4.34815196598343223e-02,
+	+2.11366275528167558e-02
+};
+
+double fatan2 (double y, double x)
+{
+	double ax = fabs (x);
+	double ay = fabs (y);
+	double lo = ay < ax ? ay : ax;
+	double hi = ay < ax ? ax : ay;
+	double t, t2, p, r;
+	if (hi == 0.0) return 0.0;
+	// atan (lo / hi) in [0, pi / 4]; beyond pi / 8, as pi / 4 + atan ((lo - hi) / (lo + hi))
+	if (lo > TAN_PI_8 * hi)
+	{
+		t = (lo - hi) / (lo + hi);
+		r = 0.25 * PI;
+	}
+	else
+	{
+		t = lo / hi;
+		r = 0.0;
+	}
+	t2 = t * t;
+	p = atan_c[10];
+	p = p * t2 + atan_c[9];
+	p = p * t2 + atan_c[8];
+	p = p * t2 + atan_c[7];
+	p = p * t2 + atan_c[6];
+	p = p * t2 + atan_c[5];
+	p = p * t2 + atan_c[4];
+	p = p * t2 + atan_c[3];
+	p = p * t2 + atan_c[2];
+	p = p * t2 + atan_c[1];
+	r += t + t * t2 * p;
+	if (ay > ax) r = 0.5 * PI - r;
+	if (x < 0.0) r = PI - r;
+	return y < 0.0 ? -r : r;
+}
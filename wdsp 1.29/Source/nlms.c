@@ -0,0 +1,121 @@
+/*  nlms.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+#include "comm.h"
+
+/********************************************************************************************************
+*																										*
+*							Leaky NLMS Adaptive Line Enhancer (ANR / ANF Engine)						*
+*																										*
+********************************************************************************************************/
+
+NLMS create_nlms (int output, int dline_size, int n_taps, int delay, double two_mu, double gamma,
+	double lidx, double lidx_min, double lidx_max, double ngamma, double den_mult, double lincr, double ldecr)
+{
+	NLMS a = (NLMS) malloc0 (sizeof (nlms));
+	a->output = output;
+	a->dline_size = dline_size;
+	a->mask = dline_size - 1;
+	a->n_taps = n_taps;
+	a->delay = delay;
+	a->two_mu = two_mu;
+	a->gamma = gamma;
+	a->lidx = lidx;
+	a->lidx_min = lidx_min;
+	a->lidx_max = lidx_max;
+	a->ngamma = ngamma;
+	a->den_mult = den_mult;
+	a->lincr = lincr;
+	a->ldecr = ldecr;
+	a->d = (double *) malloc0 (2 * a->dline_size * sizeof (double));
+	a->w = (double *) malloc0 (a->dline_size * sizeof (double));
+	flush_nlms (a);
+	return a;
+}
+
+void destroy_nlms (NLMS a)
+{
+	_aligned_free (a->w);
+	_aligned_free (a->d);
+	_aligned_free (a);
+}
+
+void flush_nlms (NLMS a)
+{
+	// called after every change of 'n_taps' or 'delay'; both windows, the taps and the sample that leaves
+	// them, must fit in the delay line
+	if (a->delay > a->dline_size - 2) a->delay = a->dline_size - 2;
+	if (a->delay < 0) a->delay = 0;
+	if (a->n_taps > a->dline_size - 1 - a->delay) a->n_taps = a->dline_size - 1 - a->delay;
+	if (a->n_taps < 1) a->n_taps = 1;
+	memset (a->d, 0, 2 * a->dline_size * sizeof (double));
+	memset (a->w, 0, a->dline_size * sizeof (double));
+	a->in_idx = 0;
+}
+
+void xnlms (NLMS a, int n, double* in, double* out)
+{
+	// 'in' and 'out' hold 'n' complex samples; only the real parts are used and the imaginary outputs are zero
+	int i;
+	double* x;
+	double c0, c1;
+	double y, error, sigma, inv_sigp;
+	double nel, nev;
+	// energy of the taps used for the previous sample
+	sigma = vsumsq (a->n_taps, a->d + a->in_idx + 1 + a->delay);
+	for (i = 0; i < n; i++)
+	{
+		a->d[a->in_idx] = a->d[a->in_idx + a->dline_size] = in[2 * i + 0];
+		x = a->d + a->in_idx + a->delay;
+		sigma += x[0] * x[0] - x[a->n_taps] * x[a->n_taps];
+		if (sigma < 0.0) sigma = 0.0;
+
+		y = vdot (a->n_taps, a->w, x);
+		inv_sigp = 1.0 / (sigma + 1e-10);
+		error = a->d[a->in_idx] - y;
+
+		out[2 * i + 0] = (a->output == NLMS_OUT_ERROR) ? error : y;
+		out[2 * i + 1] = 0.0;
+
+		if((nel = error * (1.0 - a->two_mu * sigma * inv_sigp)) < 0.0) nel = -nel;
+		if((nev = a->d[a->in_idx] - (1.0 - a->two_mu * a->ngamma) * y - a->two_mu * error * sigma * inv_sigp) < 0.0) nev = -nev;
+		if (nev < nel)
+		{
+			if ((a->lidx += a->lincr) > a->lidx_max) a->lidx = a->lidx_max;
+		}
+		else
+		{
+			if ((a->lidx -= a->ldecr) < a->lidx_min) a->lidx = a->lidx_min;
+		}
+		a->ngamma = a->gamma * (a->lidx * a->lidx) * (a->lidx * a->lidx) * a->den_mult;
+
+		c0 = 1.0 - a->two_mu * a->ngamma;
+		c1 = a->two_mu * error * inv_sigp;
+
+		vaxpby (a->n_taps, a->w, c0, c1, x);
+		a->in_idx = (a->in_idx + a->mask) & a->mask;
+	}
+}
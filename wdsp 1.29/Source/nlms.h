@@ -0,0 +1,78 @@
+/*  nlms.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+/********************************************************************************************************
+*																										*
+*							Leaky NLMS Adaptive Line Enhancer (ANR / ANF Engine)						*
+*																										*
+********************************************************************************************************/
+
+// The adaptive filter predicts each input sample from the 'n_taps' samples that start 'delay' samples back.
+// ANR outputs the prediction (the correlated part of the signal), ANF outputs the prediction error (the
+// signal with its correlated tones removed).  The delay line is stored twice so that the taps are always
+// contiguous, the input energy 'sigma' is updated as a sliding sum (recomputed at the start of every
+// buffer so that rounding cannot build up), and the dot product and weight update use the vmath kernels.
+// 'n_taps' + 'delay' must be less than 'dline_size'; flush_nlms() enforces this.
+
+#ifndef _nlms_h
+#define _nlms_h
+#include "comm.h"
+
+#define NLMS_OUT_PREDICTION		0			// output y, as in ANR
+#define NLMS_OUT_ERROR			1			// output the error, as in ANF
+
+typedef struct _nlms
+{
+	int output;						// NLMS_OUT_PREDICTION or NLMS_OUT_ERROR
+	int dline_size;					// power of two
+	int mask;
+	int n_taps;
+	int delay;
+	double two_mu;
+	double gamma;
+	double* d;						// delay line, 2 * dline_size, the second half repeating the first
+	double* w;						// weights, dline_size
+	int in_idx;
+
+	double lidx;
+	double lidx_min;
+	double lidx_max;
+	double ngamma;
+	double den_mult;
+	double lincr;
+	double ldecr;
+} nlms, *NLMS;
+
+extern NLMS create_nlms (int output, int dline_size, int n_taps, int delay, double two_mu, double gamma,
+	double lidx, double lidx_min, double lidx_max, double ngamma, double den_mult, double lincr, double ldecr);
+
+extern void destroy_nlms (NLMS a);
+
+extern void flush_nlms (NLMS a);
+
+extern void xnlms (NLMS a, int n, double* in, double* out);
+
+#endif
@@ -41,10 +41,12 @@ void calc_osctrl (OSCTRL a)
 	a->in_idx = 0;
 	a->out_idx = a->in_idx + a->dl_len;
 	a->max_env = 0.0;
+	a->smax = create_slmax (a->pn, a->pn);
 }
 
 void decalc_osctrl (OSCTRL a)
 {
+	destroy_slmax (a->smax);
 	_aligned_free (a->dlenv);
 	_aligned_free (a->dl);
 }
@@ -79,14 +81,15 @@ void flush_osctrl (OSCTRL a)
 {
 	memset (a->dl,    0, a->dl_len * sizeof (complex));
 	memset (a->dlenv, 0, a->pn     * sizeof (double));
+	flush_slmax (a->smax);
 }
 
 void xosctrl (OSCTRL a)
 {
 	if (a->run)
 	{
-		int i, j;
-		double divisor;
+		int i;
+		double divisor, win_max;
 		for (i = 0; i < a->size; i++)
 		{
 			a->dl[2 * a->in_idx + 0] = a->inbuff[2 * i + 0];							// put sample in delay line
@@ -94,13 +97,10 @@ void xosctrl (OSCTRL a)
 			a->env_out = a->dlenv[a->in_idx];											// take env out of delay line
 			a->dlenv[a->in_idx] = sqrt (a->inbuff[2 * i + 0] * a->inbuff[2 * i + 0]		// put env in delay line 
 			                          + a->inbuff[2 * i + 1] * a->inbuff[2 * i + 1]);
+			win_max = xslmax (a->smax, a->dlenv[a->in_idx]);
 			if (a->dlenv[a->in_idx]  >  a->max_env) a->max_env = a->dlenv[a->in_idx];
-			if (a->env_out >= a->max_env && a->env_out > 0.0)							// run the buffer
-			{
-				a->max_env = 0.0;
-				for (j = 0; j < a->pn; j++)
-					if (a->dlenv[j] > a->max_env) a->max_env = a->dlenv[j];
-			}
+			if (a->env_out >= a->max_env && a->env_out > 0.0)							// max of the buffer
+				a->max_env = win_max;
 			if (a->max_env > 1.0) divisor = 1.0 + a->osgain * (a->max_env - 1.0);
 			else                  divisor = 1.0;
 			a->outbuff[2 * i + 0] = a->dl[2 * a->out_idx + 0] / divisor;				// output sample
@@ -47,6 +47,7 @@ typedef struct _osctrl
 	int in_idx;						// input index for dl
 	int out_idx;					// output index for dl
 	double max_env;					// maximum env value in env delay line
+	struct _slmax *smax;			// maximum of the 'pn' values in 'dlenv'
 	double env_out;
 } osctrl, *OSCTRL;
 
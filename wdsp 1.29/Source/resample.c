@@ -32,10 +32,151 @@ warren@wpratt.com
 *																								*
 ************************************************************************************************/
 
+// For power-of-two ratios with the default filter, the conversion may instead be done by a cascade of
+// half-band stages, each changing the rate by two.  Every other coefficient of a half-band filter is zero,
+// and the rest are symmetric about the centre, so an output costs about N / 4 multiplies.  Each stage keeps
+// 0.45 of the final (decimation) or initial (interpolation) rate and is long enough to reach full stopband
+// at the mirror image of that edge.  Unlike the polyphase filter, the last decimation stage (first
+// interpolation stage) is only half-way down at 0.5 of the lower rate, so components between 0.45 and 0.55
+// of that rate alias; the cascade is therefore used only when selected.
+
+static int hb_ncoef (int r)
+{
+	// length of a stage whose higher rate is 'r' times the lower rate of the conversion; the 7-term window
+	// needs about 14 / N of transition
+	double width = 0.5 - 0.9 / (double)r;
+	int k = (int)ceil ((14.0 / width + 1.0) / 4.0);
+	return 4 * k - 1;
+}
+
+static void calc_rsmphb (rsmphb* s, int ncoef, double scale)
+{
+	int m;
+	int c = (ncoef - 1) / 2;
+	double* impulse = fir_bandpass (ncoef, -0.25, +0.25, 1.0, 1, 0, scale);
+	s->ncoef = ncoef;
+	s->nside = (ncoef + 1) / 4;
+	s->center = impulse[c];
+	s->coef = (double *) malloc0 (s->nside * sizeof (double));
+	for (m = 0; m < s->nside; m++)
+		s->coef[m] = impulse[c - 1 - 2 * m];
+	s->ring = (double *) malloc0 (2 * s->ncoef * sizeof (complex));
+	s->idx = 0;
+	s->phase = 0;
+	_aligned_free (impulse);
+}
+
+static void decalc_rsmphb (rsmphb* s)
+{
+	_aligned_free (s->ring);
+	_aligned_free (s->coef);
+}
+
+static void flush_rsmphb (rsmphb* s)
+{
+	memset (s->ring, 0, 2 * s->ncoef * sizeof (complex));
+	s->idx = 0;
+	s->phase = 0;
+}
+
+static int xrsmphb_down (rsmphb* s, int n, double* in, double* out)
+{
+	int i, m;
+	int nout = 0;
+	double I, Q;
+	double *w, *lo, *hi;
+	for (i = 0; i < n; i++)
+	{
+		s->ring[2 * s->idx + 0] = s->ring[2 * (s->idx + s->ncoef) + 0] = in[2 * i + 0];
+		s->ring[2 * s->idx + 1] = s->ring[2 * (s->idx + s->ncoef) + 1] = in[2 * i + 1];
+		if (++s->idx == s->ncoef) s->idx = 0;
+		if ((s->phase ^= 1) == 0)
+		{
+			w = s->ring + 2 * (s->idx + (s->ncoef - 1) / 2);
+			I = s->center * w[0];
+			Q = s->center * w[1];
+			for (m = 0; m < s->nside; m++)
+			{
+				lo = w - 2 * (2 * m + 1);
+				hi = w + 2 * (2 * m + 1);
+				I += s->coef[m] * (lo[0] + hi[0]);
+				Q += s->coef[m] * (lo[1] + hi[1]);
+			}
+			out[2 * nout + 0] = I;
+			out[2 * nout + 1] = Q;
+			nout++;
+		}
+	}
+	return nout;
+}
+
+static int xrsmphb_up (rsmphb* s, int n, double* in, double* out)
+{
+	// the odd outputs see only the centre coefficient; the even outputs, only the side coefficients
+	int i, m;
+	double I, Q;
+	double *w, *lo, *hi;
+	for (i = 0; i < n; i++)
+	{
+		s->ring[2 * s->idx + 0] = s->ring[2 * (s->idx + s->ncoef) + 0] = in[2 * i + 0];
+		s->ring[2 * s->idx + 1] = s->ring[2 * (s->idx + s->ncoef) + 1] = in[2 * i + 1];
+		if (++s->idx == s->ncoef) s->idx = 0;
+		w = s->ring + 2 * (s->idx + s->ncoef - s->nside);
+		I = 0.0;
+		Q = 0.0;
+		for (m = 0; m < s->nside; m++)
+		{
+			lo = w - 2 * (m + 1);
+			hi = w + 2 * m;
+			I += s->coef[m] * (lo[0] + hi[0]);
+			Q += s->coef[m] * (lo[1] + hi[1]);
+		}
+		out[4 * i + 0] = I;
+		out[4 * i + 1] = Q;
+		out[4 * i + 2] = s->center * w[0];
+		out[4 * i + 3] = s->center * w[1];
+	}
+	return 2 * n;
+}
+
+static void size_hbbuff (RESAMPLE a)
+{
+	// the exported calls may change 'size' on any buffer, so the stage outputs grow as needed
+	int need = a->hbup ? a->size << (a->nhb - 1) : a->size / 2 + 1;
+	if (need > a->hbsize)
+	{
+		_aligned_free (a->hbbuff[0]);
+		_aligned_free (a->hbbuff[1]);
+		a->hbbuff[0] = (double *) malloc0 (need * sizeof (complex));
+		a->hbbuff[1] = (double *) malloc0 (need * sizeof (complex));
+		a->hbsize = need;
+	}
+}
+
+static int xhalfband (RESAMPLE a)
+{
+	int i;
+	int n = a->size;
+	double* src = a->in;
+	double* dst;
+	size_hbbuff (a);
+	for (i = 0; i < a->nhb; i++)
+	{
+		dst = (i == a->nhb - 1) ? a->out : a->hbbuff[i & 1];
+		if (a->hbup)
+			n = xrsmphb_up (&a->hb[i], n, src, dst);
+		else
+			n = xrsmphb_down (&a->hb[i], n, src, dst);
+		src = dst;
+	}
+	return n;
+}
+
 void calc_resample (RESAMPLE a)
 {
 	int x, y, z;
 	int i, j, k;
+	int r;
 	int min_rate;
 	double full_rate;
 	double fc_norm_high, fc_norm_low;
@@ -55,6 +196,22 @@ void calc_resample (RESAMPLE a)
 	if (a->in_rate < a->out_rate) min_rate = a->in_rate;
 	else min_rate = a->out_rate;
 	if (a->fc == 0.0) a->fc = 0.45 * (double)min_rate;
+	r = a->L * a->M;
+	if (a->hbrun && a->fcin == 0.0 && a->fc_low < 0.0 && a->ncoefin == 0
+		&& (a->L == 1 || a->M == 1) && r > 1 && (r & (r - 1)) == 0 && r <= 1 << RSMP_MAX_HB)
+	{
+		a->hbup = (a->M == 1);
+		for (a->nhb = 0; 1 << a->nhb < r; a->nhb++);
+		for (i = 0; i < a->nhb; i++)
+			if (a->hbup)
+				calc_rsmphb (&a->hb[i], hb_ncoef (2 << i), i == 0 ? 2.0 * a->gain : 2.0);
+			else
+				calc_rsmphb (&a->hb[i], hb_ncoef (r >> i), i == a->nhb - 1 ? a->gain : 1.0);
+		size_hbbuff (a);
+		a->h = NULL;
+		a->ring = NULL;
+		return;
+	}
 	full_rate = (double)(a->in_rate * a->L);
 	fc_norm_high = a->fc / full_rate;
 	if (a->fc_low < 0.0)
@@ -63,15 +220,14 @@ void calc_resample (RESAMPLE a)
 		fc_norm_low = a->fc_low / full_rate;
 	if (a->ncoef == 0) a->ncoef = (int)(140.0 * full_rate / min_rate);
 	a->ncoef = (a->ncoef / a->L + 1) * a->L;
-	a->cpp = a->ncoef / a->L;
-	a->h = (double *)malloc0(a->ncoef * sizeof(double));
+	a->cpp = (a->ncoef / a->L + 3) & ~3;
+	a->h = (double *)malloc0(a->L * a->cpp * sizeof(complex));
 	impulse = fir_bandpass(a->ncoef, fc_norm_low, fc_norm_high, 1.0, 1, 0, a->gain * (double)a->L);
-	i = 0;
 	for (j = 0; j < a->L; j++)
-		for (k = 0; k < a->ncoef; k += a->L)
-			a->h[i++] = impulse[j + k];
+		for (k = 0, i = 2 * a->cpp * j; k < a->ncoef; k += a->L, i += 2)
+			a->h[i + 0] = a->h[i + 1] = impulse[j + k];
 	a->ringsize = a->cpp;
-	a->ring = (double *)malloc0(a->ringsize * sizeof(complex));
+	a->ring = (double *)malloc0(2 * a->ringsize * sizeof(complex));
 	a->idx_in = a->ringsize - 1;
 	a->phnum = 0;
 	_aligned_free(impulse);
@@ -79,6 +235,14 @@ void calc_resample (RESAMPLE a)
 
 void decalc_resample (RESAMPLE a)
 {
+	int i;
+	for (i = 0; i < a->nhb; i++)
+		decalc_rsmphb (&a->hb[i]);
+	a->nhb = 0;
+	_aligned_free(a->hbbuff[1]);
+	_aligned_free(a->hbbuff[0]);
+	a->hbbuff[0] = a->hbbuff[1] = NULL;
+	a->hbsize = 0;
 	_aligned_free(a->ring);
 	_aligned_free(a->h);
 }
@@ -112,7 +276,14 @@ void destroy_resample (RESAMPLE a)
 PORT
 void flush_resample (RESAMPLE a)
 {
-	memset (a->ring, 0, a->ringsize * sizeof (complex));
+	int i;
+	if (a->nhb)
+	{
+		for (i = 0; i < a->nhb; i++)
+			flush_rsmphb (&a->hb[i]);
+		return;
+	}
+	memset (a->ring, 0, 2 * a->ringsize * sizeof (complex));
 	a->idx_in = a->ringsize - 1;
 	a->phnum = 0;
 }
@@ -121,11 +292,11 @@ PORT
 int xresample (RESAMPLE a)
 {
 	int outsamps = 0;
-	if (a->run)
+	if (a->run && a->nhb)
+		outsamps = xhalfband (a);
+	else if (a->run)
 	{
-		int i, j, n;
-		int idx_out;
-		double I, Q;
+		int i;
 
 		int cpp = a->cpp;
 		int idx_in = a->idx_in;
@@ -135,21 +306,11 @@ int xresample (RESAMPLE a)
 
 		for (i = 0; i < a->size; i++)
 		{
-			ring[2 * idx_in + 0] = a->in[2 * i + 0];
-			ring[2 * idx_in + 1] = a->in[2 * i + 1];
+			ring[2 * idx_in + 0] = ring[2 * (idx_in + ringsize) + 0] = a->in[2 * i + 0];
+			ring[2 * idx_in + 1] = ring[2 * (idx_in + ringsize) + 1] = a->in[2 * i + 1];
 			while (a->phnum < a->L)
 			{
-				I = 0.0;
-				Q = 0.0;
-				n = cpp * a->phnum;
-				for (j = 0; j < cpp; j++)
-				{
-					if ((idx_out = idx_in + j) >= ringsize) idx_out -= ringsize;
-					I += h[n + j] * ring[2 * idx_out + 0];
-					Q += h[n + j] * ring[2 * idx_out + 1];
-				}
-				a->out[2 * outsamps + 0] = I;
-				a->out[2 * outsamps + 1] = Q;
+				cdotr (cpp, a->out + 2 * outsamps, ring + 2 * idx_in, h + 2 * cpp * a->phnum);
 				outsamps++;
 				a->phnum += a->M;
 			}
@@ -210,6 +371,16 @@ void setBandwidth_resample (RESAMPLE a, double fc_low, double fc_high)
 	}
 }
 
+void setHalfband_resample (RESAMPLE a, int run)
+{
+	if (run != a->hbrun)
+	{
+		decalc_resample (a);
+		a->hbrun = run;
+		calc_resample (a);
+	}
+}
+
 // exported calls
 
 PORT
@@ -279,7 +450,7 @@ RESAMPLEF create_resampleF ( int run, int size, float* in, float* out, int in_ra
 		for (k = 0; k < a->ncoef; k += a->L)
 			a->h[i++] = impulse[j + k];
 	a->ringsize = a->cpp;
-	a->ring = (double *) malloc0 (a->ringsize * sizeof (double));
+	a->ring = (double *) malloc0 (2 * a->ringsize * sizeof (double));
 	a->idx_in = a->ringsize - 1;
 	a->phnum = 0;
 	_aligned_free (impulse);
@@ -295,7 +466,7 @@ void destroy_resampleF (RESAMPLEF a)
 
 void flush_resampleF (RESAMPLEF a)
 {
-	memset (a->ring, 0, a->ringsize * sizeof (double));
+	memset (a->ring, 0, 2 * a->ringsize * sizeof (double));
 	a->idx_in = a->ringsize - 1;
 	a->phnum = 0;
 }
@@ -305,24 +476,15 @@ int xresampleF (RESAMPLEF a)
 	int outsamps = 0;
 	if (a->run)
 	{
-		int i, j, n;
-		int idx_out;
-		double I;
+		int i;
 
 		for (i = 0; i < a->size; i++)
 		{
-			a->ring[a->idx_in] = (double)a->in[i];
+			a->ring[a->idx_in] = a->ring[a->idx_in + a->ringsize] = (double)a->in[i];
 
 			while (a->phnum < a->L)
 			{
-				I = 0.0;
-				n = a->cpp * a->phnum;
-				for (j = 0; j < a->cpp; j++)
-				{
-					if ((idx_out = a->idx_in + j) >= a->ringsize) idx_out -= a->ringsize;
-					I += a->h[n + j] * a->ring[idx_out];
-				}
-				a->out[outsamps] = (float)I;
+				a->out[outsamps] = (float)vdot (a->cpp, a->h + a->cpp * a->phnum, a->ring + a->idx_in);
 
 				outsamps++;
 				a->phnum += a->M;
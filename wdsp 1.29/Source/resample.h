@@ -33,6 +33,19 @@ warren@wpratt.com
 #ifndef _resample_h
 #define _resample_h
 
+#define RSMP_MAX_HB		5		// half-band stages, i.e., ratios up to 32
+
+typedef struct _rsmphb
+{
+	int ncoef;			// filter length, 4 * k - 1
+	int nside;			// number of distinct non-zero side coefficients, k
+	double center;		// centre coefficient
+	double* coef;		// side coefficients, nearest to the centre first
+	double* ring;		// complex history, stored twice
+	int idx;			// next position in 'ring'
+	int phase;			// decimation phase
+} rsmphb;
+
 typedef struct _resample
 {
 	int run;			// run
@@ -50,11 +63,17 @@ typedef struct _resample
 	int ncoef;			// number of coefficients
 	int L;				// interpolation factor
 	int M;				// decimation factor
-	double* h;			// coefficients
+	double* h;			// coefficients, phase by phase, each stored twice for 'cdotr'
 	int ringsize;		// number of complex pairs the ring buffer holds
-	double* ring;		// ring buffer
-	int cpp;			// coefficients of the phase
+	double* ring;		// ring buffer, stored twice so that each phase reads a contiguous window
+	int cpp;			// coefficients of the phase, zero-padded to a multiple of four
 	int phnum;			// phase number
+	int hbrun;			// use half-band stages for power-of-two ratios with the default filter
+	int nhb;			// number of half-band stages in use, 0 for the polyphase filter
+	int hbup;			// half-band stages interpolate
+	rsmphb hb[RSMP_MAX_HB];
+	int hbsize;			// complex samples each of 'hbbuff' holds
+	double* hbbuff[2];	// outputs of the intermediate stages
 } resample, *RESAMPLE;
 
 __declspec (dllexport)
@@ -81,6 +100,8 @@ extern void setFCLow_resample (RESAMPLE a, double fc_low);
 
 extern void setBandwidth_resample (RESAMPLE a, double fc_low, double fc_high);
 
+extern void setHalfband_resample (RESAMPLE a, int run);
+
 #endif
 
 /************************************************************************************************
@@ -102,9 +123,9 @@ typedef struct _resampleF
 	int ncoef;			// number of coefficients
 	int L;				// interpolation factor
 	int M;				// decimation factor
-	double* h;			// coefficients
+	double* h;			// coefficients, phase by phase
 	int ringsize;		// number of values the ring buffer holds
-	double* ring;		// ring buffer
+	double* ring;		// ring buffer, stored twice so that each phase reads a contiguous window
 	int cpp;			// coefficients of the phase
 	int phnum;			// phase number
 } resampleF, *RESAMPLEF;
@@ -28,9 +28,8 @@ warren@wpratt.com
 
 void calc_shift (SHIFT a)
 {
-	a->delta = TWOPI * a->shift / a->rate;
-	a->cos_delta = cos (a->delta);
-	a->sin_delta = sin (a->delta);
+	// the phase is kept so that a frequency change does not make a step
+	setDelta_nco (&a->osc, TWOPI * a->shift / a->rate);
 }
 
 SHIFT create_shift (int run, int size, double* in, double* out, int rate, double fshift)
@@ -42,19 +41,21 @@ SHIFT create_shift (int run, int size, double* in, double* out, int rate, double
 	a->out = out;
 	a->rate = (double)rate;
 	a->shift = fshift;
-	a->phase = 0.0;
+	a->cs = (double *) malloc0 (a->size * sizeof (complex));
+	init_nco (&a->osc, 0.0);
 	calc_shift (a);
 	return a;
 }
 
 void destroy_shift (SHIFT a)
 {
+	_aligned_free (a->cs);
 	_aligned_free (a);
 }
 
 void flush_shift (SHIFT a)
 {
-	a->phase = 0.0;
+	flush_nco (&a->osc);
 }
 
 void xshift (SHIFT a)
@@ -62,22 +63,16 @@ void xshift (SHIFT a)
 	if (a->run)
 	{
 		int i;
-		double I1, Q1, t1, t2;
-		double cos_phase = cos (a->phase);
-		double sin_phase = sin (a->phase);
+		double I1, Q1, cos_phase, sin_phase;
+		xncob (&a->osc, a->size, a->cs);
 		for (i = 0; i < a->size; i++)
 		{
 			I1 = a->in[2 * i + 0];
 			Q1 = a->in[2 * i + 1];
+			cos_phase = a->cs[2 * i + 0];
+			sin_phase = a->cs[2 * i + 1];
 			a->out[2 * i + 0] = I1 * cos_phase - Q1 * sin_phase;
 			a->out[2 * i + 1] = I1 * sin_phase + Q1 * cos_phase;
-			t1 = cos_phase;
-			t2 = sin_phase;
-			cos_phase = t1 * a->cos_delta - t2 * a->sin_delta;
-			sin_phase = t1 * a->sin_delta + t2 * a->cos_delta;
-			a->phase += a->delta;
-			if (a->phase >= TWOPI) a->phase -= TWOPI;
-			if (a->phase <   0.0 ) a->phase += TWOPI;
 		}
 	}
 	else if (a->in != a->out)
@@ -93,13 +88,15 @@ void setBuffers_shift(SHIFT a, double* in, double* out)
 void setSamplerate_shift (SHIFT a, int rate)
 {
 	a->rate = rate;
-	a->phase = 0.0;
+	flush_nco (&a->osc);
 	calc_shift(a);
 }
 
 void setSize_shift (SHIFT a, int size)
 {
 	a->size = size;
+	_aligned_free (a->cs);
+	a->cs = (double *) malloc0 (a->size * sizeof (complex));
 	flush_shift (a);
 }
 
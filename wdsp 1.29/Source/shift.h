@@ -26,6 +26,7 @@ warren@wpratt.com
 
 #ifndef _shift_h
 #define _shift_h
+#include "nco.h"
 
 typedef struct _shift
 {
@@ -35,10 +36,8 @@ typedef struct _shift
 	double* out;
 	double rate;
 	double shift;
-	double phase;
-	double delta;
-	double cos_delta;
-	double sin_delta;
+	nco osc;
+	double* cs;							// oscillator output for one buffer
 } shift, *SHIFT;
 
 extern SHIFT create_shift (int run, int size, double* in, double* out, int rate, double fshift);
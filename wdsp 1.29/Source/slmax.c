@@ -0,0 +1,88 @@
+/*  slmax.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+#include "comm.h"
+
+/********************************************************************************************************
+*																										*
+*										Sliding-Window Maximum											*
+*																										*
+********************************************************************************************************/
+
+SLMAX create_slmax (int max_win, int win)
+{
+	SLMAX a = (SLMAX) malloc0 (sizeof (slmax));
+	a->size = max_win;
+	a->win = win;
+	a->blk = (double *) malloc0 (a->size * sizeof (double));
+	a->suf = (double *) malloc0 ((a->size + 1) * sizeof (double));
+	flush_slmax (a);
+	return a;
+}
+
+void destroy_slmax (SLMAX a)
+{
+	_aligned_free (a->suf);
+	_aligned_free (a->blk);
+	_aligned_free (a);
+}
+
+void flush_slmax (SLMAX a)
+{
+	memset (a->suf, 0, (a->size + 1) * sizeof (double));
+	a->m = 0;
+	a->pre = 0.0;
+}
+
+double xslmax (SLMAX a, double x)
+{
+	// push 'x' and return the maximum of the window ending with it
+	int j;
+	double max, s;
+	if (a->win <= 0) return 0.0;
+	a->blk[a->m++] = x;
+	if (x > a->pre) a->pre = x;
+	max = a->suf[a->m] > a->pre ? a->suf[a->m] : a->pre;
+	if (a->m == a->win)
+	{
+		a->suf[a->win] = s = 0.0;
+		for (j = a->win - 1; j >= 0; j--)
+		{
+			if (a->blk[j] > s) s = a->blk[j];
+			a->suf[j] = s;
+		}
+		a->m = 0;
+		a->pre = 0.0;
+	}
+	return max;
+}
+
+void setWindow_slmax (SLMAX a, int win)
+{
+	// the caller refills the window with its current contents
+	a->win = win;
+	flush_slmax (a);
+}
@@ -0,0 +1,64 @@
+/*  slmax.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+/********************************************************************************************************
+*																										*
+*										Sliding-Window Maximum											*
+*																										*
+********************************************************************************************************/
+
+// Maximum of the last 'win' values pushed, in O(1) per value (van Herk / Gil-Werman).  The stream is cut
+// into blocks of 'win' values.  The window ending at the m-th value of the current block is the first m
+// values of that block plus the last 'win' - m values of the previous one, so its maximum is the larger of
+// the running maximum of the current block and a suffix maximum of the previous block, which are computed
+// when that block completes.  The result is the same value a scan of the window would find.  Values must
+// be non-negative; the values before the first push, or after a flush, read as 0.0.
+
+#ifndef _slmax_h
+#define _slmax_h
+#include "comm.h"
+
+typedef struct _slmax
+{
+	int size;						// longest window, values
+	int win;						// window length, values
+	double* blk;					// values of the current block
+	double* suf;					// suffix maxima of the previous block, 'win' + 1 with suf[win] = 0.0
+	int m;							// number of values in the current block
+	double pre;						// maximum of the current block
+} slmax, *SLMAX;
+
+extern SLMAX create_slmax (int max_win, int win);
+
+extern void destroy_slmax (SLMAX a);
+
+extern void flush_slmax (SLMAX a);
+
+extern double xslmax (SLMAX a, double x);
+
+extern void setWindow_slmax (SLMAX a, int win);
+
+#endif
@@ -727,12 +727,13 @@ void calc_bpsnba (BPSNBA a)
 		a->gain,					// gain
 		a->autoincr,				// auto-increase notch width if below min
 		a->maxpb,					// max number of passbands
-		a->ptraddr);				// addr of database pointer
+		a->ptraddr,					// addr of database pointer
+		a->precision);				// kernel precision
 }
 
 BPSNBA create_bpsnba (int run, int run_notches, int position, int size, int nc, int mp, double* in, double* out, int rate,  
 	double abs_low_freq, double abs_high_freq, double f_low, double f_high, int wintype, double gain, int autoincr, 
-	int maxpb, NOTCHDB* ptraddr)
+	int maxpb, NOTCHDB* ptraddr, int precision)
 {
 	BPSNBA a = (BPSNBA) malloc0 (sizeof (bpsnba));
 	a->run = run;
@@ -741,6 +742,7 @@ BPSNBA create_bpsnba (int run, int run_notches, int position, int size, int nc,
 	a->size = size;
 	a->nc = nc;
 	a->mp = mp;
+	a->precision = precision;
 	a->in = in;
 	a->out = out;
 	a->rate = rate;
@@ -129,6 +129,7 @@ typedef struct _bpsnba
 		int size;						// buffer size
 		int nc;							// number of filter coefficients
 		int mp;							// minimum phase flag
+		int precision;					// 0 for double, 1 for single-precision filter kernel
 		double* in;						// input buffer
 		double* out;					// output buffer
 		int rate;						// sample rate
@@ -151,7 +152,7 @@ extern void decalc_bpsnba (BPSNBA a);
 
 extern BPSNBA create_bpsnba (int run, int run_notches, int position, int size, int nc, int mp, double* in, double* out, int rate,  
 	double abs_low_freq, double abs_high_freq, double f_low, double f_high, int wintype, double gain, int autoincr, 
-	int maxpb, NOTCHDB* ptraddr);
+	int maxpb, NOTCHDB* ptraddr, int precision);
 
 extern void destroy_bpsnba (BPSNBA a);
 
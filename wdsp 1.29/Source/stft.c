@@ -0,0 +1,193 @@
+/*  stft.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+#include "comm.h"
+
+/********************************************************************************************************
+*																										*
+*								Windowed STFT Analysis / Synthesis Engine								*
+*																										*
+********************************************************************************************************/
+
+STFT create_stft (int bsize, int fsize, int ovrlp)
+{
+	STFT a = (STFT) malloc0 (sizeof (stft));
+	a->bsize = bsize;
+	a->fsize = fsize;
+	a->ovrlp = ovrlp;
+	a->incr = a->fsize / a->ovrlp;
+	a->msize = a->fsize / 2 + 1;
+	if (a->fsize > a->bsize)
+		a->iasize = a->fsize;
+	else
+		a->iasize = a->bsize + a->fsize - a->incr;
+	a->sasize = a->ovrlp * a->incr;
+	if (a->fsize > a->bsize)
+	{
+		if (a->bsize > a->incr)  a->oasize = a->bsize;
+		else					 a->oasize = a->incr;
+		a->init_oainidx = (a->fsize - a->bsize - a->incr) % a->oasize;
+	}
+	else
+	{
+		a->oasize = a->bsize;
+		a->init_oainidx = a->fsize - a->incr;
+	}
+	a->awin      = (double *) malloc0 (a->fsize      * sizeof (double));
+	a->swin      = (double *) malloc0 (a->fsize      * sizeof (double));
+	a->inaccum   = (double *) malloc0 (2 * a->iasize * sizeof (double));
+	a->saccum    = (double *) malloc0 (a->sasize     * sizeof (double));
+	a->outaccum  = (double *) malloc0 (a->oasize     * sizeof (double));
+	a->forfftin  = (double *) malloc0 (a->fsize      * sizeof (double));
+	a->forfftout = (double *) malloc0 (a->msize      * sizeof (complex));
+	a->revfftin  = (double *) malloc0 (a->msize      * sizeof (complex));
+	a->revfftout = (double *) malloc0 (a->fsize      * sizeof (double));
+	enter_fftplanner ();
+	a->Rfor = fftw_plan_dft_r2c_1d (a->fsize, a->forfftin, (fftw_complex *)a->forfftout, FFTW_ESTIMATE);
+	a->Rrev = fftw_plan_dft_c2r_1d (a->fsize, (fftw_complex *)a->revfftin, a->revfftout, FFTW_ESTIMATE);
+	leave_fftplanner ();
+	flush_stft (a);
+	return a;
+}
+
+void destroy_stft (STFT a)
+{
+	enter_fftplanner ();
+	fftw_destroy_plan (a->Rrev);
+	fftw_destroy_plan (a->Rfor);
+	leave_fftplanner ();
+	_aligned_free (a->revfftout);
+	_aligned_free (a->revfftin);
+	_aligned_free (a->forfftout);
+	_aligned_free (a->forfftin);
+	_aligned_free (a->outaccum);
+	_aligned_free (a->saccum);
+	_aligned_free (a->inaccum);
+	_aligned_free (a->swin);
+	_aligned_free (a->awin);
+	_aligned_free (a);
+}
+
+void flush_stft (STFT a)
+{
+	memset (a->inaccum,  0, 2 * a->iasize * sizeof (double));
+	memset (a->saccum,   0, a->sasize     * sizeof (double));
+	memset (a->outaccum, 0, a->oasize     * sizeof (double));
+	a->nsamps   = 0;
+	a->iainidx  = 0;
+	a->iaoutidx = 0;
+	a->saidx    = 0;
+	a->oainidx  = a->init_oainidx;
+	a->oaoutidx = 0;
+}
+
+void setWindow_stft (STFT a, double* window, double again, double sgain)
+{
+	// frames are multiplied by 'again * window' before the forward fft and by 'sgain * window' after the
+	// inverse fft; call before the first frame and whenever the window changes
+	int i;
+	for (i = 0; i < a->fsize; i++)
+	{
+		a->awin[i] = again * window[i];
+		a->swin[i] = sgain * window[i];
+	}
+}
+
+void xstft_in (STFT a, double* in)
+{
+	// takes the real parts of 'bsize' complex samples; bsize <= iasize, so the ring wraps at most once
+	int i, n;
+	double* r = a->inaccum + a->iainidx;
+	double* m = r + a->iasize;
+	n = min (a->bsize, a->iasize - a->iainidx);
+	for (i = 0; i < n; i++)
+		r[i] = m[i] = in[2 * i];
+	r = a->inaccum - n;
+	m = r + a->iasize;
+	for (; i < a->bsize; i++)
+		r[i] = m[i] = in[2 * i];
+	if ((a->iainidx += a->bsize) >= a->iasize) a->iainidx -= a->iasize;
+	a->nsamps += a->bsize;
+}
+
+int xstft_frame (STFT a)
+{
+	// if a full frame is buffered, windows it, leaves its spectrum in 'forfftout', and returns 1
+	int i;
+	double* x;
+	if (a->nsamps < a->fsize) return 0;
+	x = a->inaccum + a->iaoutidx;
+	for (i = 0; i < a->fsize; i++)
+		a->forfftin[i] = a->awin[i] * x[i];
+	if ((a->iaoutidx += a->incr) >= a->iasize) a->iaoutidx -= a->iasize;
+	a->nsamps -= a->incr;
+	fftw_execute (a->Rfor);
+	return 1;
+}
+
+void xstft_ola (STFT a)
+{
+	// synthesizes 'revfftin', adds it to the accumulator, and moves the 'incr' samples it completes to the
+	// output ring
+	int i, n;
+	double* s = a->saccum + a->saidx;
+	double* o;
+	fftw_execute (a->Rrev);
+	n = a->sasize - a->saidx;
+	for (i = 0; i < n; i++)
+		s[i] += a->swin[i] * a->revfftout[i];
+	s = a->saccum - n;
+	for (; i < a->sasize; i++)
+		s[i] += a->swin[i] * a->revfftout[i];
+	s = a->saccum + a->saidx;
+	o = a->outaccum + a->oainidx;
+	n = min (a->incr, a->oasize - a->oainidx);
+	memcpy (o, s, n * sizeof (double));
+	memcpy (a->outaccum, s + n, (a->incr - n) * sizeof (double));
+	memset (s, 0, a->incr * sizeof (double));
+	if ((a->saidx += a->incr) >= a->sasize) a->saidx = 0;
+	if ((a->oainidx += a->incr) >= a->oasize) a->oainidx -= a->oasize;
+}
+
+void xstft_out (STFT a, double* out)
+{
+	// writes 'bsize' complex samples with zero imaginary parts; bsize <= oasize
+	int i, n;
+	double* o = a->outaccum + a->oaoutidx;
+	n = min (a->bsize, a->oasize - a->oaoutidx);
+	for (i = 0; i < n; i++)
+	{
+		out[2 * i + 0] = o[i];
+		out[2 * i + 1] = 0.0;
+	}
+	o = a->outaccum - n;
+	for (; i < a->bsize; i++)
+	{
+		out[2 * i + 0] = o[i];
+		out[2 * i + 1] = 0.0;
+	}
+	if ((a->oaoutidx += a->bsize) >= a->oasize) a->oaoutidx -= a->oasize;
+}
@@ -0,0 +1,97 @@
+/*  stft.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+/********************************************************************************************************
+*																										*
+*								Windowed STFT Analysis / Synthesis Engine								*
+*																										*
+********************************************************************************************************/
+
+// Common framing for spectral processors (EMNR, CFCOMP):  real input samples are buffered, every 'incr' =
+// fsize / ovrlp samples a windowed frame is transformed into 'forfftout', the processor fills 'revfftin',
+// and the inverse transform is windowed and overlap-added into one running accumulator.  The input ring is
+// stored twice so that each frame is contiguous, and no per-sample index arithmetic is done.  Timing (the
+// overall delay) is that of the original per-module code.  A processor calls:
+//
+//		xstft_in (a, in);
+//		while (xstft_frame (a))
+//		{
+//			... forfftout -> revfftin ...
+//			xstft_ola (a);
+//		}
+//		xstft_out (a, out);
+
+#ifndef _stft_h
+#define _stft_h
+#include "comm.h"
+
+typedef struct _stft
+{
+	int bsize;						// complex samples per call
+	int fsize;						// frame and fft size
+	int ovrlp;						// number of frames overlapping each output sample
+	int incr;						// hop, fsize / ovrlp
+	int msize;						// number of bins, fsize / 2 + 1
+	double* awin;					// analysis window, including the analysis gain
+	double* swin;					// synthesis window, including the synthesis gain
+	int iasize;						// input ring size
+	double* inaccum;				// input ring, stored twice
+	int iainidx;					// next input write position
+	int iaoutidx;					// start of the next frame
+	int nsamps;						// buffered input samples
+	int sasize;						// synthesis accumulator size, ovrlp * incr
+	double* saccum;					// overlap-add accumulator
+	int saidx;						// start of the next frame in 'saccum'
+	int oasize;						// output ring size
+	double* outaccum;				// output ring
+	int init_oainidx;
+	int oainidx;					// next output write position
+	int oaoutidx;					// next output read position
+	double* forfftin;
+	double* forfftout;				// complex spectrum of the current frame, msize bins
+	double* revfftin;				// complex spectrum to synthesize, msize bins
+	double* revfftout;
+	fftw_plan Rfor;
+	fftw_plan Rrev;
+} stft, *STFT;
+
+extern STFT create_stft (int bsize, int fsize, int ovrlp);
+
+extern void destroy_stft (STFT a);
+
+extern void flush_stft (STFT a);
+
+extern void setWindow_stft (STFT a, double* window, double again, double sgain);
+
+extern void xstft_in (STFT a, double* in);
+
+extern int xstft_frame (STFT a);
+
+extern void xstft_ola (STFT a);
+
+extern void xstft_out (STFT a, double* out);
+
+#endif
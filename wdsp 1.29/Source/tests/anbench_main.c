@@ -0,0 +1,215 @@
+/*  anbench_main.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at
+
+warren@wpratt.com
+
+*/
+
+#include "comm.h"
+
+/********************************************************************************************************
+*																										*
+*										Analyzer Benchmark Driver										*
+*																										*
+********************************************************************************************************/
+
+// Command-line front end of RunAnalyzerBenchmark() (see anbench.h).  Exit status:  0 pass, 1 golden
+// mismatch or failed span sweep check, 2 bad arguments or golden file error.
+//
+// --span-sweep compares the zoom front end with a plain full-rate fft at the same output span and
+// resolution, for decimation 8, 64 and 512:  the plain display runs an fft 'decim' times larger and clips
+// it to the span.  The input rate of each pair is chosen for about 20 frames per second.  For each it
+// reports the cpu per frame (analyzer workers plus the input calls, where the zoom runs) and checks the
+// final frame of the zoomed display against the plain one:  the -20 dB tone in the span must land on the
+// same pixel at the same level, and nothing away from it may rise above the plain display's floor, which
+// would be an alias of the out-of-span tones (the 0 dB tone among them).
+
+#define SWEEP_FPS			20.0		// frames per second aimed for in the span sweep
+#define SWEEP_TONE_DB		0.5			// largest tone level difference, dB
+#define SWEEP_ALIAS_DB		10.0		// largest rise of the zoomed display above the plain one away from the tone, dB
+#define SWEEP_GUARD			8			// pixels on each side of the tone excluded from the alias check
+
+static void usage (void)
+{
+	fprintf (stderr,
+		"usage:  anbench [options]\n"
+		"  --displays N      number of displays (1)\n"
+		"  --type N          0 real, 1 complex input (1)\n"
+		"  --size N          fft size (4096)\n"
+		"  --overlap N       samples re-used from the previous fft (size / 2)\n"
+		"  --stitch N        number of sub-spans (1)\n"
+		"  --num-fft N       LO positions per sub-span (1)\n"
+		"  --average N       averaging mode, as SetDisplayAverageMode() (0)\n"
+		"  --pixels N        pixels per frame (1024)\n"
+		"  --buffer N        samples per input call; must divide the fft size (1024)\n"
+		"  --rate R          input sample rate of each stream, 0 as fast as possible (192000)\n"
+		"  --seconds S       duration of the timed run, 0 to skip it (0); it follows an untimed 1 s run, so that\n"
+		"                    fft plans, batched ones included, are made before timing starts\n"
+		"  --spectrum2       feed with Spectrum2() rather than Spectrum0()\n"
+		"  --golden FILE     golden pixel file; compared unless --write is given\n"
+		"  --write           write the golden file instead of comparing\n"
+		"  --tolerance dB    largest pixel difference that passes (0.01)\n"
+		"  --span D          show only the centre 0.75 * rate / D (1)\n"
+		"  --zoom            narrow the span with the zoom front end rather than by clipping\n"
+		"  --threads N       analyzer worker threads, as SetAnalyzerThreads() (library default)\n"
+		"  --batch N         largest fft batch, as SetAnalyzerBatch(); 1 disables batching (library default)\n"
+		"  --span-sweep      compare zoom and clipping at decimation 8, 64 and 512 ('--size' is the zoomed fft)\n");
+}
+
+static float* read_frame (const char* file, int num_pixels)
+{
+	// pixels of the first display in a golden file
+	FILE* f;
+	int shape[2];
+	float* pix = (float *) malloc (num_pixels * sizeof (float));
+	if ((f = fopen (file, "rb")) == NULL)
+		return pix;
+	if (fseek (f, 8, SEEK_SET) != 0 || fread (shape, sizeof (int), 2, f) != 2 || shape[1] != num_pixels
+		|| (int)fread (pix, sizeof (float), num_pixels, f) != num_pixels)
+		memset (pix, 0, num_pixels * sizeof (float));
+	fclose (f);
+	return pix;
+}
+
+static int span_sweep (int size, int num_pixels, int buff_size, double seconds)
+{
+	static const int decim[3] = { 8, 64, 512 };
+	static const char* tmp = "anbench_sweep.anb";
+	double fps[2], latency[4], cpu[2], feed[2], diff, rate;
+	int i, k, dropped[2], rc, peak[2], fail = 0;
+	float* pix[2];
+	double alias[2];
+	printf ("span sweep:  zoomed fft %d, %d pixels, %.1f s per run\n", size, num_pixels, seconds);
+	printf ("decim   rate Sps  |  plain fft  fps   ms/frame  |  zoom  fps   ms/frame  |  ratio  |"
+		"  tone pixel, dB plain / zoom   |  off-tone max dB plain / zoom\n");
+	for (i = 0; i < 3; i++)
+	{
+		rate = SWEEP_FPS * (double)size * (double)decim[i];
+		for (k = 0; k < 2; k++)
+		{
+			int sz = k ? size : size * decim[i];
+			int j;
+			rc = RunAnalyzerBenchmark (0, 1, 1, sz, 0, 1, 1, 0, num_pixels, buff_size, rate, seconds, 0,
+				decim[i], k, tmp, ANB_GOLDEN_WRITE, 0.0, &fps[k], latency, &cpu[k], &feed[k], &dropped[k], &diff);
+			if (rc != ANB_OK)
+			{
+				fprintf (stderr, "anbench:  span sweep run failed (%d)\n", rc);
+				remove (tmp);
+				return 2;
+			}
+			pix[k] = read_frame (tmp, num_pixels);
+			peak[k] = 0;
+			for (j = 1; j < num_pixels; j++)
+				if (pix[k][j] > pix[k][peak[k]])
+					peak[k] = j;
+			alias[k] = -1000.0;
+			for (j = 0; j < num_pixels; j++)
+				if (abs (j - peak[k]) > SWEEP_GUARD && pix[k][j] > alias[k])
+					alias[k] = pix[k][j];
+		}
+		remove (tmp);
+		if (abs (peak[0] - peak[1]) > 1 || fabs (pix[0][peak[0]] - pix[1][peak[1]]) > SWEEP_TONE_DB
+			|| alias[1] > alias[0] + SWEEP_ALIAS_DB)
+			fail = 1;
+		printf ("%5d  %10.0f  |  %9d  %5.1f  %8.3f  |  %4d  %5.1f  %8.3f  |  %5.1f  |  %4d %7.2f / %4d %7.2f  |"
+			"  %7.2f / %7.2f\n", decim[i], rate,
+			size * decim[i], fps[0], fps[0] > 0.0 ? (cpu[0] + feed[0]) * 10.0 / fps[0] : 0.0,
+			size, fps[1], fps[1] > 0.0 ? (cpu[1] + feed[1]) * 10.0 / fps[1] : 0.0,
+			cpu[1] + feed[1] > 0.0 ? (cpu[0] + feed[0]) / (cpu[1] + feed[1]) * fps[1] / fps[0] : 0.0,
+			peak[0], pix[0][peak[0]], peak[1], pix[1][peak[1]], alias[0], alias[1]);
+		free (pix[0]);
+		free (pix[1]);
+	}
+	printf ("span sweep %s\n", fail ? "FAILED" : "pass");
+	return fail;
+}
+
+int main (int argc, char** argv)
+{
+	int ndisp = 1, type = 1, size = 4096, overlap = -1, num_stitch = 1, num_fft = 1, av_mode = 0;
+	int num_pixels = 1024, buff_size = 1024, use_spectrum2 = 0, golden_mode = ANB_GOLDEN_NONE, write = 0;
+	int span_decim = 1, use_zoom = 0, sweep = 0, nthreads = 0, batch = 0;
+	double rate = 192000.0, seconds = 0.0, tolerance = 0.01;
+	const char* golden = NULL;
+	double fps, latency[4], cpu, feed_cpu, golden_diff;
+	int dropped, rc, i;
+	for (i = 1; i < argc; i++)
+	{
+		const char* opt = argv[i];
+		const char* val = i + 1 < argc ? argv[i + 1] : NULL;
+		if      (!strcmp (opt, "--spectrum2"))	{ use_spectrum2 = 1; continue; }
+		else if (!strcmp (opt, "--write"))		{ write = 1; continue; }
+		else if (!strcmp (opt, "--zoom"))		{ use_zoom = 1; continue; }
+		else if (!strcmp (opt, "--span-sweep"))	{ sweep = 1; continue; }
+		if (val == NULL)
+		{
+			usage ();
+			return 2;
+		}
+		if      (!strcmp (opt, "--displays"))	ndisp = atoi (val);
+		else if (!strcmp (opt, "--type"))		type = atoi (val);
+		else if (!strcmp (opt, "--size"))		size = atoi (val);
+		else if (!strcmp (opt, "--overlap"))	overlap = atoi (val);
+		else if (!strcmp (opt, "--stitch"))		num_stitch = atoi (val);
+		else if (!strcmp (opt, "--num-fft"))	num_fft = atoi (val);
+		else if (!strcmp (opt, "--average"))	av_mode = atoi (val);
+		else if (!strcmp (opt, "--pixels"))		num_pixels = atoi (val);
+		else if (!strcmp (opt, "--buffer"))		buff_size = atoi (val);
+		else if (!strcmp (opt, "--rate"))		rate = atof (val);
+		else if (!strcmp (opt, "--seconds"))	seconds = atof (val);
+		else if (!strcmp (opt, "--golden"))		golden = val;
+		else if (!strcmp (opt, "--tolerance"))	tolerance = atof (val);
+		else if (!strcmp (opt, "--span"))		span_decim = atoi (val);
+		else if (!strcmp (opt, "--threads"))	nthreads = atoi (val);
+		else if (!strcmp (opt, "--batch"))		batch = atoi (val);
+		else
+		{
+			usage ();
+			return 2;
+		}
+		i++;
+	}
+	if (nthreads > 0) SetAnalyzerThreads (nthreads);
+	if (batch > 0) SetAnalyzerBatch (batch);
+	if (sweep)
+		return span_sweep (size, num_pixels, buff_size, seconds > 0.0 ? seconds : 2.0);
+	if (overlap < 0) overlap = size / 2;
+	if (golden != NULL) golden_mode = write ? ANB_GOLDEN_WRITE : ANB_GOLDEN_COMPARE;
+	if (seconds > 0.0)
+		RunAnalyzerBenchmark (0, ndisp, type, size, overlap, num_stitch, num_fft, av_mode, num_pixels, buff_size,
+			rate, 1.0, use_spectrum2, span_decim, use_zoom, NULL, ANB_GOLDEN_NONE, 0.0, &fps, latency, &cpu,
+			&feed_cpu, &dropped, &golden_diff);
+	rc = RunAnalyzerBenchmark (0, ndisp, type, size, overlap, num_stitch, num_fft, av_mode, num_pixels, buff_size,
+		rate, seconds, use_spectrum2, span_decim, use_zoom, golden, golden_mode, tolerance, &fps, latency, &cpu,
+		&feed_cpu, &dropped, &golden_diff);
+	if (seconds > 0.0 && rc >= 0)
+		printf ("displays %d  size %d  fps/display %.1f  cpu/display %.2f%% (+ input %.2f%%)  fps/core %.0f  "
+			"dropped %d  latency ms p50 %.2f p90 %.2f p99 %.2f max %.2f\n", ndisp, size, fps, cpu, feed_cpu,
+			cpu > 0.0 ? fps * 100.0 / cpu : 0.0, dropped, latency[0], latency[1], latency[2], latency[3]);
+	if (golden_mode != ANB_GOLDEN_NONE)
+		printf ("golden %s  %s  max difference %.4g dB\n", golden,
+			rc == ANB_OK ? (write ? "written" : "pass") : rc == ANB_MISMATCH ? "MISMATCH" : "file error",
+			golden_diff);
+	if (rc == ANB_BAD_ARGS)
+		fprintf (stderr, "anbench:  bad arguments\n");
+	return rc == ANB_OK ? 0 : rc == ANB_MISMATCH ? 1 : 2;
+}
@@ -0,0 +1,104 @@
+/*  fircore_precision.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at
+
+warren@wpratt.com
+
+*/
+
+#include "comm.h"
+
+/********************************************************************************************************
+*																										*
+*										Fircore Precision Test											*
+*																										*
+********************************************************************************************************/
+
+// Runs the same bandpass through a double and a single-precision fircore and checks the difference of
+// the outputs against the bound the single-precision kernel is expected to meet:  an rms error under
+// FPT_MAX_REL_RMS of the rms output, and no sample off by more than FPT_MAX_REL_PEAK of the peak output.
+// The input is a strong tone in the passband, a weaker one in the stopband and low-level noise; in WDSP's
+// (I, Q) sample order the passband of 150 to 2850 Hz is the clockwise rotation.
+
+#define FPT_SIZE			1024
+#define FPT_BLOCKS			64
+#define FPT_RATE			48000
+#define FPT_MAX_REL_RMS		1.0e-6
+#define FPT_MAX_REL_PEAK	2.0e-6
+
+static int run_case (int nc, int mp)
+{
+	BANDPASS bp[2];
+	double *in, *out[2];
+	double err = 0.0, ref = 0.0, maxerr = 0.0, peak = 0.0, rel_rms, rel_peak, d;
+	double ph0 = 0.0, ph1 = 0.0;
+	unsigned int r = 0x1234567;
+	int i, k, n;
+	// fircore's reverse fft writes 2 * size samples to 'out'
+	in = (double *) malloc0 (FPT_SIZE * sizeof (complex));
+	out[0] = (double *) malloc0 (2 * FPT_SIZE * sizeof (complex));
+	out[1] = (double *) malloc0 (2 * FPT_SIZE * sizeof (complex));
+	for (k = 0; k < 2; k++)
+		bp[k] = create_bandpass (1, 0, FPT_SIZE, nc, mp, in, out[k], 150.0, 2850.0, FPT_RATE, 1, 1.0, k);
+	for (n = 0; n < FPT_BLOCKS; n++)
+	{
+		for (i = 0; i < FPT_SIZE; i++)
+		{
+			r = 1664525 * r + 1013904223;
+			in[2 * i + 0] = 0.5 * cos (ph0) + 0.05 * cos (ph1) + 1.0e-4 * ((double)(r >> 8) / 8388608.0 - 1.0);
+			r = 1664525 * r + 1013904223;
+			in[2 * i + 1] = 0.5 * sin (ph0) + 0.05 * sin (ph1) + 1.0e-4 * ((double)(r >> 8) / 8388608.0 - 1.0);
+			ph0 -= TWOPI * 1234.5 / FPT_RATE;
+			ph1 -= TWOPI * 7100.0 / FPT_RATE;
+		}
+		xbandpass (bp[0], 0);
+		xbandpass (bp[1], 0);
+		for (i = 0; i < 2 * FPT_SIZE; i++)
+		{
+			d = fabs (out[1][i] - out[0][i]);
+			err += d * d;
+			ref += out[0][i] * out[0][i];
+			if (d > maxerr) maxerr = d;
+			if (fabs (out[0][i]) > peak) peak = fabs (out[0][i]);
+		}
+	}
+	rel_rms = sqrt (err / ref);
+	rel_peak = maxerr / peak;
+	printf ("nc %5d  mp %d:  rms error %.3g of rms output, largest error %.3g of peak output  %s\n",
+		nc, mp, rel_rms, rel_peak, rel_rms < FPT_MAX_REL_RMS && rel_peak < FPT_MAX_REL_PEAK ? "pass" : "FAIL");
+	for (k = 0; k < 2; k++)
+	{
+		destroy_bandpass (bp[k]);
+		_aligned_free (out[k]);
+	}
+	_aligned_free (in);
+	return rel_rms < FPT_MAX_REL_RMS && rel_peak < FPT_MAX_REL_PEAK;
+}
+
+int main (void)
+{
+	int pass = 1;
+	pass &= run_case (1024, 0);
+	pass &= run_case (4096, 0);
+	pass &= run_case (16384, 0);
+	pass &= run_case (1024, 1);
+	return pass ? 0 : 1;
+}
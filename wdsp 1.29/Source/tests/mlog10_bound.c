@@ -0,0 +1,103 @@
+/*  mlog10_bound.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at
+
+warren@wpratt.com
+
+*/
+
+#include "comm.h"
+
+/********************************************************************************************************
+*																										*
+*											mlog10 Bound Test											*
+*																										*
+********************************************************************************************************/
+
+// Checks the bound vmath.h gives for vdb, -1e-12 <= 10 * log10(v) - db < 10 * log10 (1 + 2^-11) dB with
+// v = g * x * k + 1e-60, over MLB_SAMPLES values at every SIMD level the cpu supports, and that each level's
+// output is bit-identical to the scalar one.  The values are log-uniform over 1e-30 to 1e30, with the first of each block of 4096
+// replaced by a mantissa at a table boundary (or one ulp below it), where the truncation error is smallest
+// and largest.
+
+#define MLB_SAMPLES		2000000
+#define MLB_MIN_DB		-1.0e-12	// rounding of mlog10_conv and the table
+
+int main (void)
+{
+	static const char* name[4] = { "scalar", "sse2", "avx", "avx512" };
+	double *g, *x, *db, *db0;
+	double d, ref, lo, hi, max_db = 10.0 * log10 (1.0 + 1.0 / 2048.0);
+	unsigned int r = 0x2468ace;
+	int i, level, max_level, pass = 1, same;
+	g   = (double *) malloc0 (MLB_SAMPLES * sizeof (double));
+	x   = (double *) malloc0 (MLB_SAMPLES * sizeof (double));
+	db  = (double *) malloc0 (MLB_SAMPLES * sizeof (double));
+	db0 = (double *) malloc0 (MLB_SAMPLES * sizeof (double));
+	for (i = 0; i < MLB_SAMPLES; i++)
+	{
+		r = 1664525 * r + 1013904223;
+		g[i] = pow (10.0, -30.0 + 60.0 * (double)r / 4294967296.0);
+		if ((i & 4095) == 0)
+		{	// mantissa 1 + m / 2048, or the double just below 1 + (m + 1) / 2048
+			int m = (i >> 12) & 2047;
+			g[i] = ldexp (1.0 + m / 2048.0, (i >> 12) % 160 - 80);
+			if (i & 8192) g[i] = nextafter (ldexp (1.0 + (m + 1) / 2048.0, (i >> 12) % 160 - 80), 0.0);
+		}
+		x[i] = 1.0;
+	}
+	SetSIMDLevel (-1);
+	max_level = GetSIMDLevel ();
+	for (level = 0; level <= 3; level++)
+	{
+		if (level > max_level)
+		{
+			printf ("%-7s not supported by this cpu, skipped\n", name[level]);
+			continue;
+		}
+		SetSIMDLevel (level);
+		vdb (MLB_SAMPLES, db, g, x, 1.0);
+		lo = 1.0e30;
+		hi = -1.0e30;
+		same = 1;
+		for (i = 0; i < MLB_SAMPLES; i++)
+		{
+			ref = 10.0 * log10 (g[i] * x[i] * 1.0 + 1.0e-60);
+			d = ref - db[i];
+			if (d < lo) lo = d;
+			if (d > hi) hi = d;
+			if (level == 0)
+				db0[i] = db[i];
+			else if (db[i] != db0[i])
+				same = 0;
+		}
+		printf ("%-7s 10 * log10 - 10 * mlog10:  min %.3g dB  max %.6f dB (bound %.6f)  %s  %s\n", name[level], lo, hi, max_db,
+			level ? (same ? "bit-identical to scalar" : "DIFFERS from scalar") : "",
+			lo >= MLB_MIN_DB && hi < max_db && same ? "pass" : "FAIL");
+		if (lo < MLB_MIN_DB || hi >= max_db || !same) pass = 0;
+	}
+	SetSIMDLevel (-1);
+	_aligned_free (db0);
+	_aligned_free (db);
+	_aligned_free (x);
+	_aligned_free (g);
+	return pass ? 0 : 1;
+}
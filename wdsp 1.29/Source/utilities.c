@@ -509,9 +509,13 @@ double* model_bandpass(int nc, double f_low, double f_high, double rate, int wty
 	double* in = (double*)malloc0(points * sizeof(complex));
 	double* out = (double*)malloc0(points * sizeof(complex));
 	memcpy(in, h, nc * sizeof(complex));
+	enter_fftplanner ();
 	fftw_plan p = fftw_plan_dft_1d(points, (fftw_complex*)in, (fftw_complex*)out, FFTW_FORWARD, FFTW_PATIENT);
+	leave_fftplanner ();
 	fftw_execute(p);
+	enter_fftplanner ();
 	fftw_destroy_plan(p);
+	leave_fftplanner ();
 	double* mag = (double*)malloc0(points * sizeof(double));
 	double mult = 1.0/sqrt(out[0] * out[0] + out[1] * out[1]);
 	for (int i = 0; i < points; i++)
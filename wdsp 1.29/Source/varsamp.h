@@ -41,9 +41,10 @@ typedef struct _varsamp
 	double gain;
 	int idx_in;
 	int ncoef;
-	double* h;
+	double* h;			// coefficient bank, R + 1 fractional-delay phases of 'hsize' coefficients each
 	int rsize;
-	double* ring;
+	int hsize;			// coefficients per phase, 'rsize' zero-padded to a multiple of four
+	double* ring;		// I history then Q history, each 'hsize' long and stored twice
 	double var;
 	int varmode;
 	double cvar;
@@ -51,7 +52,6 @@ typedef struct _varsamp
 	double old_inv_cvar;
 	double dicvar;
 	double delta;
-	double* hs;
 	int R;
 	double h_offset;
 	double isamps;
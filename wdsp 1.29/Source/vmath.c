@@ -0,0 +1,1194 @@
+/*  vmath.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at
+
+warren@wpratt.com
+
+*/
+
+#include "comm.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VM_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VM_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#define VM_TARGET(x)
+#else
+#define VM_TARGET(x)	__attribute__((target(x)))
+#endif
+
+// GCC contracts a multiply and an add into an FMA in functions targeted at FMA-capable levels, which
+// would break the bit-identical results promised in vmath.h
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+/********************************************************************************************************
+*																										*
+*											Scalar Kernels												*
+*																										*
+********************************************************************************************************/
+
+static void cmacc_c (int n, double* acc, double* x, double* m)
+{
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		acc[2 * i + 0] += x[2 * i + 0] * m[2 * i + 0] - x[2 * i + 1] * m[2 * i + 1];
+		acc[2 * i + 1] += x[2 * i + 0] * m[2 * i + 1] + x[2 * i + 1] * m[2 * i + 0];
+	}
+}
+
+static void cmaccf_c (int n, float* acc, float* x, float* m)
+{
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		acc[2 * i + 0] += x[2 * i + 0] * m[2 * i + 0] - x[2 * i + 1] * m[2 * i + 1];
+		acc[2 * i + 1] += x[2 * i + 0] * m[2 * i + 1] + x[2 * i + 1] * m[2 * i + 0];
+	}
+}
+
+// |x|^2 min-hold:  res[k] = |x[k]|^2 if 'init', else the smaller of res[k] and |x[k]|^2.
+// With 'rev', the complex values are read backwards starting at x, i.e., res[k] uses x[-k].
+static void cmagmin_c (int n, double* res, double* x, int rev, int init)
+{
+	int k;
+	int step = rev ? -2 : 2;
+	double mag;
+	for (k = 0; k < n; k++, x += step)
+	{
+		mag = x[0] * x[0] + x[1] * x[1];
+		if (init || mag < res[k])
+			res[k] = mag;
+	}
+}
+
+static double vmax_c (int n, double* x)
+{
+	int i;
+	double m = -1.0e300;
+	for (i = 0; i < n; i++)
+		if (x[i] > m) m = x[i];
+	return m;
+}
+
+// Sums are accumulated in four lanes, lane j taking x[4 * b + j], and combined as (s0 + s2) + (s1 + s3);
+// the remaining n % 4 values are then added in order.  Every level uses this order, so sums are
+// bit-identical across levels, although not to a plain sequential sum.
+static double vsum_c (int n, double* x)
+{
+	int i;
+	double s[4] = { 0.0, 0.0, 0.0, 0.0 };
+	double sum;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		s[0] += x[i + 0];
+		s[1] += x[i + 1];
+		s[2] += x[i + 2];
+		s[3] += x[i + 3];
+	}
+	sum = (s[0] + s[2]) + (s[1] + s[3]);
+	for (; i < n; i++)
+		sum += x[i];
+	return sum;
+}
+
+static double vsumsq_c (int n, double* x)
+{
+	int i;
+	double s[4] = { 0.0, 0.0, 0.0, 0.0 };
+	double sum;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		s[0] += x[i + 0] * x[i + 0];
+		s[1] += x[i + 1] * x[i + 1];
+		s[2] += x[i + 2] * x[i + 2];
+		s[3] += x[i + 3] * x[i + 3];
+	}
+	sum = (s[0] + s[2]) + (s[1] + s[3]);
+	for (; i < n; i++)
+		sum += x[i] * x[i];
+	return sum;
+}
+
+static double vdot_c (int n, double* x, double* y)
+{
+	int i;
+	double s[4] = { 0.0, 0.0, 0.0, 0.0 };
+	double sum;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		s[0] += x[i + 0] * y[i + 0];
+		s[1] += x[i + 1] * y[i + 1];
+		s[2] += x[i + 2] * y[i + 2];
+		s[3] += x[i + 3] * y[i + 3];
+	}
+	sum = (s[0] + s[2]) + (s[1] + s[3]);
+	for (; i < n; i++)
+		sum += x[i] * y[i];
+	return sum;
+}
+
+static void cdotr_c (int n, double* res, double* x, double* hh)
+{
+	int i, j;
+	double s[8] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+	for (i = 0; i + 4 <= n; i += 4)
+		for (j = 0; j < 8; j++)
+			s[j] += x[2 * i + j] * hh[2 * i + j];
+	res[0] = (s[0] + s[4]) + (s[2] + s[6]);
+	res[1] = (s[1] + s[5]) + (s[3] + s[7]);
+	for (; i < n; i++)
+	{
+		res[0] += x[2 * i + 0] * hh[2 * i + 0];
+		res[1] += x[2 * i + 1] * hh[2 * i + 1];
+	}
+}
+
+static void vaxpby_c (int n, double* y, double a, double b, double* x)
+{
+	int i;
+	for (i = 0; i < n; i++)
+		y[i] = a * y[i] + b * x[i];
+}
+
+// db[i] = 10 * mlog10 (g[i] * x[i] * k + 1.0e-60), the same operations as the scalar expression
+static void vdb_c (int n, double* db, double* g, double* x, double k)
+{
+	int i;
+	for (i = 0; i < n; i++)
+		db[i] = 10.0 * mlog10 (g[i] * x[i] * k + 1.0e-60);
+}
+
+// exp(x):  x = n * ln2 + r with |r| <= ln2 / 2, exp(r) from its degree-12 Taylor polynomial (truncation
+// below 2e-16) and 2^n built in the exponent field.  n is rounded by adding 1.5 * 2^52, which leaves it in
+// the low bits of the sum; the bits are then moved to the exponent with 64-bit integer operations.
+#define VX_HI		709.0
+#define VX_LO		-708.0
+#define VX_MAGIC	6755399441055744.0			// 1.5 * 2^52
+
+static const double vx_log2e = 1.4426950408889634074;
+static const double vx_ln2hi = 6.93147180369123816490e-01;	// ln2 to 32 bits, so that n * vx_ln2hi is exact
+static const double vx_ln2lo = 1.90821492927058770002e-10;
+static const double vx_c[13] =
+{
+	1.0,						1.0,						1.0 / 2.0,
+	1.0 / 6.0,					1.0 / 24.0,					1.0 / 120.0,
+	1.0 / 720.0,				1.0 / 5040.0,				1.0 / 40320.0,
+	1.0 / 362880.0,				1.0 / 3628800.0,			1.0 / 39916800.0,
+	1.0 / 479001600.0
+};
+
+static void vexp_c (int n, double* y, double* x)
+{
+	int i, j;
+	double v, t, r, p;
+	uint64_t b;
+	for (i = 0; i < n; i++)
+	{
+		v = x[i];
+		v = VX_HI < v ? VX_HI : v;				// NaN passes through both clamps
+		v = VX_LO > v ? VX_LO : v;
+		t = v * vx_log2e + VX_MAGIC;
+		memcpy (&b, &t, sizeof (b));
+		t -= VX_MAGIC;
+		r = (v - t * vx_ln2hi) - t * vx_ln2lo;
+		p = vx_c[12];
+		for (j = 11; j >= 0; j--)
+			p = p * r + vx_c[j];
+		b = (b + 1023) << 52;
+		memcpy (&t, &b, sizeof (t));
+		y[i] = p * t;
+	}
+}
+
+/********************************************************************************************************
+*																										*
+*											x86 Kernels													*
+*																										*
+********************************************************************************************************/
+
+// Each complex product is formed as {xr*mr - xi*mi, xi*mr + xr*mi}:  the swapped-operand product has
+// its sign flipped in the real lane (or addsub is used), which is exact, so the sums match cmacc_c().
+
+#if defined(VM_X86)
+
+VM_TARGET("sse2")
+static void cmacc_sse2 (int n, double* acc, double* x, double* m)
+{
+	int i;
+	const __m128d sgn = _mm_set_pd (0.0, -0.0);
+	for (i = 0; i < n; i++)
+	{
+		__m128d xv = _mm_loadu_pd (x + 2 * i);
+		__m128d mv = _mm_loadu_pd (m + 2 * i);
+		__m128d mr = _mm_unpacklo_pd (mv, mv);
+		__m128d mi = _mm_unpackhi_pd (mv, mv);
+		__m128d xs = _mm_shuffle_pd (xv, xv, 1);
+		__m128d t  = _mm_add_pd (_mm_mul_pd (xv, mr), _mm_xor_pd (_mm_mul_pd (xs, mi), sgn));
+		_mm_storeu_pd (acc + 2 * i, _mm_add_pd (_mm_loadu_pd (acc + 2 * i), t));
+	}
+}
+
+VM_TARGET("avx")
+static void cmacc_avx (int n, double* acc, double* x, double* m)
+{
+	int i;
+	for (i = 0; i + 2 <= n; i += 2)
+	{
+		__m256d xv = _mm256_loadu_pd (x + 2 * i);
+		__m256d mv = _mm256_loadu_pd (m + 2 * i);
+		__m256d mr = _mm256_movedup_pd (mv);
+		__m256d mi = _mm256_permute_pd (mv, 0xF);
+		__m256d xs = _mm256_permute_pd (xv, 0x5);
+		__m256d t  = _mm256_addsub_pd (_mm256_mul_pd (xv, mr), _mm256_mul_pd (xs, mi));
+		_mm256_storeu_pd (acc + 2 * i, _mm256_add_pd (_mm256_loadu_pd (acc + 2 * i), t));
+	}
+	if (i < n)
+		cmacc_c (n - i, acc + 2 * i, x + 2 * i, m + 2 * i);
+}
+
+VM_TARGET("avx512f")
+static void cmacc_avx512 (int n, double* acc, double* x, double* m)
+{
+	int i;
+	const __m512i sgn = _mm512_set_epi64 (0, (long long)0x8000000000000000ULL, 0, (long long)0x8000000000000000ULL,
+										  0, (long long)0x8000000000000000ULL, 0, (long long)0x8000000000000000ULL);
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m512d xv = _mm512_loadu_pd (x + 2 * i);
+		__m512d mv = _mm512_loadu_pd (m + 2 * i);
+		__m512d mr = _mm512_movedup_pd (mv);
+		__m512d mi = _mm512_permute_pd (mv, 0xFF);
+		__m512d xs = _mm512_permute_pd (xv, 0x55);
+		__m512d p2 = _mm512_castsi512_pd (_mm512_xor_si512 (_mm512_castpd_si512 (_mm512_mul_pd (xs, mi)), sgn));
+		__m512d t  = _mm512_add_pd (_mm512_mul_pd (xv, mr), p2);
+		_mm512_storeu_pd (acc + 2 * i, _mm512_add_pd (_mm512_loadu_pd (acc + 2 * i), t));
+	}
+	if (i < n)
+		cmacc_avx (n - i, acc + 2 * i, x + 2 * i, m + 2 * i);
+}
+
+VM_TARGET("sse2")
+static void cmaccf_sse2 (int n, float* acc, float* x, float* m)
+{
+	int i;
+	const __m128 sgn = _mm_set_ps (0.0f, -0.0f, 0.0f, -0.0f);
+	for (i = 0; i + 2 <= n; i += 2)
+	{
+		__m128 xv = _mm_loadu_ps (x + 2 * i);
+		__m128 mv = _mm_loadu_ps (m + 2 * i);
+		__m128 mr = _mm_shuffle_ps (mv, mv, _MM_SHUFFLE (2, 2, 0, 0));
+		__m128 mi = _mm_shuffle_ps (mv, mv, _MM_SHUFFLE (3, 3, 1, 1));
+		__m128 xs = _mm_shuffle_ps (xv, xv, _MM_SHUFFLE (2, 3, 0, 1));
+		__m128 t  = _mm_add_ps (_mm_mul_ps (xv, mr), _mm_xor_ps (_mm_mul_ps (xs, mi), sgn));
+		_mm_storeu_ps (acc + 2 * i, _mm_add_ps (_mm_loadu_ps (acc + 2 * i), t));
+	}
+	if (i < n)
+		cmaccf_c (n - i, acc + 2 * i, x + 2 * i, m + 2 * i);
+}
+
+VM_TARGET("avx")
+static void cmaccf_avx (int n, float* acc, float* x, float* m)
+{
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m256 xv = _mm256_loadu_ps (x + 2 * i);
+		__m256 mv = _mm256_loadu_ps (m + 2 * i);
+		__m256 mr = _mm256_moveldup_ps (mv);
+		__m256 mi = _mm256_movehdup_ps (mv);
+		__m256 xs = _mm256_permute_ps (xv, 0xB1);
+		__m256 t  = _mm256_addsub_ps (_mm256_mul_ps (xv, mr), _mm256_mul_ps (xs, mi));
+		_mm256_storeu_ps (acc + 2 * i, _mm256_add_ps (_mm256_loadu_ps (acc + 2 * i), t));
+	}
+	if (i < n)
+		cmaccf_sse2 (n - i, acc + 2 * i, x + 2 * i, m + 2 * i);
+}
+
+VM_TARGET("avx512f")
+static void cmaccf_avx512 (int n, float* acc, float* x, float* m)
+{
+	int i;
+	const __m512i sgn = _mm512_set1_epi64 (0x0000000080000000LL);
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m512 xv = _mm512_loadu_ps (x + 2 * i);
+		__m512 mv = _mm512_loadu_ps (m + 2 * i);
+		__m512 mr = _mm512_moveldup_ps (mv);
+		__m512 mi = _mm512_movehdup_ps (mv);
+		__m512 xs = _mm512_permute_ps (xv, 0xB1);
+		__m512 p2 = _mm512_castsi512_ps (_mm512_xor_si512 (_mm512_castps_si512 (_mm512_mul_ps (xs, mi)), sgn));
+		__m512 t  = _mm512_add_ps (_mm512_mul_ps (xv, mr), p2);
+		_mm512_storeu_ps (acc + 2 * i, _mm512_add_ps (_mm512_loadu_ps (acc + 2 * i), t));
+	}
+	if (i < n)
+		cmaccf_avx (n - i, acc + 2 * i, x + 2 * i, m + 2 * i);
+}
+
+// Two complex values per step; both directions use the same loads with a signed stride.
+VM_TARGET("sse2")
+static void cmagmin_sse2 (int n, double* res, double* x, int rev, int init)
+{
+	int k;
+	int step = rev ? -2 : 2;
+	for (k = 0; k + 2 <= n; k += 2)
+	{
+		__m128d a  = _mm_loadu_pd (x + step * k);
+		__m128d b  = _mm_loadu_pd (x + step * (k + 1));
+		__m128d re = _mm_unpacklo_pd (a, b);
+		__m128d im = _mm_unpackhi_pd (a, b);
+		__m128d mag = _mm_add_pd (_mm_mul_pd (re, re), _mm_mul_pd (im, im));
+		if (!init)
+			mag = _mm_min_pd (mag, _mm_loadu_pd (res + k));		// (mag < res) ? mag : res
+		_mm_storeu_pd (res + k, mag);
+	}
+	if (k < n)
+		cmagmin_c (n - k, res + k, x + step * k, rev, init);
+}
+
+VM_TARGET("avx")
+static void cmagmin_avx (int n, double* res, double* x, int rev, int init)
+{
+	int k;
+	if (rev)
+	{
+		cmagmin_sse2 (n, res, x, rev, init);
+		return;
+	}
+	for (k = 0; k + 4 <= n; k += 4)
+	{
+		__m256d a  = _mm256_loadu_pd (x + 2 * k);
+		__m256d b  = _mm256_loadu_pd (x + 2 * k + 4);
+		__m256d c  = _mm256_permute2f128_pd (a, b, 0x20);
+		__m256d d  = _mm256_permute2f128_pd (a, b, 0x31);
+		__m256d re = _mm256_unpacklo_pd (c, d);
+		__m256d im = _mm256_unpackhi_pd (c, d);
+		__m256d mag = _mm256_add_pd (_mm256_mul_pd (re, re), _mm256_mul_pd (im, im));
+		if (!init)
+			mag = _mm256_min_pd (mag, _mm256_loadu_pd (res + k));
+		_mm256_storeu_pd (res + k, mag);
+	}
+	if (k < n)
+		cmagmin_sse2 (n - k, res + k, x + 2 * k, rev, init);
+}
+
+VM_TARGET("avx512f")
+static void cmagmin_avx512 (int n, double* res, double* x, int rev, int init)
+{
+	int k;
+	const __m512i ire = _mm512_set_epi64 (14, 12, 10, 8, 6, 4, 2, 0);
+	const __m512i iim = _mm512_set_epi64 (15, 13, 11, 9, 7, 5, 3, 1);
+	if (rev)
+	{
+		cmagmin_sse2 (n, res, x, rev, init);
+		return;
+	}
+	for (k = 0; k + 8 <= n; k += 8)
+	{
+		__m512d a  = _mm512_loadu_pd (x + 2 * k);
+		__m512d b  = _mm512_loadu_pd (x + 2 * k + 8);
+		__m512d re = _mm512_permutex2var_pd (a, ire, b);
+		__m512d im = _mm512_permutex2var_pd (a, iim, b);
+		__m512d mag = _mm512_add_pd (_mm512_mul_pd (re, re), _mm512_mul_pd (im, im));
+		if (!init)
+			mag = _mm512_min_pd (mag, _mm512_loadu_pd (res + k));
+		_mm512_storeu_pd (res + k, mag);
+	}
+	if (k < n)
+		cmagmin_avx (n - k, res + k, x + 2 * k, rev, init);
+}
+
+VM_TARGET("sse2")
+static double vmax_sse2 (int n, double* x)
+{
+	int i;
+	double m[2];
+	__m128d a = _mm_set1_pd (-1.0e300);
+	__m128d b = a;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		a = _mm_max_pd (a, _mm_loadu_pd (x + i));
+		b = _mm_max_pd (b, _mm_loadu_pd (x + i + 2));
+	}
+	_mm_storeu_pd (m, _mm_max_pd (a, b));
+	m[0] = max (m[0], m[1]);
+	m[1] = vmax_c (n - i, x + i);
+	return max (m[0], m[1]);
+}
+
+VM_TARGET("avx")
+static double vmax_avx (int n, double* x)
+{
+	int i;
+	double m[2];
+	__m256d a = _mm256_set1_pd (-1.0e300);
+	__m128d h;
+	for (i = 0; i + 4 <= n; i += 4)
+		a = _mm256_max_pd (a, _mm256_loadu_pd (x + i));
+	h = _mm_max_pd (_mm256_castpd256_pd128 (a), _mm256_extractf128_pd (a, 1));
+	_mm_storeu_pd (m, h);
+	m[0] = max (m[0], m[1]);
+	m[1] = vmax_c (n - i, x + i);
+	return max (m[0], m[1]);
+}
+
+VM_TARGET("sse2")
+static double vsum_sse2 (int n, double* x)
+{
+	int i;
+	double s[2];
+	__m128d a = _mm_setzero_pd ();
+	__m128d b = _mm_setzero_pd ();
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		a = _mm_add_pd (a, _mm_loadu_pd (x + i));
+		b = _mm_add_pd (b, _mm_loadu_pd (x + i + 2));
+	}
+	_mm_storeu_pd (s, _mm_add_pd (a, b));
+	s[0] += s[1];
+	for (; i < n; i++)
+		s[0] += x[i];
+	return s[0];
+}
+
+VM_TARGET("avx")
+static double vsum_avx (int n, double* x)
+{
+	int i;
+	double s[2];
+	__m256d a = _mm256_setzero_pd ();
+	for (i = 0; i + 4 <= n; i += 4)
+		a = _mm256_add_pd (a, _mm256_loadu_pd (x + i));
+	_mm_storeu_pd (s, _mm_add_pd (_mm256_castpd256_pd128 (a), _mm256_extractf128_pd (a, 1)));
+	s[0] += s[1];
+	for (; i < n; i++)
+		s[0] += x[i];
+	return s[0];
+}
+
+VM_TARGET("sse2")
+static double vsumsq_sse2 (int n, double* x)
+{
+	int i;
+	double s[2];
+	__m128d a = _mm_setzero_pd ();
+	__m128d b = _mm_setzero_pd ();
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m128d u = _mm_loadu_pd (x + i);
+		__m128d v = _mm_loadu_pd (x + i + 2);
+		a = _mm_add_pd (a, _mm_mul_pd (u, u));
+		b = _mm_add_pd (b, _mm_mul_pd (v, v));
+	}
+	_mm_storeu_pd (s, _mm_add_pd (a, b));
+	s[0] += s[1];
+	for (; i < n; i++)
+		s[0] += x[i] * x[i];
+	return s[0];
+}
+
+VM_TARGET("avx")
+static double vsumsq_avx (int n, double* x)
+{
+	int i;
+	double s[2];
+	__m256d a = _mm256_setzero_pd ();
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m256d u = _mm256_loadu_pd (x + i);
+		a = _mm256_add_pd (a, _mm256_mul_pd (u, u));
+	}
+	_mm_storeu_pd (s, _mm_add_pd (_mm256_castpd256_pd128 (a), _mm256_extractf128_pd (a, 1)));
+	s[0] += s[1];
+	for (; i < n; i++)
+		s[0] += x[i] * x[i];
+	return s[0];
+}
+
+VM_TARGET("sse2")
+static double vdot_sse2 (int n, double* x, double* y)
+{
+	int i;
+	double s[2];
+	__m128d a = _mm_setzero_pd ();
+	__m128d b = _mm_setzero_pd ();
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		a = _mm_add_pd (a, _mm_mul_pd (_mm_loadu_pd (x + i + 0), _mm_loadu_pd (y + i + 0)));
+		b = _mm_add_pd (b, _mm_mul_pd (_mm_loadu_pd (x + i + 2), _mm_loadu_pd (y + i + 2)));
+	}
+	_mm_storeu_pd (s, _mm_add_pd (a, b));
+	s[0] += s[1];
+	for (; i < n; i++)
+		s[0] += x[i] * y[i];
+	return s[0];
+}
+
+VM_TARGET("avx")
+static double vdot_avx (int n, double* x, double* y)
+{
+	int i;
+	double s[2];
+	__m256d a = _mm256_setzero_pd ();
+	for (i = 0; i + 4 <= n; i += 4)
+		a = _mm256_add_pd (a, _mm256_mul_pd (_mm256_loadu_pd (x + i), _mm256_loadu_pd (y + i)));
+	_mm_storeu_pd (s, _mm_add_pd (_mm256_castpd256_pd128 (a), _mm256_extractf128_pd (a, 1)));
+	s[0] += s[1];
+	for (; i < n; i++)
+		s[0] += x[i] * y[i];
+	return s[0];
+}
+
+VM_TARGET("sse2")
+static void cdotr_sse2 (int n, double* res, double* x, double* hh)
+{
+	int i;
+	__m128d a0 = _mm_setzero_pd ();
+	__m128d a1 = _mm_setzero_pd ();
+	__m128d a2 = _mm_setzero_pd ();
+	__m128d a3 = _mm_setzero_pd ();
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		a0 = _mm_add_pd (a0, _mm_mul_pd (_mm_loadu_pd (x + 2 * i + 0), _mm_loadu_pd (hh + 2 * i + 0)));
+		a1 = _mm_add_pd (a1, _mm_mul_pd (_mm_loadu_pd (x + 2 * i + 2), _mm_loadu_pd (hh + 2 * i + 2)));
+		a2 = _mm_add_pd (a2, _mm_mul_pd (_mm_loadu_pd (x + 2 * i + 4), _mm_loadu_pd (hh + 2 * i + 4)));
+		a3 = _mm_add_pd (a3, _mm_mul_pd (_mm_loadu_pd (x + 2 * i + 6), _mm_loadu_pd (hh + 2 * i + 6)));
+	}
+	_mm_storeu_pd (res, _mm_add_pd (_mm_add_pd (a0, a2), _mm_add_pd (a1, a3)));
+	for (; i < n; i++)
+	{
+		res[0] += x[2 * i + 0] * hh[2 * i + 0];
+		res[1] += x[2 * i + 1] * hh[2 * i + 1];
+	}
+}
+
+VM_TARGET("avx")
+static void cdotr_avx (int n, double* res, double* x, double* hh)
+{
+	int i;
+	__m256d a = _mm256_setzero_pd ();
+	__m256d b = _mm256_setzero_pd ();
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		a = _mm256_add_pd (a, _mm256_mul_pd (_mm256_loadu_pd (x + 2 * i + 0), _mm256_loadu_pd (hh + 2 * i + 0)));
+		b = _mm256_add_pd (b, _mm256_mul_pd (_mm256_loadu_pd (x + 2 * i + 4), _mm256_loadu_pd (hh + 2 * i + 4)));
+	}
+	a = _mm256_add_pd (a, b);
+	_mm_storeu_pd (res, _mm_add_pd (_mm256_castpd256_pd128 (a), _mm256_extractf128_pd (a, 1)));
+	for (; i < n; i++)
+	{
+		res[0] += x[2 * i + 0] * hh[2 * i + 0];
+		res[1] += x[2 * i + 1] * hh[2 * i + 1];
+	}
+}
+
+VM_TARGET("avx512f")
+static void cdotr_avx512 (int n, double* res, double* x, double* hh)
+{
+	int i;
+	__m512d a = _mm512_setzero_pd ();
+	__m256d b;
+	for (i = 0; i + 4 <= n; i += 4)
+		a = _mm512_add_pd (a, _mm512_mul_pd (_mm512_loadu_pd (x + 2 * i), _mm512_loadu_pd (hh + 2 * i)));
+	b = _mm256_add_pd (_mm512_castpd512_pd256 (a), _mm512_extractf64x4_pd (a, 1));
+	_mm_storeu_pd (res, _mm_add_pd (_mm256_castpd256_pd128 (b), _mm256_extractf128_pd (b, 1)));
+	for (; i < n; i++)
+	{
+		res[0] += x[2 * i + 0] * hh[2 * i + 0];
+		res[1] += x[2 * i + 1] * hh[2 * i + 1];
+	}
+}
+
+VM_TARGET("sse2")
+static void vaxpby_sse2 (int n, double* y, double a, double b, double* x)
+{
+	int i;
+	__m128d va = _mm_set1_pd (a);
+	__m128d vb = _mm_set1_pd (b);
+	for (i = 0; i + 2 <= n; i += 2)
+		_mm_storeu_pd (y + i, _mm_add_pd (_mm_mul_pd (va, _mm_loadu_pd (y + i)), _mm_mul_pd (vb, _mm_loadu_pd (x + i))));
+	vaxpby_c (n - i, y + i, a, b, x + i);
+}
+
+VM_TARGET("avx")
+static void vaxpby_avx (int n, double* y, double a, double b, double* x)
+{
+	int i;
+	__m256d va = _mm256_set1_pd (a);
+	__m256d vb = _mm256_set1_pd (b);
+	for (i = 0; i + 4 <= n; i += 4)
+		_mm256_storeu_pd (y + i, _mm256_add_pd (_mm256_mul_pd (va, _mm256_loadu_pd (y + i)), _mm256_mul_pd (vb, _mm256_loadu_pd (x + i))));
+	vaxpby_c (n - i, y + i, a, b, x + i);
+}
+
+VM_TARGET("avx512f")
+static void vaxpby_avx512 (int n, double* y, double a, double b, double* x)
+{
+	int i;
+	__m512d va = _mm512_set1_pd (a);
+	__m512d vb = _mm512_set1_pd (b);
+	for (i = 0; i + 8 <= n; i += 8)
+		_mm512_storeu_pd (y + i, _mm512_add_pd (_mm512_mul_pd (va, _mm512_loadu_pd (y + i)), _mm512_mul_pd (vb, _mm512_loadu_pd (x + i))));
+	vaxpby_avx (n - i, y + i, a, b, x + i);
+}
+
+// The exponent and table index are extracted with integer operations; SSE2 then loads the two table
+// entries individually while AVX-512 gathers them.  AVX without AVX2 has no 256-bit integer operations
+// and uses the SSE2 kernel.
+VM_TARGET("sse2")
+static void vdb_sse2 (int n, double* db, double* g, double* x, double k)
+{
+	int i;
+	const __m128d kv   = _mm_set1_pd (k);
+	const __m128d tiny = _mm_set1_pd (1.0e-60);
+	const __m128d ten  = _mm_set1_pd (10.0);
+	const __m128d conv = _mm_set1_pd (mlog10_conv);
+	const __m128d bias = _mm_set1_pd (1023.0);
+	const __m128i emsk = _mm_set_epi32 (0, 2047, 0, 2047);
+	const __m128i mmsk = _mm_set_epi32 (0, (1 << MLOG10_BITS) - 1, 0, (1 << MLOG10_BITS) - 1);
+	for (i = 0; i + 2 <= n; i += 2)
+	{
+		__m128d v  = _mm_add_pd (_mm_mul_pd (_mm_mul_pd (_mm_loadu_pd (g + i), _mm_loadu_pd (x + i)), kv), tiny);
+		__m128i b  = _mm_castpd_si128 (v);
+		__m128i e  = _mm_and_si128 (_mm_srli_epi64 (b, 52), emsk);
+		__m128i m  = _mm_and_si128 (_mm_srli_epi64 (b, 52 - MLOG10_BITS), mmsk);
+		__m128d ed = _mm_sub_pd (_mm_cvtepi32_pd (_mm_shuffle_epi32 (e, _MM_SHUFFLE (3, 1, 2, 0))), bias);
+		__m128d t  = _mm_set_pd (mlog10_table[_mm_cvtsi128_si32 (_mm_srli_si128 (m, 8))], mlog10_table[_mm_cvtsi128_si32 (m)]);
+		_mm_storeu_pd (db + i, _mm_mul_pd (ten, _mm_mul_pd (conv, _mm_add_pd (ed, t))));
+	}
+	if (i < n)
+		vdb_c (n - i, db + i, g + i, x + i, k);
+}
+
+VM_TARGET("avx512f")
+static void vdb_avx512 (int n, double* db, double* g, double* x, double k)
+{
+	int i;
+	const __m512d kv   = _mm512_set1_pd (k);
+	const __m512d tiny = _mm512_set1_pd (1.0e-60);
+	const __m512d ten  = _mm512_set1_pd (10.0);
+	const __m512d conv = _mm512_set1_pd (mlog10_conv);
+	const __m512d bias = _mm512_set1_pd (1023.0);
+	const __m512i emsk = _mm512_set1_epi64 (2047);
+	const __m512i mmsk = _mm512_set1_epi64 ((1 << MLOG10_BITS) - 1);
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m512d v  = _mm512_add_pd (_mm512_mul_pd (_mm512_mul_pd (_mm512_loadu_pd (g + i), _mm512_loadu_pd (x + i)), kv), tiny);
+		__m512i b  = _mm512_castpd_si512 (v);
+		__m512i e  = _mm512_and_si512 (_mm512_srli_epi64 (b, 52), emsk);
+		__m512i m  = _mm512_and_si512 (_mm512_srli_epi64 (b, 52 - MLOG10_BITS), mmsk);
+		__m512d ed = _mm512_sub_pd (_mm512_cvtepi32_pd (_mm512_cvtepi64_epi32 (e)), bias);
+		__m512d t  = _mm512_i64gather_pd (m, mlog10_table, 8);
+		_mm512_storeu_pd (db + i, _mm512_mul_pd (ten, _mm512_mul_pd (conv, _mm512_add_pd (ed, t))));
+	}
+	if (i < n)
+		vdb_sse2 (n - i, db + i, g + i, x + i, k);
+}
+
+// min/max with the limit as the first operand return the second (x) when either is NaN, as vexp_c() does
+VM_TARGET("sse2")
+static void vexp_sse2 (int n, double* y, double* x)
+{
+	int i, j;
+	const __m128d hi    = _mm_set1_pd (VX_HI);
+	const __m128d lo    = _mm_set1_pd (VX_LO);
+	const __m128d magic = _mm_set1_pd (VX_MAGIC);
+	const __m128d l2e   = _mm_set1_pd (vx_log2e);
+	const __m128d c1    = _mm_set1_pd (vx_ln2hi);
+	const __m128d c2    = _mm_set1_pd (vx_ln2lo);
+	const __m128i bias  = _mm_set1_epi64x (1023);
+	for (i = 0; i + 2 <= n; i += 2)
+	{
+		__m128d v = _mm_max_pd (lo, _mm_min_pd (hi, _mm_loadu_pd (x + i)));
+		__m128d t = _mm_add_pd (_mm_mul_pd (v, l2e), magic);
+		__m128i b = _mm_slli_epi64 (_mm_add_epi64 (_mm_castpd_si128 (t), bias), 52);
+		__m128d r, p;
+		t = _mm_sub_pd (t, magic);
+		r = _mm_sub_pd (_mm_sub_pd (v, _mm_mul_pd (t, c1)), _mm_mul_pd (t, c2));
+		p = _mm_set1_pd (vx_c[12]);
+		for (j = 11; j >= 0; j--)
+			p = _mm_add_pd (_mm_mul_pd (p, r), _mm_set1_pd (vx_c[j]));
+		_mm_storeu_pd (y + i, _mm_mul_pd (p, _mm_castsi128_pd (b)));
+	}
+	if (i < n)
+		vexp_c (n - i, y + i, x + i);
+}
+
+VM_TARGET("avx")
+static void vexp_avx (int n, double* y, double* x)
+{
+	// AVX has no 256-bit integer add or shift; the exponent bits are built in two 128-bit halves
+	int i, j;
+	const __m256d hi    = _mm256_set1_pd (VX_HI);
+	const __m256d lo    = _mm256_set1_pd (VX_LO);
+	const __m256d magic = _mm256_set1_pd (VX_MAGIC);
+	const __m256d l2e   = _mm256_set1_pd (vx_log2e);
+	const __m256d c1    = _mm256_set1_pd (vx_ln2hi);
+	const __m256d c2    = _mm256_set1_pd (vx_ln2lo);
+	const __m128i bias  = _mm_set1_epi64x (1023);
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m256d v = _mm256_max_pd (lo, _mm256_min_pd (hi, _mm256_loadu_pd (x + i)));
+		__m256d t = _mm256_add_pd (_mm256_mul_pd (v, l2e), magic);
+		__m256i tb = _mm256_castpd_si256 (t);
+		__m128i b0 = _mm_slli_epi64 (_mm_add_epi64 (_mm256_castsi256_si128 (tb), bias), 52);
+		__m128i b1 = _mm_slli_epi64 (_mm_add_epi64 (_mm256_extractf128_si256 (tb, 1), bias), 52);
+		__m256d s = _mm256_castsi256_pd (_mm256_insertf128_si256 (_mm256_castsi128_si256 (b0), b1, 1));
+		__m256d r, p;
+		t = _mm256_sub_pd (t, magic);
+		r = _mm256_sub_pd (_mm256_sub_pd (v, _mm256_mul_pd (t, c1)), _mm256_mul_pd (t, c2));
+		p = _mm256_set1_pd (vx_c[12]);
+		for (j = 11; j >= 0; j--)
+			p = _mm256_add_pd (_mm256_mul_pd (p, r), _mm256_set1_pd (vx_c[j]));
+		_mm256_storeu_pd (y + i, _mm256_mul_pd (p, s));
+	}
+	if (i < n)
+		vexp_sse2 (n - i, y + i, x + i);
+}
+
+VM_TARGET("avx512f")
+static void vexp_avx512 (int n, double* y, double* x)
+{
+	int i, j;
+	const __m512d hi    = _mm512_set1_pd (VX_HI);
+	const __m512d lo    = _mm512_set1_pd (VX_LO);
+	const __m512d magic = _mm512_set1_pd (VX_MAGIC);
+	const __m512d l2e   = _mm512_set1_pd (vx_log2e);
+	const __m512d c1    = _mm512_set1_pd (vx_ln2hi);
+	const __m512d c2    = _mm512_set1_pd (vx_ln2lo);
+	const __m512i bias  = _mm512_set1_epi64 (1023);
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m512d v = _mm512_max_pd (lo, _mm512_min_pd (hi, _mm512_loadu_pd (x + i)));
+		__m512d t = _mm512_add_pd (_mm512_mul_pd (v, l2e), magic);
+		__m512i b = _mm512_slli_epi64 (_mm512_add_epi64 (_mm512_castpd_si512 (t), bias), 52);
+		__m512d r, p;
+		t = _mm512_sub_pd (t, magic);
+		r = _mm512_sub_pd (_mm512_sub_pd (v, _mm512_mul_pd (t, c1)), _mm512_mul_pd (t, c2));
+		p = _mm512_set1_pd (vx_c[12]);
+		for (j = 11; j >= 0; j--)
+			p = _mm512_add_pd (_mm512_mul_pd (p, r), _mm512_set1_pd (vx_c[j]));
+		_mm512_storeu_pd (y + i, _mm512_mul_pd (p, _mm512_castsi512_pd (b)));
+	}
+	if (i < n)
+		vexp_avx (n - i, y + i, x + i);
+}
+
+#endif
+
+/********************************************************************************************************
+*																										*
+*											ARM64 Kernels												*
+*																										*
+********************************************************************************************************/
+
+#if defined(VM_NEON)
+
+static void cmacc_neon (int n, double* acc, double* x, double* m)
+{
+	int i;
+	for (i = 0; i + 2 <= n; i += 2)
+	{
+		float64x2x2_t xv = vld2q_f64 (x + 2 * i);
+		float64x2x2_t mv = vld2q_f64 (m + 2 * i);
+		float64x2x2_t av = vld2q_f64 (acc + 2 * i);
+		float64x2_t re = vsubq_f64 (vmulq_f64 (xv.val[0], mv.val[0]), vmulq_f64 (xv.val[1], mv.val[1]));
+		float64x2_t im = vaddq_f64 (vmulq_f64 (xv.val[0], mv.val[1]), vmulq_f64 (xv.val[1], mv.val[0]));
+		av.val[0] = vaddq_f64 (av.val[0], re);
+		av.val[1] = vaddq_f64 (av.val[1], im);
+		vst2q_f64 (acc + 2 * i, av);
+	}
+	if (i < n)
+		cmacc_c (n - i, acc + 2 * i, x + 2 * i, m + 2 * i);
+}
+
+static void cmaccf_neon (int n, float* acc, float* x, float* m)
+{
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		float32x4x2_t xv = vld2q_f32 (x + 2 * i);
+		float32x4x2_t mv = vld2q_f32 (m + 2 * i);
+		float32x4x2_t av = vld2q_f32 (acc + 2 * i);
+		float32x4_t re = vsubq_f32 (vmulq_f32 (xv.val[0], mv.val[0]), vmulq_f32 (xv.val[1], mv.val[1]));
+		float32x4_t im = vaddq_f32 (vmulq_f32 (xv.val[0], mv.val[1]), vmulq_f32 (xv.val[1], mv.val[0]));
+		av.val[0] = vaddq_f32 (av.val[0], re);
+		av.val[1] = vaddq_f32 (av.val[1], im);
+		vst2q_f32 (acc + 2 * i, av);
+	}
+	if (i < n)
+		cmaccf_c (n - i, acc + 2 * i, x + 2 * i, m + 2 * i);
+}
+
+static void cmagmin_neon (int n, double* res, double* x, int rev, int init)
+{
+	int k;
+	if (rev)
+	{
+		cmagmin_c (n, res, x, rev, init);
+		return;
+	}
+	for (k = 0; k + 2 <= n; k += 2)
+	{
+		float64x2x2_t xv = vld2q_f64 (x + 2 * k);
+		float64x2_t mag = vaddq_f64 (vmulq_f64 (xv.val[0], xv.val[0]), vmulq_f64 (xv.val[1], xv.val[1]));
+		if (!init)
+		{
+			float64x2_t r = vld1q_f64 (res + k);
+			mag = vbslq_f64 (vcltq_f64 (mag, r), mag, r);		// (mag < res) ? mag : res
+		}
+		vst1q_f64 (res + k, mag);
+	}
+	if (k < n)
+		cmagmin_c (n - k, res + k, x + 2 * k, rev, init);
+}
+
+static double vsum_neon (int n, double* x)
+{
+	int i;
+	double s;
+	float64x2_t a = vdupq_n_f64 (0.0);
+	float64x2_t b = vdupq_n_f64 (0.0);
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		a = vaddq_f64 (a, vld1q_f64 (x + i));
+		b = vaddq_f64 (b, vld1q_f64 (x + i + 2));
+	}
+	a = vaddq_f64 (a, b);
+	s = vgetq_lane_f64 (a, 0) + vgetq_lane_f64 (a, 1);
+	for (; i < n; i++)
+		s += x[i];
+	return s;
+}
+
+static double vsumsq_neon (int n, double* x)
+{
+	int i;
+	double s;
+	float64x2_t a = vdupq_n_f64 (0.0);
+	float64x2_t b = vdupq_n_f64 (0.0);
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		float64x2_t u = vld1q_f64 (x + i);
+		float64x2_t v = vld1q_f64 (x + i + 2);
+		a = vaddq_f64 (a, vmulq_f64 (u, u));
+		b = vaddq_f64 (b, vmulq_f64 (v, v));
+	}
+	a = vaddq_f64 (a, b);
+	s = vgetq_lane_f64 (a, 0) + vgetq_lane_f64 (a, 1);
+	for (; i < n; i++)
+		s += x[i] * x[i];
+	return s;
+}
+
+static double vdot_neon (int n, double* x, double* y)
+{
+	int i;
+	double s;
+	float64x2_t a = vdupq_n_f64 (0.0);
+	float64x2_t b = vdupq_n_f64 (0.0);
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		a = vaddq_f64 (a, vmulq_f64 (vld1q_f64 (x + i + 0), vld1q_f64 (y + i + 0)));
+		b = vaddq_f64 (b, vmulq_f64 (vld1q_f64 (x + i + 2), vld1q_f64 (y + i + 2)));
+	}
+	a = vaddq_f64 (a, b);
+	s = vgetq_lane_f64 (a, 0) + vgetq_lane_f64 (a, 1);
+	for (; i < n; i++)
+		s += x[i] * y[i];
+	return s;
+}
+
+static void cdotr_neon (int n, double* res, double* x, double* hh)
+{
+	int i;
+	float64x2_t a0 = vdupq_n_f64 (0.0);
+	float64x2_t a1 = vdupq_n_f64 (0.0);
+	float64x2_t a2 = vdupq_n_f64 (0.0);
+	float64x2_t a3 = vdupq_n_f64 (0.0);
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		a0 = vaddq_f64 (a0, vmulq_f64 (vld1q_f64 (x + 2 * i + 0), vld1q_f64 (hh + 2 * i + 0)));
+		a1 = vaddq_f64 (a1, vmulq_f64 (vld1q_f64 (x + 2 * i + 2), vld1q_f64 (hh + 2 * i + 2)));
+		a2 = vaddq_f64 (a2, vmulq_f64 (vld1q_f64 (x + 2 * i + 4), vld1q_f64 (hh + 2 * i + 4)));
+		a3 = vaddq_f64 (a3, vmulq_f64 (vld1q_f64 (x + 2 * i + 6), vld1q_f64 (hh + 2 * i + 6)));
+	}
+	vst1q_f64 (res, vaddq_f64 (vaddq_f64 (a0, a2), vaddq_f64 (a1, a3)));
+	for (; i < n; i++)
+	{
+		res[0] += x[2 * i + 0] * hh[2 * i + 0];
+		res[1] += x[2 * i + 1] * hh[2 * i + 1];
+	}
+}
+
+static void vaxpby_neon (int n, double* y, double a, double b, double* x)
+{
+	int i;
+	for (i = 0; i + 2 <= n; i += 2)
+		vst1q_f64 (y + i, vaddq_f64 (vmulq_n_f64 (vld1q_f64 (y + i), a), vmulq_n_f64 (vld1q_f64 (x + i), b)));
+	vaxpby_c (n - i, y + i, a, b, x + i);
+}
+
+static void vexp_neon (int n, double* y, double* x)
+{
+	int i, j;
+	const float64x2_t hi    = vdupq_n_f64 (VX_HI);
+	const float64x2_t lo    = vdupq_n_f64 (VX_LO);
+	const float64x2_t magic = vdupq_n_f64 (VX_MAGIC);
+	const int64x2_t bias    = vdupq_n_s64 (1023);
+	for (i = 0; i + 2 <= n; i += 2)
+	{
+		float64x2_t v = vminq_f64 (hi, vld1q_f64 (x + i));
+		float64x2_t t, r, p;
+		int64x2_t b;
+		v = vmaxq_f64 (lo, v);
+		t = vaddq_f64 (vmulq_f64 (v, vdupq_n_f64 (vx_log2e)), magic);
+		b = vshlq_n_s64 (vaddq_s64 (vreinterpretq_s64_f64 (t), bias), 52);
+		t = vsubq_f64 (t, magic);
+		r = vsubq_f64 (vsubq_f64 (v, vmulq_f64 (t, vdupq_n_f64 (vx_ln2hi))), vmulq_f64 (t, vdupq_n_f64 (vx_ln2lo)));
+		p = vdupq_n_f64 (vx_c[12]);
+		for (j = 11; j >= 0; j--)
+			p = vaddq_f64 (vmulq_f64 (p, r), vdupq_n_f64 (vx_c[j]));
+		vst1q_f64 (y + i, vmulq_f64 (p, vreinterpretq_f64_s64 (b)));
+	}
+	if (i < n)
+		vexp_c (n - i, y + i, x + i);
+}
+
+#endif
+
+/********************************************************************************************************
+*																										*
+*											CPU Dispatch												*
+*																										*
+********************************************************************************************************/
+
+static int vm_max = -1;					// highest level supported by this cpu
+static int vm_cur = -1;					// level in use
+
+static int vm_detect (void)
+{
+#if defined(VM_X86)
+#if defined(_MSC_VER)
+	int info[4];
+	unsigned long long xcr0;
+	__cpuid (info, 1);
+	if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)))		// OSXSAVE, AVX
+		return VM_SSE2;
+	xcr0 = _xgetbv (0);
+	if ((xcr0 & 0x06) != 0x06)									// XMM and YMM state enabled by the OS
+		return VM_SSE2;
+	__cpuidex (info, 7, 0);
+	if ((info[1] & (1 << 16)) && (xcr0 & 0xE6) == 0xE6)			// AVX512F, opmask and ZMM state enabled
+		return VM_AVX512;
+	return VM_AVX;
+#else
+	__builtin_cpu_init ();
+	if (__builtin_cpu_supports ("avx512f")) return VM_AVX512;
+	if (__builtin_cpu_supports ("avx"))     return VM_AVX;
+	return VM_SSE2;
+#endif
+#elif defined(VM_NEON)
+	return VM_SSE2;
+#else
+	return VM_SCALAR;
+#endif
+}
+
+static void vm_select (int level)
+{
+	if (vm_max < 0) vm_max = vm_detect ();
+	if (level < 0 || level > vm_max) level = vm_max;
+	cmacc   = cmacc_c;
+	cmaccf  = cmaccf_c;
+	cmagmin = cmagmin_c;
+	vmax    = vmax_c;
+	vsum    = vsum_c;
+	vsumsq  = vsumsq_c;
+	vdot    = vdot_c;
+	cdotr   = cdotr_c;
+	vaxpby  = vaxpby_c;
+	vdb     = vdb_c;
+	vexp    = vexp_c;
+#if defined(VM_X86)
+	switch (level)
+	{
+	case VM_AVX512:
+		cmacc   = cmacc_avx512;
+		cmaccf  = cmaccf_avx512;
+		cmagmin = cmagmin_avx512;
+		vmax    = vmax_avx;
+		vsum    = vsum_avx;
+		vsumsq  = vsumsq_avx;
+		vdot    = vdot_avx;
+		cdotr   = cdotr_avx512;
+		vaxpby  = vaxpby_avx512;
+		vdb     = vdb_avx512;
+		vexp    = vexp_avx512;
+		break;
+	case VM_AVX:
+		cmacc   = cmacc_avx;
+		cmaccf  = cmaccf_avx;
+		cmagmin = cmagmin_avx;
+		vmax    = vmax_avx;
+		vsum    = vsum_avx;
+		vsumsq  = vsumsq_avx;
+		vdot    = vdot_avx;
+		cdotr   = cdotr_avx;
+		vaxpby  = vaxpby_avx;
+		vdb     = vdb_sse2;
+		vexp    = vexp_avx;
+		break;
+	case VM_SSE2:
+		cmacc   = cmacc_sse2;
+		cmaccf  = cmaccf_sse2;
+		cmagmin = cmagmin_sse2;
+		vmax    = vmax_sse2;
+		vsum    = vsum_sse2;
+		vsumsq  = vsumsq_sse2;
+		vdot    = vdot_sse2;
+		cdotr   = cdotr_sse2;
+		vaxpby  = vaxpby_sse2;
+		vdb     = vdb_sse2;
+		vexp    = vexp_sse2;
+		break;
+	}
+#elif defined(VM_NEON)
+	if (level >= VM_SSE2)
+	{
+		cmacc   = cmacc_neon;
+		cmaccf  = cmaccf_neon;
+		cmagmin = cmagmin_neon;
+		vsum    = vsum_neon;
+		vsumsq  = vsumsq_neon;
+		vdot    = vdot_neon;
+		cdotr   = cdotr_neon;
+		vaxpby  = vaxpby_neon;
+		vexp    = vexp_neon;
+	}
+#endif
+	vm_cur = level;
+}
+
+// the pointers start at resolvers that select the kernels on first use
+
+static void cmacc_resolve (int n, double* acc, double* x, double* m)
+{
+	vm_select (-1);
+	cmacc (n, acc, x, m);
+}
+
+static void cmaccf_resolve (int n, float* acc, float* x, float* m)
+{
+	vm_select (-1);
+	cmaccf (n, acc, x, m);
+}
+
+static void cmagmin_resolve (int n, double* res, double* x, int rev, int init)
+{
+	vm_select (-1);
+	cmagmin (n, res, x, rev, init);
+}
+
+static double vmax_resolve (int n, double* x)
+{
+	vm_select (-1);
+	return vmax (n, x);
+}
+
+static double vsum_resolve (int n, double* x)
+{
+	vm_select (-1);
+	return vsum (n, x);
+}
+
+static double vsumsq_resolve (int n, double* x)
+{
+	vm_select (-1);
+	return vsumsq (n, x);
+}
+
+static double vdot_resolve (int n, double* x, double* y)
+{
+	vm_select (-1);
+	return vdot (n, x, y);
+}
+
+static void cdotr_resolve (int n, double* res, double* x, double* hh)
+{
+	vm_select (-1);
+	cdotr (n, res, x, hh);
+}
+
+static void vaxpby_resolve (int n, double* y, double a, double b, double* x)
+{
+	vm_select (-1);
+	vaxpby (n, y, a, b, x);
+}
+
+static void vdb_resolve (int n, double* db, double* g, double* x, double k)
+{
+	vm_select (-1);
+	vdb (n, db, g, x, k);
+}
+
+static void vexp_resolve (int n, double* y, double* x)
+{
+	vm_select (-1);
+	vexp (n, y, x);
+}
+
+void (*cmacc)  (int n, double* acc, double* x, double* m) = cmacc_resolve;
+void (*cmaccf) (int n, float* acc, float* x, float* m)    = cmaccf_resolve;
+void (*cmagmin) (int n, double* res, double* x, int rev, int init) = cmagmin_resolve;
+double (*vmax)   (int n, double* x) = vmax_resolve;
+double (*vsum)   (int n, double* x) = vsum_resolve;
+double (*vsumsq) (int n, double* x) = vsumsq_resolve;
+double (*vdot)   (int n, double* x, double* y) = vdot_resolve;
+void (*cdotr) (int n, double* res, double* x, double* hh) = cdotr_resolve;
+void (*vaxpby) (int n, double* y, double a, double b, double* x) = vaxpby_resolve;
+void (*vdb) (int n, double* db, double* g, double* x, double k) = vdb_resolve;
+void (*vexp) (int n, double* y, double* x) = vexp_resolve;
+
+int vm_level (void)
+{
+	if (vm_cur < 0) vm_select (-1);
+	return vm_cur;
+}
+
+PORT
+int GetSIMDLevel (void)
+{
+	return vm_level ();
+}
+
+PORT
+void SetSIMDLevel (int level)
+{	// -1 selects the highest level the cpu supports; used to compare kernels against the scalar path
+	vm_select (level);
+}
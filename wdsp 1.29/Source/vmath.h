@@ -0,0 +1,84 @@
+/*  vmath.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at
+
+warren@wpratt.com
+
+*/
+
+/********************************************************************************************************
+*																										*
+*								Vector Kernels with Run-Time CPU Dispatch								*
+*																										*
+********************************************************************************************************/
+
+#ifndef _vmath_h
+#define _vmath_h
+
+#define VM_SCALAR		0			// plain C
+#define VM_SSE2			1			// SSE2 on x86, NEON on ARM64
+#define VM_AVX			2
+#define VM_AVX512		3
+
+// complex multiply-accumulate, acc[i] += x[i] * m[i] for 'n' interleaved complex values
+// The vector versions perform the same operations in the same order as the scalar version (no FMA
+// contraction), so results are bit-identical across levels.
+extern void (*cmacc)  (int n, double* acc, double* x, double* m);
+extern void (*cmaccf) (int n, float* acc, float* x, float* m);
+
+// |x|^2 of 'n' interleaved complex values, min-held into 'res':  res[k] = |x[k]|^2 when 'init', else the
+// smaller of res[k] and |x[k]|^2.  With 'rev', the values are read backwards from x, i.e., res[k] uses x[-k].
+extern void (*cmagmin) (int n, double* res, double* x, int rev, int init);
+
+// maximum (-1.0e300 for n == 0), sum, and sum of squares of 'n' values.  Sums use a fixed four-lane
+// order at every level, so they are bit-identical across levels but may differ from a sequential sum
+// in the last bits.
+extern double (*vmax)   (int n, double* x);
+extern double (*vsum)   (int n, double* x);
+extern double (*vsumsq) (int n, double* x);
+
+// dot product of 'n' values, in the same four-lane order as vsum
+extern double (*vdot) (int n, double* x, double* y);
+
+// res[0] + j res[1] = sum of x[k] * h[k] for 'n' interleaved complex x[k] and real h[k], where the
+// coefficients are stored twice, hh[2k] == hh[2k+1] == h[k]; four-lane order by k, as vsum
+extern void (*cdotr) (int n, double* res, double* x, double* hh);
+
+// y[i] = a * y[i] + b * x[i], bit-identical to the scalar expression
+extern void (*vaxpby) (int n, double* y, double a, double b, double* x);
+
+// db[i] = 10 * mlog10 (g[i] * x[i] * k + 1.0e-60), bit-identical to the scalar expression.  mlog10 takes
+// the log of the mantissa from a 2048-entry table indexed by its top 11 bits, so the result falls short of
+// 10 * log10(.) by less than 10 * log10 (1 + 2^-11) = 0.00212 dB; it exceeds it only by the rounding of
+// mlog10_conv and the table, under 1e-12 dB (tests/mlog10_bound.c).
+extern void (*vdb) (int n, double* db, double* g, double* x, double k);
+
+// y[i] = exp (x[i]), with x[i] clamped to [-708, 709] so that the result is always a normal number.
+// Accurate to about 2 ulp and bit-identical across levels; 'y' may be 'x'.
+extern void (*vexp) (int n, double* y, double* x);
+
+extern int vm_level (void);
+
+extern __declspec (dllexport) int GetSIMDLevel (void);
+
+extern __declspec (dllexport) void SetSIMDLevel (int level);
+
+#endif
@@ -48,11 +48,13 @@ void calc_wcpagc (WCPAGC a)
 	a->state = 0;
 	a->ring = (double *)malloc0(RB_SIZE * sizeof(complex));
 	a->abs_ring = (double *)malloc0(RB_SIZE * sizeof(double));
+	a->smax = create_slmax (RB_SIZE, 0);
 	loadWcpAGC(a);
 }
 
 void decalc_wcpagc (WCPAGC a)
 {
+	destroy_slmax (a->smax);
 	_aligned_free(a->abs_ring);
 	_aligned_free(a->ring);
 }
@@ -114,10 +116,18 @@ WCPAGC create_wcpagc (	int run,
 
 void loadWcpAGC (WCPAGC a)
 {
+	int j, k;
 	double tmp;
 	//calculate internal parameters
 	a->attack_buffsize = (int)ceil(a->sample_rate * a->n_tau * a->tau_attack);
 	a->in_index = a->attack_buffsize + a->out_index;
+	setWindow_slmax (a->smax, a->attack_buffsize);
+	for (j = 0, k = a->out_index; j < a->attack_buffsize; j++)
+	{
+		if (++k == a->ring_buffsize)
+			k = 0;
+		xslmax (a->smax, a->abs_ring[k]);
+	}
 	a->attack_mult = 1.0 - exp(-1.0 / (a->sample_rate * a->tau_attack));
 	a->decay_mult = 1.0 - exp(-1.0 / (a->sample_rate * a->tau_decay));
 	a->fast_decay_mult = 1.0 - exp(-1.0 / (a->sample_rate * a->tau_fast_decay));
@@ -156,12 +166,14 @@ void flush_wcpagc (WCPAGC a)
 	memset ((void *)a->ring, 0, sizeof(double) * RB_SIZE * 2);
 	a->ring_max = 0.0;
 	memset ((void *)a->abs_ring, 0, sizeof(double)* RB_SIZE);
+	flush_slmax (a->smax);
 }
 
 void xwcpagc (WCPAGC a)
 {
-	int i, j, k;
+	int i;
 	double mult;
+	double win_max;
 	if (a->run)
 	{
 		if (a->mode == 0)
@@ -191,21 +203,13 @@ void xwcpagc (WCPAGC a)
 			else
 				a->abs_ring[a->in_index] = sqrt(a->ring[2 * a->in_index + 0] * a->ring[2 * a->in_index + 0] + a->ring[2 * a->in_index + 1] * a->ring[2 * a->in_index + 1]);
 
+			win_max = xslmax (a->smax, a->abs_ring[a->in_index]);
+
 			a->fast_backaverage = a->fast_backmult * a->abs_out_sample + a->onemfast_backmult * a->fast_backaverage;
 			a->hang_backaverage = a->hang_backmult * a->abs_out_sample + a->onemhang_backmult * a->hang_backaverage;
 
 			if ((a->abs_out_sample >= a->ring_max) && (a->abs_out_sample > 0.0))
-			{
-				a->ring_max = 0.0;
-				k = a->out_index;
-				for (j = 0; j < a->attack_buffsize; j++)
-				{
-					if (++k == a->ring_buffsize)
-						k = 0;
-					if (a->abs_ring[k] > a->ring_max)
-						a->ring_max = a->abs_ring[k];
-				}
-			}
+				a->ring_max = win_max;
 			if (a->abs_ring[a->in_index] > a->ring_max)
 				a->ring_max = a->abs_ring[a->in_index];
 
@@ -68,6 +68,7 @@ typedef struct _wcpagc
 	double* abs_ring;
 	int ring_buffsize;
 	double ring_max;
+	struct _slmax *smax;			// maximum of the 'attack_buffsize' newest values of 'abs_ring'
 
 	double attack_mult;
 	double decay_mult;
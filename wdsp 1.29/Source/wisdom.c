@@ -48,6 +48,7 @@ int WDSPwisdom (char* directory)
 	const int maxsize = max (MAX_WISDOM_SIZE_DISPLAY, MAX_WISDOM_SIZE_FILTER + 1);
 	strcpy (wisdom_file, directory);
 	strncat (wisdom_file, "wdspWisdom00", 16);
+	enter_fftplanner ();
 	if(!fftw_import_wisdom_from_filename(wisdom_file))
 	{
 		fftin =  (double *) malloc0 (maxsize * sizeof (complex));
@@ -109,5 +110,6 @@ int WDSPwisdom (char* directory)
 		FreeConsole();							// dismiss console
 		wisdom_return = 1;
 	}
+	leave_fftplanner ();
 	return wisdom_return;
 }
\ No newline at end of file
@@ -0,0 +1,197 @@
+/*  zoom.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+
+#include "comm.h"
+
+static void calc_zoom_shift (ZOOM a)
+{
+	a->delta = - TWOPI * a->freq / a->rate;
+	a->cos_delta = cos (a->delta);
+	a->sin_delta = sin (a->delta);
+}
+
+static void init_zstage (zstage* s, int decim, int ncoef, int step, int center, double* coef)
+{
+	s->decim = decim;
+	s->ncoef = ncoef;
+	s->step = step;
+	s->center = center;
+	s->coef = coef;
+	s->ring = (double *) malloc0 (2 * ncoef * sizeof (complex));
+	s->idx = 0;
+	s->phase = 0;
+}
+
+static double* cic_impulse (int R)
+{
+	// ZOOM_CIC_ORDER-fold convolution of an R-point boxcar, normalized to unity gain at DC
+	int i, j, k, n = 1;
+	double* c = (double *) malloc0 ((ZOOM_CIC_ORDER * (R - 1) + 1) * sizeof (double));
+	double* t = (double *) malloc0 ((ZOOM_CIC_ORDER * (R - 1) + 1) * sizeof (double));
+	double norm = pow ((double)R, (double)ZOOM_CIC_ORDER);
+	c[0] = 1.0;
+	for (k = 0; k < ZOOM_CIC_ORDER; k++)
+	{
+		memset (t, 0, (n + R - 1) * sizeof (double));
+		for (i = 0; i < n; i++)
+			for (j = 0; j < R; j++)
+				t[i + j] += c[i];
+		n += R - 1;
+		memcpy (c, t, n * sizeof (double));
+	}
+	for (i = 0; i < n; i++)
+		c[i] /= norm;
+	_aligned_free (t);
+	return c;
+}
+
+ZOOM create_zoom (int size, double rate, double freq, int decim)
+{
+	ZOOM a = (ZOOM) malloc0 (sizeof (zoom));
+	int i, nhb = 0, R;
+	a->size = size;
+	for (a->decim = 2; a->decim < decim && a->decim < ZOOM_MAX_DECIM; a->decim *= 2);
+	a->rate = rate;
+	a->freq = freq;
+	a->phase = 0.0;
+	calc_zoom_shift (a);
+	R = a->decim;
+	while (R > 1 && nhb < 3)
+	{
+		R /= 2;
+		nhb++;
+	}
+	if (R > 1)
+		init_zstage (&a->stage[a->nstages++], R, ZOOM_CIC_ORDER * (R - 1) + 1, 1, -1, cic_impulse (R));
+	for (i = 0; i < nhb; i++)
+		init_zstage (&a->stage[a->nstages++], 2, ZOOM_HB_TAPS, 2, ZOOM_HB_TAPS / 2,
+			fir_bandpass (ZOOM_HB_TAPS, -0.25, +0.25, 1.0, 0, 0, 1.0));
+	a->in = (double *) malloc0 (size * sizeof (complex));
+	a->buff[0] = (double *) malloc0 ((size + 1) * sizeof (complex));
+	a->buff[1] = (double *) malloc0 ((size + 1) * sizeof (complex));
+	a->Ibuff = (dINREAL *) malloc0 (size * sizeof (dINREAL));
+	a->Qbuff = (dINREAL *) malloc0 (size * sizeof (dINREAL));
+	return a;
+}
+
+void destroy_zoom (ZOOM a)
+{
+	int i;
+	for (i = 0; i < a->nstages; i++)
+	{
+		_aligned_free (a->stage[i].ring);
+		_aligned_free (a->stage[i].coef);
+	}
+	_aligned_free (a->Qbuff);
+	_aligned_free (a->Ibuff);
+	_aligned_free (a->buff[1]);
+	_aligned_free (a->buff[0]);
+	_aligned_free (a->in);
+	_aligned_free (a);
+}
+
+void flush_zoom (ZOOM a)
+{
+	int i;
+	a->phase = 0.0;
+	for (i = 0; i < a->nstages; i++)
+	{
+		memset (a->stage[i].ring, 0, 2 * a->stage[i].ncoef * sizeof (complex));
+		a->stage[i].idx = 0;
+		a->stage[i].phase = 0;
+	}
+}
+
+static int xzstage (zstage* s, int n, double* in, double* out)
+{
+	int i, k, m = 0;
+	double I, Q;
+	double* w;
+	for (i = 0; i < n; i++)
+	{
+		s->ring[2 * s->idx + 0] = s->ring[2 * (s->idx + s->ncoef) + 0] = in[2 * i + 0];
+		s->ring[2 * s->idx + 1] = s->ring[2 * (s->idx + s->ncoef) + 1] = in[2 * i + 1];
+		if (++s->idx == s->ncoef) s->idx = 0;
+		if (++s->phase == s->decim)
+		{
+			// w[0] is the oldest sample in the window, w[ncoef - 1] the newest
+			s->phase = 0;
+			w = s->ring + 2 * s->idx;
+			I = Q = 0.0;
+			for (k = 0; k < s->ncoef; k += s->step)
+			{
+				I += s->coef[k] * w[2 * k + 0];
+				Q += s->coef[k] * w[2 * k + 1];
+			}
+			if (s->center >= 0)
+			{
+				I += s->coef[s->center] * w[2 * s->center + 0];
+				Q += s->coef[s->center] * w[2 * s->center + 1];
+			}
+			out[2 * m + 0] = I;
+			out[2 * m + 1] = Q;
+			m++;
+		}
+	}
+	return m;
+}
+
+int xzoom (ZOOM a, double** out)
+{
+	// shifts and decimates the 'size' samples in a->in; returns the number of output samples, at *out
+	int i, n;
+	double I, Q, t1, t2;
+	double cos_phase = cos (a->phase);
+	double sin_phase = sin (a->phase);
+	double* x = a->buff[0];
+	for (i = 0; i < a->size; i++)
+	{
+		I = a->in[2 * i + 0];
+		Q = a->in[2 * i + 1];
+		x[2 * i + 0] = I * cos_phase - Q * sin_phase;
+		x[2 * i + 1] = I * sin_phase + Q * cos_phase;
+		t1 = cos_phase;
+		t2 = sin_phase;
+		cos_phase = t1 * a->cos_delta - t2 * a->sin_delta;
+		sin_phase = t1 * a->sin_delta + t2 * a->cos_delta;
+	}
+	a->phase = fmod (a->phase + (double)a->size * a->delta, TWOPI);
+	n = a->size;
+	for (i = 0; i < a->nstages; i++)
+	{
+		n = xzstage (&a->stage[i], n, a->buff[i & 1], a->buff[(i + 1) & 1]);
+		x = a->buff[(i + 1) & 1];
+	}
+	*out = x;
+	return n;
+}
+
+void setFreq_zoom (ZOOM a, double freq)
+{
+	a->freq = freq;
+	calc_zoom_shift (a);
+}
@@ -0,0 +1,90 @@
+/*  zoom.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+
+/********************************************************************************************************
+*																										*
+*										Analyzer Zoom Front End											*
+*																										*
+********************************************************************************************************/
+
+// Optional input stage of a complex analyzer display:  the input is shifted so that 'freq' lands at 0 Hz
+// and is then decimated by 'decim', so a narrow span is resolved by a small fft.  Decimation by more than
+// 8 starts with a 4th-order CIC, evaluated in its non-recursive (FIR) form so that floating-point
+// integrators cannot drift; it decimates down to 8 times the output rate and three half-band stages do the
+// rest.  Decimation by 8 or less uses half-band stages only.  The inner +/-0.375 of the output rate is free
+// of aliasing and the CIC droop there is under 0.13 dB; the outer 12.5% on each side should be clipped.
+
+#ifndef _zoom_h
+#define _zoom_h
+#include "comm.h"
+
+#define ZOOM_MAX_DECIM		1024
+#define ZOOM_MAX_STAGES		4
+#define ZOOM_CIC_ORDER		4
+#define ZOOM_HB_TAPS		63			// half-band length; 4 * k - 1
+
+typedef struct _zstage
+{
+	int decim;						// decimation of this stage
+	int ncoef;						// number of coefficients
+	int step;						// 1, or 2 for a half-band (only every other coefficient is non-zero)
+	int center;						// index of the centre coefficient that 'step' skips; -1 if none
+	double* coef;					// coefficients
+	double* ring;					// complex history, stored twice so that a window is always contiguous
+	int idx;						// next position in 'ring'
+	int phase;						// inputs since the last output
+} zstage;
+
+typedef struct _zoom
+{
+	int size;						// input samples per call
+	int decim;						// total decimation, a power of two
+	double rate;					// input sample rate
+	double freq;					// input frequency that is moved to 0 Hz
+	double phase;
+	double delta;
+	double cos_delta;
+	double sin_delta;
+	int nstages;
+	zstage stage[ZOOM_MAX_STAGES];
+	double* in;						// complex input, 'size' samples
+	double* buff[2];				// complex work buffers between stages
+	dINREAL* Ibuff;					// staging for OpenBuffer()/CloseBuffer()
+	dINREAL* Qbuff;
+} zoom, *ZOOM;
+
+extern ZOOM create_zoom (int size, double rate, double freq, int decim);
+
+extern void destroy_zoom (ZOOM a);
+
+extern void flush_zoom (ZOOM a);
+
+extern int xzoom (ZOOM a, double** out);
+
+extern void setFreq_zoom (ZOOM a, double freq);
+
+#endif